@@ -0,0 +1,312 @@
+/**
+ * @file pa_cell_simu.c
+ *
+ * Cell topology of the simulated modem.
+ *
+ * The serving and neighbouring cells only depend on the grid and on the position of the device:
+ * they are computed when one of them changes, and polling them costs nothing. The attenuation of a
+ * neighbouring cell is the log-distance path loss difference with the serving cell.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_cell_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path loss exponent of an urban environment.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PATH_LOSS_EXPONENT      3.5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shortest distance between the device and a cell in meters: the antennas are above the device.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIN_DISTANCE            50.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of cells per row and per column of a location area.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOCATION_AREA_SIZE      4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default grid.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_GRID_SIZE       5
+#define DEFAULT_SPACING         1000
+#define DEFAULT_FIRST_CELL_ID   0x1000
+#define DEFAULT_FIRST_LAC       0xABCD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grid of cells.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t columns;           ///< Number of columns
+    uint32_t rows;              ///< Number of rows
+    uint32_t spacing;           ///< Distance between two cells in meters
+    uint32_t firstCellId;       ///< Identifier of the first cell
+    uint16_t firstLac;          ///< Code of the first location area
+}
+Grid_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Grid, position of the device and number of rings of neighbouring cells.
+ */
+//--------------------------------------------------------------------------------------------------
+static Grid_t Grid;
+static double PositionX;
+static double PositionY;
+static uint32_t NeighborRings = 1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Serving and neighbouring cells at the current position.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_cellSimu_Cell_t ServingCell;
+static pa_cellSimu_Cell_t Neighbors[PA_CELLSIMU_MAX_NEIGHBORS];
+static uint32_t NeighborCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill a cell of the grid.
+ *
+ * @return The distance between the cell and the device in meters.
+ */
+//--------------------------------------------------------------------------------------------------
+static double FillCell
+(
+    uint32_t            column,     ///< [IN] Column of the cell
+    uint32_t            row,        ///< [IN] Row of the cell
+    pa_cellSimu_Cell_t* cellPtr     ///< [OUT] Cell
+)
+{
+    uint32_t areaColumns = (Grid.columns + LOCATION_AREA_SIZE - 1) / LOCATION_AREA_SIZE;
+    double   dx = PositionX - (double)column * Grid.spacing;
+    double   dy = PositionY - (double)row * Grid.spacing;
+    double   distance = sqrt(dx * dx + dy * dy);
+
+    cellPtr->id = Grid.firstCellId + row * Grid.columns + column;
+    cellPtr->lac = Grid.firstLac + (row / LOCATION_AREA_SIZE) * areaColumns
+                   + column / LOCATION_AREA_SIZE;
+    cellPtr->attenuation = 0;
+
+    return (distance < MIN_DISTANCE) ? MIN_DISTANCE : distance;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare the attenuation of two cells, for sorting.
+ *
+ * @return Negative, null or positive as the first cell is stronger, as strong or weaker.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareAttenuation
+(
+    const void* aPtr,   ///< [IN] First cell
+    const void* bPtr    ///< [IN] Second cell
+)
+{
+    double a = ((const pa_cellSimu_Cell_t*)aPtr)->attenuation;
+    double b = ((const pa_cellSimu_Cell_t*)bPtr)->attenuation;
+
+    return (a > b) - (a < b);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the serving and neighbouring cells at the current position.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateCells
+(
+    void
+)
+{
+    int64_t  servingColumn = llround(PositionX / Grid.spacing);
+    int64_t  servingRow = llround(PositionY / Grid.spacing);
+    int64_t  column;
+    int64_t  row;
+    double   servingDistance;
+
+    // Out of the grid, the closest cell is on its border.
+    servingColumn = (servingColumn < 0) ? 0 : ((servingColumn >= Grid.columns) ?
+                                               Grid.columns - 1 : servingColumn);
+    servingRow = (servingRow < 0) ? 0 : ((servingRow >= Grid.rows) ? Grid.rows - 1 : servingRow);
+    servingDistance = FillCell(servingColumn, servingRow, &ServingCell);
+
+    NeighborCount = 0;
+    for (row = servingRow - NeighborRings; row <= servingRow + (int64_t)NeighborRings; row++)
+    {
+        for (column = servingColumn - NeighborRings;
+             column <= servingColumn + (int64_t)NeighborRings;
+             column++)
+        {
+            pa_cellSimu_Cell_t* cellPtr = &Neighbors[NeighborCount];
+
+            if ((row < 0) || (row >= Grid.rows) || (column < 0) || (column >= Grid.columns)
+                || ((row == servingRow) && (column == servingColumn)))
+            {
+                continue;
+            }
+
+            cellPtr->attenuation = 10 * PATH_LOSS_EXPONENT
+                                   * log10(FillCell(column, row, cellPtr) / servingDistance);
+            NeighborCount++;
+        }
+    }
+
+    qsort(Neighbors, NeighborCount, sizeof(Neighbors[0]), CompareAttenuation);
+
+    LE_DEBUG("Serving cell %"PRIu32", LAC %"PRIu16", %"PRIu32" neighbours",
+             ServingCell.id, ServingCell.lac, NeighborCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_cell simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_cellSimu_Init
+(
+    void
+)
+{
+    LE_ASSERT_OK(pa_cellSimu_SetGrid(DEFAULT_GRID_SIZE, DEFAULT_GRID_SIZE, DEFAULT_SPACING,
+                                     DEFAULT_FIRST_CELL_ID, DEFAULT_FIRST_LAC));
+    pa_cellSimu_SetPosition((DEFAULT_GRID_SIZE / 2) * DEFAULT_SPACING,
+                            (DEFAULT_GRID_SIZE / 2) * DEFAULT_SPACING);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the grid of cells.
+ *
+ * @return LE_BAD_PARAMETER The grid is empty, its spacing is null or the codes overflow.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_cellSimu_SetGrid
+(
+    uint32_t columns,       ///< [IN] Number of columns
+    uint32_t rows,          ///< [IN] Number of rows
+    uint32_t spacing,       ///< [IN] Distance between two cells in meters
+    uint32_t firstCellId,   ///< [IN] Identifier of the first cell
+    uint16_t firstLac       ///< [IN] Code of the first location area
+)
+{
+    uint64_t areaCount = (uint64_t)((columns + LOCATION_AREA_SIZE - 1) / LOCATION_AREA_SIZE)
+                         * ((rows + LOCATION_AREA_SIZE - 1) / LOCATION_AREA_SIZE);
+
+    if ((0 == columns) || (0 == rows) || (0 == spacing)
+        || ((uint64_t)columns * rows - 1 > UINT32_MAX - firstCellId)
+        || (areaCount - 1 > (uint64_t)(UINT16_MAX - firstLac)))
+    {
+        LE_ERROR("Invalid grid of %"PRIu32"x%"PRIu32" cells", columns, rows);
+        return LE_BAD_PARAMETER;
+    }
+
+    Grid.columns = columns;
+    Grid.rows = rows;
+    Grid.spacing = spacing;
+    Grid.firstCellId = firstCellId;
+    Grid.firstLac = firstLac;
+
+    UpdateCells();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the position of the device on the grid.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_cellSimu_SetPosition
+(
+    double x,   ///< [IN] Position along the rows in meters
+    double y    ///< [IN] Position along the columns in meters
+)
+{
+    PositionX = x;
+    PositionY = y;
+
+    UpdateCells();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the number of rings of neighbouring cells around the serving cell.
+ *
+ * @return LE_OUT_OF_RANGE  The number of rings exceeds PA_CELLSIMU_MAX_RINGS.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_cellSimu_SetNeighborRings
+(
+    uint32_t rings  ///< [IN] Number of rings, 0 for no neighbouring cell
+)
+{
+    if (rings > PA_CELLSIMU_MAX_RINGS)
+    {
+        LE_ERROR("%"PRIu32" rings of neighbouring cells, at most %d", rings, PA_CELLSIMU_MAX_RINGS);
+        return LE_OUT_OF_RANGE;
+    }
+
+    NeighborRings = rings;
+
+    UpdateCells();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the serving cell.
+ *
+ * @return The serving cell.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_cellSimu_Cell_t* pa_cellSimu_GetServingCell
+(
+    void
+)
+{
+    return &ServingCell;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the neighbouring cells, from the strongest to the weakest.
+ *
+ * @return The neighbouring cells.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_cellSimu_Cell_t* pa_cellSimu_GetNeighbors
+(
+    uint32_t* countPtr  ///< [OUT] Number of neighbouring cells
+)
+{
+    *countPtr = NeighborCount;
+    return Neighbors;
+}
@@ -0,0 +1,117 @@
+/** @file pa_cell_simu.h
+ *
+ * Legato @ref pa_cell_simu include file.
+ *
+ * Cell topology of the simulated modem: a grid of cells, each one with its identifier and its
+ * location (and tracking) area, around the position of the device. The serving cell is the
+ * closest one, and the neighbouring cells are the rings of cells around it, attenuated by their
+ * distance to the device.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_CELL_SIMU_H_INCLUDE_GUARD
+#define PA_CELL_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of rings of neighbouring cells, and maximum number of neighbouring cells.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_CELLSIMU_MAX_RINGS       3
+#define PA_CELLSIMU_MAX_NEIGHBORS   ((2 * PA_CELLSIMU_MAX_RINGS + 1) * (2 * PA_CELLSIMU_MAX_RINGS + 1) - 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cell of the grid.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t id;            ///< Cell identifier
+    uint16_t lac;           ///< Location and tracking area code
+    double   attenuation;   ///< Attenuation from the serving cell signal in dB
+}
+pa_cellSimu_Cell_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_cell simu, with a grid of 5x5 cells spaced by 1 km, the device being in the
+ * middle of the grid.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_cellSimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the grid of cells. Cells are numbered row by row from the first identifier, and grouped in
+ * location areas of 4x4 cells numbered from the first location area code.
+ *
+ * @return LE_BAD_PARAMETER The grid is empty, its spacing is null or the codes overflow.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_cellSimu_SetGrid
+(
+    uint32_t columns,       ///< [IN] Number of columns
+    uint32_t rows,          ///< [IN] Number of rows
+    uint32_t spacing,       ///< [IN] Distance between two cells in meters
+    uint32_t firstCellId,   ///< [IN] Identifier of the first cell
+    uint16_t firstLac       ///< [IN] Code of the first location area
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the position of the device on the grid, the first cell being at the origin.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_cellSimu_SetPosition
+(
+    double x,   ///< [IN] Position along the rows in meters
+    double y    ///< [IN] Position along the columns in meters
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the number of rings of neighbouring cells around the serving cell: 8 neighbours for one
+ * ring, 24 for two rings, 48 for three rings.
+ *
+ * @return LE_OUT_OF_RANGE  The number of rings exceeds PA_CELLSIMU_MAX_RINGS.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_cellSimu_SetNeighborRings
+(
+    uint32_t rings  ///< [IN] Number of rings, 0 for no neighbouring cell
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the serving cell.
+ *
+ * @return The serving cell.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_cellSimu_Cell_t* pa_cellSimu_GetServingCell
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the neighbouring cells, from the strongest to the weakest.
+ *
+ * @return The neighbouring cells, computed once per position.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_cellSimu_Cell_t* pa_cellSimu_GetNeighbors
+(
+    uint32_t* countPtr  ///< [OUT] Number of neighbouring cells
+);
+
+#endif
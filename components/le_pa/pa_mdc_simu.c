@@ -17,7 +17,6 @@ typedef struct
 {
     uint32_t profileIndex;
     pa_mdc_ProfileData_t profileData;
-    struct MdcSimuProfile_t* nextPtr;
     /* session */
     bool sessionStarted[LE_MDC_PDP_IPV4V6];
     /* gateway */
@@ -29,12 +28,38 @@ typedef struct
     /* dns */
     char dns1AddrStr[LE_MDMDEFS_IPMAX][LE_MDC_IPV6_ADDR_MAX_BYTES];
     char dns2AddrStr[LE_MDMDEFS_IPMAX][LE_MDC_IPV6_ADDR_MAX_BYTES];
+    /* data flow statistics */
+    int rxBytesFd;                              ///< Received bytes counter of the interface
+    int txBytesFd;                              ///< Transmitted bytes counter of the interface
+    pa_mdc_PktStatistics_t interfaceCounters;   ///< Last counters read from the interface
+    pa_mdc_PktStatistics_t statistics;          ///< Traffic of the profile since the last reset
 } MdcSimuProfile_t;
 
-static MdcSimuProfile_t* MdcSimuProfile;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the profile table: a few hundred APNs per device.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PROFILE_TABLE_SIZE  512
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the network interfaces, and refresh period of their traffic counters in
+ * milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef NET_CLASS_PATH
+# define NET_CLASS_PATH "/sys/class/net"
+#endif
+#define DATA_FLOW_STATISTICS_PERIOD  1000
+
+static le_hashmap_Ref_t MdcSimuProfileTable;
 static pa_mdc_SessionStateHandler_t SessionStateHandler;
 static le_mem_PoolRef_t NewSessionStatePool , MdcSimuProfileDataPool;
 static pa_mdc_PktStatistics_t DataStatistics;
+static le_timer_Ref_t DataFlowStatisticsTimer;
+static bool DataFlowStatisticsStarted = true;
+static uint32_t CountedSessionCount;
 
 #define LE_MDMDEFS_IPVERSION_2_LE_MDC_PDP(X) ((X == LE_MDMDEFS_IPV4) ? LE_MDC_PDP_IPV4:\
                                               ((X == LE_MDMDEFS_IPV6) ? LE_MDC_PDP_IPV6:\
@@ -51,14 +76,234 @@ static MdcSimuProfile_t* GetProfile
     uint32_t profileIndex
 )
 {
-    MdcSimuProfile_t *profileTmpPtr = MdcSimuProfile;
+    return le_hashmap_Get(MdcSimuProfileTable, &profileIndex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open a traffic counter of a network interface.
+ *
+ * @return The file descriptor of the counter, -1 on failure.
+ **/
+//--------------------------------------------------------------------------------------------------
+static int OpenCounter
+(
+    const char* interfaceNamePtr,   ///< [IN] Network interface
+    const char* counterPtr          ///< [IN] Counter: rx_bytes or tx_bytes
+)
+{
+    char path[PATH_MAX];
+    int  fd;
+
+    snprintf(path, sizeof(path), NET_CLASS_PATH "/%s/statistics/%s", interfaceNamePtr, counterPtr);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LE_WARN("Unable to open %s: %m", path);
+    }
+    return fd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a traffic counter of a network interface: the counter file is read again from its start.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT on failure
+ **/
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadCounter
+(
+    int       fd,           ///< [IN] File descriptor of the counter
+    uint64_t* valuePtr      ///< [OUT] Counter value
+)
+{
+    char    buffer[24];
+    ssize_t size;
+
+    if (fd < 0)
+    {
+        return LE_FAULT;
+    }
+
+    size = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if (size <= 0)
+    {
+        return LE_FAULT;
+    }
+    buffer[size] = '\0';
+
+    *valuePtr = strtoull(buffer, NULL, 10);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the traffic counters of the interface of a profile, and account the traffic since the last
+ * read if the statistics are collected.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateStatistics
+(
+    MdcSimuProfile_t* profilePtr
+)
+{
+    pa_mdc_PktStatistics_t counters;
+    uint64_t rxBytes;
+    uint64_t txBytes;
+
+    if ((LE_OK != ReadCounter(profilePtr->rxBytesFd, &counters.receivedBytesCount))
+        || (LE_OK != ReadCounter(profilePtr->txBytesFd, &counters.transmittedBytesCount)))
+    {
+        return;
+    }
+
+    // A counter going backwards has been reset with its interface.
+    rxBytes = (counters.receivedBytesCount >= profilePtr->interfaceCounters.receivedBytesCount) ?
+              counters.receivedBytesCount - profilePtr->interfaceCounters.receivedBytesCount :
+              counters.receivedBytesCount;
+    txBytes = (counters.transmittedBytesCount >=
+               profilePtr->interfaceCounters.transmittedBytesCount) ?
+              counters.transmittedBytesCount - profilePtr->interfaceCounters.transmittedBytesCount :
+              counters.transmittedBytesCount;
+    profilePtr->interfaceCounters = counters;
+
+    if (DataFlowStatisticsStarted)
+    {
+        profilePtr->statistics.receivedBytesCount += rxBytes;
+        profilePtr->statistics.transmittedBytesCount += txBytes;
+        DataStatistics.receivedBytesCount += rxBytes;
+        DataStatistics.transmittedBytesCount += txBytes;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the traffic counters of all the sessions.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateAllStatistics
+(
+    void
+)
+{
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(MdcSimuProfileTable);
+
+    while (LE_OK == le_hashmap_NextNode(iter))
+    {
+        MdcSimuProfile_t* profilePtr = (MdcSimuProfile_t*)le_hashmap_GetValue(iter);
+
+        if (profilePtr->rxBytesFd >= 0)
+        {
+            UpdateStatistics(profilePtr);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Refresh the traffic counters periodically while they are collected and a session is counted.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateStatisticsTimer
+(
+    void
+)
+{
+    bool needed = DataFlowStatisticsStarted && (CountedSessionCount > 0);
+
+    if (needed && !le_timer_IsRunning(DataFlowStatisticsTimer))
+    {
+        le_timer_Start(DataFlowStatisticsTimer);
+    }
+    else if (!needed && le_timer_IsRunning(DataFlowStatisticsTimer))
+    {
+        le_timer_Stop(DataFlowStatisticsTimer);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data flow statistics timer handler: refresh the traffic counters of all the sessions.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void DataFlowStatisticsTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    UpdateAllStatistics();
+}
 
-    while ( profileTmpPtr && (profileTmpPtr->profileIndex != profileIndex) )
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start counting the traffic of the interface of a profile: the traffic before the session is not
+ * counted.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void OpenStatistics
+(
+    MdcSimuProfile_t* profilePtr
+)
+{
+    if ((profilePtr->rxBytesFd >= 0) || ('\0' == profilePtr->interfaceName[0]))
     {
-        profileTmpPtr = (MdcSimuProfile_t*) profileTmpPtr->nextPtr;
+        return;
     }
 
-    return profileTmpPtr;
+    profilePtr->rxBytesFd = OpenCounter(profilePtr->interfaceName, "rx_bytes");
+    profilePtr->txBytesFd = OpenCounter(profilePtr->interfaceName, "tx_bytes");
+    if ((profilePtr->rxBytesFd < 0) || (profilePtr->txBytesFd < 0)
+        || (LE_OK != ReadCounter(profilePtr->rxBytesFd,
+                                 &profilePtr->interfaceCounters.receivedBytesCount))
+        || (LE_OK != ReadCounter(profilePtr->txBytesFd,
+                                 &profilePtr->interfaceCounters.transmittedBytesCount)))
+    {
+        if (profilePtr->rxBytesFd >= 0)
+        {
+            close(profilePtr->rxBytesFd);
+        }
+        if (profilePtr->txBytesFd >= 0)
+        {
+            close(profilePtr->txBytesFd);
+        }
+        profilePtr->rxBytesFd = profilePtr->txBytesFd = -1;
+        return;
+    }
+
+    CountedSessionCount++;
+    UpdateStatisticsTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop counting the traffic of the interface of a profile, once its last traffic is counted.
+ *
+ **/
+//--------------------------------------------------------------------------------------------------
+static void CloseStatistics
+(
+    MdcSimuProfile_t* profilePtr
+)
+{
+    if (profilePtr->rxBytesFd < 0)
+    {
+        return;
+    }
+
+    UpdateStatistics(profilePtr);
+    close(profilePtr->rxBytesFd);
+    close(profilePtr->txBytesFd);
+    profilePtr->rxBytesFd = profilePtr->txBytesFd = -1;
+
+    CountedSessionCount--;
+    UpdateStatisticsTimer();
 }
 
 
@@ -102,6 +347,8 @@ static le_result_t StartSession
         break;
     }
 
+    OpenStatistics(profileTmpPtr);
+
     /* send the handler */
     if (SessionStateHandler)
     {
@@ -292,14 +539,7 @@ le_result_t pa_mdc_InitializeProfile
     uint32_t   profileIndex     ///< [IN] The profile to write
 )
 {
-    MdcSimuProfile_t *profileTmpPtr = MdcSimuProfile;
-
-    while ( profileTmpPtr && (profileTmpPtr->profileIndex != profileIndex) )
-    {
-        profileTmpPtr = (MdcSimuProfile_t*) profileTmpPtr->nextPtr;
-    }
-
-    if (profileTmpPtr && (profileTmpPtr->profileIndex == profileIndex))
+    if (GetProfile(profileIndex))
     {
         return LE_OK;
     }
@@ -405,14 +645,7 @@ void pa_mdcSimu_SetProfile
     const pa_mdc_ProfileData_t* profileDataPtr    ///< [OUT] The profile data
 )
 {
-    MdcSimuProfile_t *profileTmpPtr = MdcSimuProfile, *profilePrevPtr = NULL;
-
-    /* Looking for profileIndex in the MdcSimuProfile chain */
-    while ( profileTmpPtr && (profileTmpPtr->profileIndex != profileIndex) )
-    {
-        profilePrevPtr = profileTmpPtr;
-        profileTmpPtr = (MdcSimuProfile_t *) profileTmpPtr->nextPtr;
-    }
+    MdcSimuProfile_t *profileTmpPtr = GetProfile(profileIndex);
 
     if (!profileTmpPtr)
     {
@@ -421,15 +654,9 @@ void pa_mdcSimu_SetProfile
         memset(profilePtr,0,sizeof(MdcSimuProfile_t));
         profilePtr->profileIndex = profileIndex;
         profilePtr->profileData = *profileDataPtr;
+        profilePtr->rxBytesFd = profilePtr->txBytesFd = -1;
 
-        if (profilePrevPtr)
-        {
-            profilePrevPtr->nextPtr = (struct MdcSimuProfile_t *) profilePtr;
-        }
-        else
-        {
-            MdcSimuProfile = profilePtr;
-        }
+        le_hashmap_Put(MdcSimuProfileTable, &profilePtr->profileIndex, profilePtr);
     }
     else
     {
@@ -449,17 +676,17 @@ void pa_mdcSimu_DeleteProfiles
     void
 )
 {
-    MdcSimuProfile_t *profileTmpPtr = MdcSimuProfile, *profilePrevPtr = NULL;
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(MdcSimuProfileTable);
 
-    while ( profileTmpPtr )
+    while (LE_OK == le_hashmap_NextNode(iter))
     {
-        profilePrevPtr = profileTmpPtr;
-        profileTmpPtr = (MdcSimuProfile_t *) profileTmpPtr->nextPtr;
+        MdcSimuProfile_t* profilePtr = (MdcSimuProfile_t*)le_hashmap_GetValue(iter);
 
-        free(profilePrevPtr);
+        CloseStatistics(profilePtr);
+        le_mem_Release(profilePtr);
     }
 
-    MdcSimuProfile = NULL;
+    le_hashmap_RemoveAll(MdcSimuProfileTable);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -477,12 +704,7 @@ le_result_t pa_mdc_ReadProfile
     pa_mdc_ProfileData_t* profileDataPtr    ///< [OUT] The profile data
 )
 {
-    MdcSimuProfile_t *profileTmpPtr = MdcSimuProfile;
-
-    while ( profileTmpPtr && (profileTmpPtr->profileIndex != profileIndex) )
-    {
-        profileTmpPtr = (MdcSimuProfile_t *) profileTmpPtr->nextPtr;
-    }
+    MdcSimuProfile_t *profileTmpPtr = GetProfile(profileIndex);
 
     if ( profileTmpPtr )
     {
@@ -689,7 +911,7 @@ le_result_t pa_mdc_StartSessionIPV4V6
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set data flow statistics.
+ * Set data flow statistics: the traffic of the sessions is counted from these values.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -703,7 +925,8 @@ void pa_mdcSimu_SetDataFlowStatistics
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get data flow statistics since the last reset.
+ * Get data flow statistics since the last reset: the traffic of the interfaces of the sessions,
+ * read every DATA_FLOW_STATISTICS_PERIOD milliseconds and when a session stops.
  *
  * @return
  *      - LE_OK on success
@@ -735,6 +958,17 @@ le_result_t pa_mdc_ResetDataFlowStatistics
     void
 )
 {
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(MdcSimuProfileTable);
+
+    // Count from the current values of the interfaces.
+    UpdateAllStatistics();
+    while (LE_OK == le_hashmap_NextNode(iter))
+    {
+        MdcSimuProfile_t* profilePtr = (MdcSimuProfile_t*)le_hashmap_GetValue(iter);
+
+        memset(&profilePtr->statistics, 0, sizeof(pa_mdc_PktStatistics_t));
+    }
+
     memset(&DataStatistics, 0, sizeof(pa_mdc_PktStatistics_t));
     return LE_OK;
 }
@@ -753,6 +987,12 @@ le_result_t pa_mdc_StopDataFlowStatistics
     void
 )
 {
+    if (DataFlowStatisticsStarted)
+    {
+        UpdateAllStatistics();
+        DataFlowStatisticsStarted = false;
+        UpdateStatisticsTimer();
+    }
     return LE_OK;
 }
 
@@ -770,6 +1010,39 @@ le_result_t pa_mdc_StartDataFlowStatistics
     void
 )
 {
+    if (!DataFlowStatisticsStarted)
+    {
+        // The traffic while the collection was stopped is not counted.
+        UpdateAllStatistics();
+        DataFlowStatisticsStarted = true;
+        UpdateStatisticsTimer();
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data flow statistics of a profile since the last reset.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the profile doesn't exist
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mdcSimu_GetProfileDataFlowStatistics
+(
+    uint32_t profileIndex,                      ///< [IN] The profile to use
+    pa_mdc_PktStatistics_t *dataStatisticsPtr   ///< [OUT] Statistics data
+)
+{
+    MdcSimuProfile_t *profilePtr = GetProfile(profileIndex);
+
+    if (!profilePtr)
+    {
+        return LE_FAULT;
+    }
+
+    *dataStatisticsPtr = profilePtr->statistics;
     return LE_OK;
 }
 
@@ -798,6 +1071,7 @@ le_result_t pa_mdc_StopSession
     {
         profilePtr->sessionStarted[LE_MDC_PDP_IPV4] = profilePtr->sessionStarted[LE_MDC_PDP_IPV6]
                                                                                             = false;
+        CloseStatistics(profilePtr);
 
         /* send the handler */
         if (SessionStateHandler)
@@ -983,6 +1257,13 @@ le_result_t pa_mdcSimu_Init
 {
     NewSessionStatePool = le_mem_CreatePool("NewSessionStatePool", sizeof(pa_mdc_SessionStateData_t));
     MdcSimuProfileDataPool = le_mem_CreatePool("MdcSimuProfileDataPool", sizeof(MdcSimuProfile_t));
+    MdcSimuProfileTable = le_hashmap_Create("MdcSimuProfileTable", PROFILE_TABLE_SIZE,
+                                            le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+
+    DataFlowStatisticsTimer = le_timer_Create("DataFlowStatisticsTimer");
+    le_timer_SetMsInterval(DataFlowStatisticsTimer, DATA_FLOW_STATISTICS_PERIOD);
+    le_timer_SetRepeat(DataFlowStatisticsTimer, 0);
+    le_timer_SetHandler(DataFlowStatisticsTimer, DataFlowStatisticsTimerHandler);
 
     ProvideDefaultProfile();
 
@@ -101,7 +101,7 @@ void pa_mdcSimu_DeleteProfiles
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set data flow statistics.
+ * Set data flow statistics: the traffic of the sessions is counted from these values.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -110,6 +110,21 @@ void pa_mdcSimu_SetDataFlowStatistics
     const pa_mdc_PktStatistics_t *dataStatisticsPtr ///< [OUT] Statistics data
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the data flow statistics of a profile since the last reset.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_FAULT if the profile doesn't exist
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mdcSimu_GetProfileDataFlowStatistics
+(
+    uint32_t profileIndex,                      ///< [IN] The profile to use
+    pa_mdc_PktStatistics_t *dataStatisticsPtr   ///< [OUT] Statistics data
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * simu init
@@ -7,9 +7,13 @@
  */
 
 #include "legato.h"
+#include "interfaces.h"
 #include "pa_simu.h"
 #include "pa_mrc_simu.h"
 #include "pa_sim_simu.h"
+#include "pa_radio_simu.h"
+#include "pa_cell_simu.h"
+#include "pa_reg_simu.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -18,6 +22,202 @@
 //--------------------------------------------------------------------------------------------------
 #define MIN_SIGNAL_DELTA_FOR_TDSCDMA  10
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hysteresis of the signal strength thresholds, in 0.1 dB: a signal fading around a threshold
+ * doesn't report an indication on each sample.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SIGNAL_THRESHOLD_HYSTERESIS   10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of RATs, LE_MRC_RAT_UNKNOWN included.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RAT_COUNT                     (LE_MRC_RAT_CDMA + 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bands of the le_mrc_BandBitMask_t bit mask used by each RAT: the CDMA band classes are its lowest
+ * bits, the GSM bands follow, and the WCDMA bands are the others.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CDMA_BANDS                    ((LE_MRC_BITMASK_BAND_CLASS_19 << 1) - 1)
+#define GSM_BANDS                     (LE_MRC_BITMASK_BAND_GSM_450 | LE_MRC_BITMASK_BAND_GSM_480 | \
+                                       LE_MRC_BITMASK_BAND_GSM_750 | LE_MRC_BITMASK_BAND_GSM_850 | \
+                                       LE_MRC_BITMASK_BAND_EGSM_900 |                             \
+                                       LE_MRC_BITMASK_BAND_PRI_GSM_900 |                          \
+                                       LE_MRC_BITMASK_BAND_RAILWAYS_GSM_900 |                     \
+                                       LE_MRC_BITMASK_BAND_GSM_DCS_1800 |                         \
+                                       LE_MRC_BITMASK_BAND_GSM_PCS_1900)
+#define WCDMA_BANDS                   (~(le_mrc_BandBitMask_t)(CDMA_BANDS | GSM_BANDS))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Band capabilities of the simulated modem.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BAND_CAPABILITIES             (LE_MRC_BITMASK_BAND_CLASS_1_ALL_BLOCKS |                  \
+                                       LE_MRC_BITMASK_BAND_EGSM_900 |                             \
+                                       LE_MRC_BITMASK_BAND_GSM_DCS_1800 |                         \
+                                       LE_MRC_BITMASK_BAND_WCDMA_EU_J_CH_IMT_2100 |               \
+                                       LE_MRC_BITMASK_BAND_WCDMA_EU_J_900)
+#define LTE_BAND_CAPABILITIES         (LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_1 |                \
+                                       LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_3 |                 \
+                                       LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_7 |                 \
+                                       LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_8 |                 \
+                                       LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_20)
+#define TDSCDMA_BAND_CAPABILITIES     (LE_MRC_BITMASK_TDSCDMA_BAND_A | LE_MRC_BITMASK_TDSCDMA_BAND_C)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * All the RATs.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALL_RATS                      (LE_MRC_BITMASK_RAT_GSM | LE_MRC_BITMASK_RAT_UMTS |         \
+                                       LE_MRC_BITMASK_RAT_TDSCDMA | LE_MRC_BITMASK_RAT_LTE |      \
+                                       LE_MRC_BITMASK_RAT_CDMA)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of scan information nodes and networks preallocated in the pools, and maximum number of
+ * forbidden networks read from the SIM.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SCAN_INFORMATION_POOL_SIZE    16
+#define PLMN_POOL_SIZE                8
+#define FPLMN_MAX_COUNT               16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of preferred operators preallocated in the pool, and size of their hash map.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PREFERRED_OPERATOR_POOL_SIZE  32
+#define PREFERRED_OPERATOR_MAP_SIZE   256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Config tree node of the MRC, node of the preferred operator list in it, and length of the paths
+ * of the list entries.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MRC_CFG_PATH                  PA_SIMU_CFG_MODEM_ROOT "/mrc"
+#define PREFERRED_OPERATORS_CFG_NODE  "preferredOperators"
+#define PREFERRED_OPERATOR_PATH_BYTES 48
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * RATs scanned, in scan order.
+ */
+//--------------------------------------------------------------------------------------------------
+static const struct
+{
+    le_mrc_Rat_t        rat;
+    le_mrc_RatBitMask_t ratMask;
+}
+ScannedRats[] =
+{
+    { LE_MRC_RAT_GSM,     LE_MRC_BITMASK_RAT_GSM },
+    { LE_MRC_RAT_UMTS,    LE_MRC_BITMASK_RAT_UMTS },
+    { LE_MRC_RAT_TDSCDMA, LE_MRC_BITMASK_RAT_TDSCDMA },
+    { LE_MRC_RAT_LTE,     LE_MRC_BITMASK_RAT_LTE },
+    { LE_MRC_RAT_CDMA,    LE_MRC_BITMASK_RAT_CDMA },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bit mask of each RAT, and its bands in le_mrc_BandBitMask_t. LTE and TD-SCDMA have their own
+ * band bit masks.
+ */
+//--------------------------------------------------------------------------------------------------
+static const struct
+{
+    le_mrc_RatBitMask_t  ratMask;
+    le_mrc_BandBitMask_t bands;
+}
+RatBands[RAT_COUNT] =
+{
+    [LE_MRC_RAT_GSM]     = { LE_MRC_BITMASK_RAT_GSM,     GSM_BANDS },
+    [LE_MRC_RAT_UMTS]    = { LE_MRC_BITMASK_RAT_UMTS,    WCDMA_BANDS },
+    [LE_MRC_RAT_TDSCDMA] = { LE_MRC_BITMASK_RAT_TDSCDMA, 0 },
+    [LE_MRC_RAT_LTE]     = { LE_MRC_BITMASK_RAT_LTE,     0 },
+    [LE_MRC_RAT_CDMA]    = { LE_MRC_BITMASK_RAT_CDMA,    CDMA_BANDS },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network of the simulated PLMN table.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;                               ///< Link in the PLMN table
+    char                mcc[LE_MRC_MCC_BYTES];              ///< Mobile Country Code
+    char                mnc[LE_MRC_MNC_BYTES];              ///< Mobile Network Code
+    char                name[PA_MRCSIMU_NETWORK_NAME_BYTES];///< Operator name
+    le_mrc_RatBitMask_t ratMask;                            ///< RATs provided by the network
+}
+Plmn_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Preferred operator.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;                               ///< Link in the preferred operator list
+    char                key[LE_MRC_MCC_BYTES + LE_MRC_MNC_BYTES]; ///< MCC and MNC, hash map key
+    char                mcc[LE_MRC_MCC_BYTES];              ///< Mobile Country Code
+    char                mnc[LE_MRC_MNC_BYTES];              ///< Mobile Network Code
+    le_mrc_RatBitMask_t ratMask;                            ///< Preferred RATs
+    uint32_t            priority;                           ///< Position in the list, 0 first
+}
+PreferredOperator_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous network scan.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_mrc_RatBitMask_t          ratMask;           ///< RATs to scan
+    size_t                       ratIndex;          ///< Index of the RAT being scanned
+    le_dls_List_t                resultList;        ///< List of pa_mrc_ScanInformation_t
+    pa_mrcSimu_ScanHandlerFunc_t handlerPtr;        ///< Completion handler, NULL if no
+                                                    ///< asynchronous scan
+    void*                        contextPtr;        ///< Context of the handler
+}
+AsyncScan_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength indication settings and state of a RAT.
+ *
+ * The settings are folded into a window of signal strengths, out of which an indication is
+ * reported: the thresholds window around the current range, with hysteresis, intersected with the
+ * delta window around the last reported signal strength. Evaluating a sample costs two
+ * comparisons, the window being only computed again after an indication.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     thresholdsSet;     ///< Thresholds set
+    int32_t  lowerThreshold;    ///< Lower-range threshold in 0.1 dBm
+    int32_t  upperThreshold;    ///< Upper-range threshold in 0.1 dBm
+    uint16_t delta;             ///< Delta in 0.1 dB, 0 if not set
+    bool     primed;            ///< The window is computed from a sample
+    int8_t   range;             ///< Range of the last reported signal: -1 below the lower-range
+                                ///< threshold, 1 above the upper-range one, 0 in between
+    int32_t  reportedSs;        ///< Last reported signal strength in 0.1 dBm
+    int32_t  minSs;             ///< Lowest signal strength of the window in 0.1 dBm
+    int32_t  maxSs;             ///< Highest signal strength of the window in 0.1 dBm
+}
+SignalIndState_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The internal current RAT setting
@@ -27,134 +227,1312 @@ static le_mrc_Rat_t   Rat = LE_MRC_RAT_GSM;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The internal current BAND settings
+ * The internal current BAND settings
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mrc_BandBitMask_t CurrentBand = BAND_CAPABILITIES;
+static le_mrc_LteBandBitMask_t CurrentLteBand = LTE_BAND_CAPABILITIES;
+static le_mrc_TdScdmaBandBitMask_t CurrentTdScdmaBand = TDSCDMA_BAND_CAPABILITIES;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The internal current RAT preferences
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mrc_RatBitMask_t RatPreferences = ALL_RATS;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bands of each RAT deployed by the simulated networks, in the band bit mask of the RAT. All the
+ * bands by default.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t NetworkBands[RAT_COUNT] =
+{
+    [LE_MRC_RAT_GSM]     = UINT64_MAX,
+    [LE_MRC_RAT_UMTS]    = UINT64_MAX,
+    [LE_MRC_RAT_TDSCDMA] = UINT64_MAX,
+    [LE_MRC_RAT_LTE]     = UINT64_MAX,
+    [LE_MRC_RAT_CDMA]    = UINT64_MAX,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * RATs allowed by the RAT preferences, and having a network band allowed by the band preferences
+ * and capabilities. Computed on each setting change, so that checking a RAT is a single test.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mrc_RatBitMask_t AllowedRats = ALL_RATS;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event is reported when a Radio Access Technology change indication is received from the
+ * modem. The report data is allocated from the associated pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t RatChangeEvent;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event is reported when a registration state indication is received from the modem. The
+ * report data is allocated from the associated pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t NewRegStateEvent;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event is reported when a Packet Switched change indication is received from the
+ * modem. The report data is allocated from the associated pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t PSChangeEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for Packet Switched change indication reporting.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PSChangePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pools for registration state and Radio Access Technology change indication reporting.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t RegStatePool;
+static le_mem_PoolRef_t RatChangePool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event is reported when a network reject indication is received from the modem. The report
+ * data is allocated from the associated pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t NetworkRejectIndEventId;
+static le_mem_PoolRef_t NetworkRejectIndPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Circuit and packet switched registration states, packet switched attachment and coverage of the
+ * serving cell.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mrc_NetRegState_t RegState = LE_MRC_REG_HOME;
+static le_mrc_NetRegState_t PSState = LE_MRC_REG_HOME;
+static bool IsPSAttached = true;
+static bool InCoverage = true;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registration timer, and time between the network finding and the registration in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t RegistrationTimerRef;
+static uint32_t RegistrationDelay;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The pa_mrc_ScanInformation_t pool
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ScanInformationPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The pa_mrc_CellInfo_t pool, holding enough cells for the largest neighbouring cell list.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t CellInfoPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Networks of the simulated PLMN table, and their pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t PlmnList = LE_DLS_LIST_INIT;
+static le_mem_PoolRef_t PlmnPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Preferred operators in priority order, their hash map keyed by MCC and MNC, and their pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t PreferredOperatorList = LE_DLS_LIST_INIT;
+static le_hashmap_Ref_t PreferredOperatorMap;
+static le_mem_PoolRef_t PreferredOperatorPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network of the last registration.
+ */
+//--------------------------------------------------------------------------------------------------
+static char RegisteredMcc[LE_MRC_MCC_BYTES] = PA_SIMU_SIM_DEFAULT_MCC;
+static char RegisteredMnc[LE_MRC_MNC_BYTES] = PA_SIMU_SIM_DEFAULT_MNC;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan duration of each RAT in milliseconds, indexed like ScannedRats.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ScanDurations[NUM_ARRAY_MEMBERS(ScannedRats)];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous network scan in progress, and the timer of its RAT scans.
+ */
+//--------------------------------------------------------------------------------------------------
+static AsyncScan_t AsyncScan;
+static le_timer_Ref_t ScanTimerRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This event is reported when the signal strength leaves the window of the signal strength
+ * indication settings of the RAT in use. The report data is allocated from the associated pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_event_Id_t SignalStrengthIndEventId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for signal strength indication reporting.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SignalStrengthIndPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength indication settings and state, indexed by RAT.
+ */
+//--------------------------------------------------------------------------------------------------
+static SignalIndState_t SignalIndStates[RAT_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength indication statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_mrcSimu_SignalIndStats_t SignalIndStats;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The internal radio power state
+ */
+//--------------------------------------------------------------------------------------------------
+static le_onoff_t RadioPower = LE_ON;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The internal manual section mode status
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsManual = false;
+
+
+static char CurentMccStr[4];
+static char CurentMncStr[4];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the window of the signal strength indication settings of a RAT around a signal strength.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetSignalIndWindow
+(
+    SignalIndState_t* statePtr,     ///< [IN/OUT] Signal strength indication state
+    int32_t           ss            ///< [IN] Signal strength in 0.1 dBm
+)
+{
+    statePtr->primed = true;
+    statePtr->reportedSs = ss;
+    statePtr->minSs = INT32_MIN;
+    statePtr->maxSs = INT32_MAX;
+
+    if (statePtr->thresholdsSet)
+    {
+        if (ss < statePtr->lowerThreshold)
+        {
+            statePtr->range = -1;
+            statePtr->maxSs = statePtr->lowerThreshold + SIGNAL_THRESHOLD_HYSTERESIS - 1;
+        }
+        else if (ss > statePtr->upperThreshold)
+        {
+            statePtr->range = 1;
+            statePtr->minSs = statePtr->upperThreshold - SIGNAL_THRESHOLD_HYSTERESIS + 1;
+        }
+        else
+        {
+            statePtr->range = 0;
+            statePtr->minSs = statePtr->lowerThreshold - SIGNAL_THRESHOLD_HYSTERESIS;
+            statePtr->maxSs = statePtr->upperThreshold + SIGNAL_THRESHOLD_HYSTERESIS;
+        }
+    }
+
+    if (statePtr->delta)
+    {
+        if (ss - statePtr->delta + 1 > statePtr->minSs)
+        {
+            statePtr->minSs = ss - statePtr->delta + 1;
+        }
+        if (ss + statePtr->delta - 1 < statePtr->maxSs)
+        {
+            statePtr->maxSs = ss + statePtr->delta - 1;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Evaluate a radio environment sample against the signal strength indication settings of its RAT,
+ * and report an indication if the signal left their window.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void EvaluateSignalInd
+(
+    const pa_radioSimu_Sample_t* samplePtr  ///< [IN] Sample
+)
+{
+    SignalIndState_t*                  statePtr;
+    pa_mrc_SignalStrengthIndication_t* indPtr;
+    int32_t                            ss = samplePtr->rssi * 10;
+
+    if ((uint32_t)samplePtr->rat >= RAT_COUNT)
+    {
+        return;
+    }
+    statePtr = &SignalIndStates[samplePtr->rat];
+
+    SignalIndStats.sampleCount++;
+    if (!statePtr->primed)
+    {
+        SetSignalIndWindow(statePtr, ss);
+        return;
+    }
+    if ((ss >= statePtr->minSs) && (ss <= statePtr->maxSs))
+    {
+        return;
+    }
+
+    SetSignalIndWindow(statePtr, ss);
+    SignalIndStats.indicationCount++;
+
+    indPtr = le_mem_ForceAlloc(SignalStrengthIndPool);
+    indPtr->rat = samplePtr->rat;
+    indPtr->ss = samplePtr->rssi;
+    indPtr->rsrq = (LE_MRC_RAT_LTE == samplePtr->rat) ? samplePtr->metrics.lte.rsrq / 10 : 0;
+
+    LE_DEBUG("Signal strength indication: RAT %d, %"PRId32" dBm", indPtr->rat, indPtr->ss);
+    le_event_ReportWithRefCounting(SignalStrengthIndEventId, indPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the home network of the SIM, or the default one if the SIM can't give it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetHomeNetwork
+(
+    char* mccPtr,   ///< [OUT] MCC, LE_MRC_MCC_BYTES long
+    char* mncPtr    ///< [OUT] MNC, LE_MRC_MNC_BYTES long
+)
+{
+    if (LE_OK != pa_sim_GetHomeNetworkMccMnc(mccPtr, LE_MRC_MCC_BYTES, mncPtr, LE_MRC_MNC_BYTES))
+    {
+        le_utf8_Copy(mccPtr, PA_SIMU_SIM_DEFAULT_MCC, LE_MRC_MCC_BYTES, NULL);
+        le_utf8_Copy(mncPtr, PA_SIMU_SIM_DEFAULT_MNC, LE_MRC_MNC_BYTES, NULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the forbidden networks of the SIM.
+ *
+ * @return The number of forbidden networks, 0 if the SIM can't give them.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ReadForbiddenNetworks
+(
+    pa_sim_FPLMNOperator_t* fplmnPtr    ///< [OUT] Forbidden networks, FPLMN_MAX_COUNT long
+)
+{
+    uint32_t fplmnCount = FPLMN_MAX_COUNT;
+
+    if (LE_OK != pa_sim_ReadFPLMNOperators(fplmnPtr, &fplmnCount))
+    {
+        return 0;
+    }
+    return fplmnCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a network is forbidden.
+ *
+ * @return true if the network is in the forbidden networks.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsForbiddenNetwork
+(
+    const pa_sim_FPLMNOperator_t* fplmnPtr,     ///< [IN] Forbidden networks
+    uint32_t                      fplmnCount,   ///< [IN] Number of forbidden networks
+    const char*                   mccPtr,       ///< [IN] MCC
+    const char*                   mncPtr        ///< [IN] MNC
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < fplmnCount; i++)
+    {
+        if ((0 == strcmp(fplmnPtr[i].mobileCode.mcc, mccPtr))
+            && (0 == strcmp(fplmnPtr[i].mobileCode.mnc, mncPtr)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a preferred operator.
+ *
+ * @return The preferred operator, NULL if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static PreferredOperator_t* FindPreferredOperator
+(
+    const char* mccPtr,     ///< [IN] MCC
+    const char* mncPtr      ///< [IN] MNC
+)
+{
+    char key[LE_MRC_MCC_BYTES + LE_MRC_MNC_BYTES];
+
+    snprintf(key, sizeof(key), "%s%s", mccPtr, mncPtr);
+    return le_hashmap_Get(PreferredOperatorMap, key);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append an operator to the preferred operator list, or add RATs to it if it is already in.
+ *
+ * @return LE_BAD_PARAMETER Invalid MCC or MNC.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddPreferredOperator
+(
+    const char*         mccPtr,     ///< [IN] MCC
+    const char*         mncPtr,     ///< [IN] MNC
+    le_mrc_RatBitMask_t ratMask     ///< [IN] Preferred RATs
+)
+{
+    PreferredOperator_t* operatorPtr;
+
+    if ((LE_MRC_MCC_LEN != strlen(mccPtr)) || (strlen(mncPtr) < 2)
+        || (strlen(mncPtr) > LE_MRC_MNC_LEN)
+        || (strspn(mccPtr, "0123456789") != strlen(mccPtr))
+        || (strspn(mncPtr, "0123456789") != strlen(mncPtr)))
+    {
+        LE_ERROR("Invalid operator %s/%s", mccPtr, mncPtr);
+        return LE_BAD_PARAMETER;
+    }
+
+    operatorPtr = FindPreferredOperator(mccPtr, mncPtr);
+    if (operatorPtr)
+    {
+        operatorPtr->ratMask |= ratMask;
+        return LE_OK;
+    }
+
+    operatorPtr = le_mem_ForceAlloc(PreferredOperatorPool);
+    operatorPtr->link = LE_DLS_LINK_INIT;
+    le_utf8_Copy(operatorPtr->mcc, mccPtr, sizeof(operatorPtr->mcc), NULL);
+    le_utf8_Copy(operatorPtr->mnc, mncPtr, sizeof(operatorPtr->mnc), NULL);
+    snprintf(operatorPtr->key, sizeof(operatorPtr->key), "%s%s", mccPtr, mncPtr);
+    operatorPtr->ratMask = ratMask;
+    operatorPtr->priority = le_hashmap_Size(PreferredOperatorMap);
+
+    le_dls_Queue(&PreferredOperatorList, &operatorPtr->link);
+    le_hashmap_Put(PreferredOperatorMap, operatorPtr->key, operatorPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empty the preferred operator list.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearPreferredOperators
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    le_hashmap_RemoveAll(PreferredOperatorMap);
+    while (NULL != (linkPtr = le_dls_Pop(&PreferredOperatorList)))
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, PreferredOperator_t, link));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the preferred operator list from the config tree: one node per operator, named after its
+ * position in the list, with the "mcc", "mnc" and "ratMask" entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadPreferredOperators
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t iteratorRef = le_cfg_CreateReadTxn(MRC_CFG_PATH);
+    char                 path[PREFERRED_OPERATOR_PATH_BYTES];
+    char                 mcc[LE_MRC_MCC_BYTES];
+    char                 mnc[LE_MRC_MNC_BYTES];
+    uint32_t             i;
+
+    for (i = 0; ; i++)
+    {
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32, i);
+        if (!le_cfg_NodeExists(iteratorRef, path))
+        {
+            break;
+        }
+
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32"/mcc", i);
+        le_cfg_GetString(iteratorRef, path, mcc, sizeof(mcc), "");
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32"/mnc", i);
+        le_cfg_GetString(iteratorRef, path, mnc, sizeof(mnc), "");
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32"/ratMask", i);
+        if (LE_OK != AddPreferredOperator(mcc, mnc, le_cfg_GetInt(iteratorRef, path, 0)))
+        {
+            LE_WARN("Invalid preferred operator %"PRIu32" in the config tree", i);
+        }
+    }
+
+    le_cfg_CancelTxn(iteratorRef);
+    LE_INFO("%zu preferred operators loaded", le_hashmap_Size(PreferredOperatorMap));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store the preferred operator list in the config tree, replacing the previous one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StorePreferredOperators
+(
+    void
+)
+{
+    le_cfg_IteratorRef_t iteratorRef = le_cfg_CreateWriteTxn(MRC_CFG_PATH);
+    char                 path[PREFERRED_OPERATOR_PATH_BYTES];
+    le_dls_Link_t*       linkPtr;
+    uint32_t             i = 0;
+
+    le_cfg_DeleteNode(iteratorRef, PREFERRED_OPERATORS_CFG_NODE);
+    for (linkPtr = le_dls_Peek(&PreferredOperatorList);
+         linkPtr;
+         linkPtr = le_dls_PeekNext(&PreferredOperatorList, linkPtr))
+    {
+        PreferredOperator_t* operatorPtr = CONTAINER_OF(linkPtr, PreferredOperator_t, link);
+
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32"/mcc", i);
+        le_cfg_SetString(iteratorRef, path, operatorPtr->mcc);
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32"/mnc", i);
+        le_cfg_SetString(iteratorRef, path, operatorPtr->mnc);
+        snprintf(path, sizeof(path), PREFERRED_OPERATORS_CFG_NODE "/%"PRIu32"/ratMask", i);
+        le_cfg_SetInt(iteratorRef, path, operatorPtr->ratMask);
+        i++;
+    }
+
+    le_cfg_CommitTxn(iteratorRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Select a network in automatic mode among the networks providing the RAT in use: the home network,
+ * else the first preferred operator for this RAT, else any network which is not forbidden. Without
+ * such a network, the home network is kept.
+ *
+ * @return false if the home network is kept.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SelectAutomaticNetwork
+(
+    bool  isHomeExcluded,   ///< [IN] Select a visited network
+    char* mccPtr,           ///< [OUT] MCC, LE_MRC_MCC_BYTES long
+    char* mncPtr            ///< [OUT] MNC, LE_MRC_MNC_BYTES long
+)
+{
+    pa_sim_FPLMNOperator_t fplmn[FPLMN_MAX_COUNT];
+    uint32_t               fplmnCount;
+    le_mrc_RatBitMask_t    ratMask = ((uint32_t)Rat < RAT_COUNT) ? RatBands[Rat].ratMask : 0;
+    const Plmn_t*          selectedPtr = NULL;
+    uint32_t               selectedPriority = UINT32_MAX;
+    le_dls_Link_t*         linkPtr;
+
+    GetHomeNetwork(mccPtr, mncPtr);
+    fplmnCount = ReadForbiddenNetworks(fplmn);
+
+    for (linkPtr = le_dls_Peek(&PlmnList); linkPtr; linkPtr = le_dls_PeekNext(&PlmnList, linkPtr))
+    {
+        const Plmn_t*              plmnPtr = CONTAINER_OF(linkPtr, Plmn_t, link);
+        const PreferredOperator_t* operatorPtr;
+        uint32_t                   priority;
+
+        if (!(plmnPtr->ratMask & ratMask))
+        {
+            continue;
+        }
+        if ((0 == strcmp(plmnPtr->mcc, mccPtr)) && (0 == strcmp(plmnPtr->mnc, mncPtr)))
+        {
+            if (isHomeExcluded)
+            {
+                continue;
+            }
+            return false;
+        }
+        if (IsForbiddenNetwork(fplmn, fplmnCount, plmnPtr->mcc, plmnPtr->mnc))
+        {
+            continue;
+        }
+
+        // Networks out of the preferred operators come after them.
+        operatorPtr = FindPreferredOperator(plmnPtr->mcc, plmnPtr->mnc);
+        priority = (operatorPtr && (operatorPtr->ratMask & ratMask)) ?
+                   operatorPtr->priority : UINT32_MAX - 1;
+        if (priority < selectedPriority)
+        {
+            selectedPtr = plmnPtr;
+            selectedPriority = priority;
+        }
+    }
+
+    if (NULL == selectedPtr)
+    {
+        return false;
+    }
+
+    le_utf8_Copy(mccPtr, selectedPtr->mcc, LE_MRC_MCC_BYTES, NULL);
+    le_utf8_Copy(mncPtr, selectedPtr->mnc, LE_MRC_MNC_BYTES, NULL);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a RAT is allowed by the preferences and capabilities.
+ *
+ * @return true if the RAT has an allowed band.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRatAllowed
+(
+    le_mrc_Rat_t rat    ///< [IN] RAT
+)
+{
+    return ((uint32_t)rat < RAT_COUNT) && (AllowedRats & RatBands[rat].ratMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the registration state, and report the change. The packet switched domain is registered
+ * like the circuit switched one while it is attached.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetRegState
+(
+    le_mrc_NetRegState_t state  ///< [IN] Registration state
+)
+{
+    le_mrc_NetRegState_t* statePtr;
+    le_mrc_NetRegState_t psState;
+
+    if (state != RegState)
+    {
+        RegState = state;
+
+        statePtr = le_mem_ForceAlloc(RegStatePool);
+        *statePtr = state;
+        LE_DEBUG("Registration state: %d", state);
+        le_event_ReportWithRefCounting(NewRegStateEvent, statePtr);
+    }
+
+    psState = (IsPSAttached && ((LE_MRC_REG_HOME == state) || (LE_MRC_REG_ROAMING == state))) ?
+              state : LE_MRC_REG_NONE;
+    if (psState != PSState)
+    {
+        PSState = psState;
+
+        statePtr = le_mem_ForceAlloc(PSChangePool);
+        *statePtr = psState;
+        LE_DEBUG("Packet switched state: %d", psState);
+        le_event_ReportWithRefCounting(PSChangeEventId, statePtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the device is registered on a network.
+ *
+ * @return true when registered on the home network or roaming.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsRegistered
+(
+    void
+)
+{
+    return (LE_MRC_REG_HOME == RegState) || (LE_MRC_REG_ROAMING == RegState);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the selected network: the manually registered one, or the automatically selected one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSelectedNetwork
+(
+    char* mccPtr,   ///< [OUT] MCC, LE_MRC_MCC_BYTES long
+    char* mncPtr    ///< [OUT] MNC, LE_MRC_MNC_BYTES long
+)
+{
+    if (IsManual && ('\0' != CurentMccStr[0]))
+    {
+        le_utf8_Copy(mccPtr, CurentMccStr, LE_MRC_MCC_BYTES, NULL);
+        le_utf8_Copy(mncPtr, CurentMncStr, LE_MRC_MNC_BYTES, NULL);
+        return;
+    }
+
+    SelectAutomaticNetwork(false, mccPtr, mncPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register on the selected network: home or roaming as it is the home network or not.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompleteRegistration
+(
+    void
+)
+{
+    char homeMcc[LE_MRC_MCC_BYTES];
+    char homeMnc[LE_MRC_MNC_BYTES];
+
+    GetSelectedNetwork(RegisteredMcc, RegisteredMnc);
+    GetHomeNetwork(homeMcc, homeMnc);
+
+    SetRegState(((0 == strcmp(RegisteredMcc, homeMcc)) && (0 == strcmp(RegisteredMnc, homeMnc))) ?
+                LE_MRC_REG_HOME : LE_MRC_REG_ROAMING);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Registration timer handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RegistrationTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Registration timer
+)
+{
+    CompleteRegistration();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the registration state machine after a change of the radio power, of the coverage, of the
+ * allowed RATs or of the selected network: searching out of coverage or on a RAT without allowed
+ * band, registered on the selected network after the registration delay otherwise, not registered
+ * when the radio is off.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateRegistration
+(
+    void
+)
+{
+    le_timer_Stop(RegistrationTimerRef);
+
+    if (RadioPower != LE_ON)
+    {
+        SetRegState(LE_MRC_REG_NONE);
+    }
+    else if (!InCoverage || !IsRatAllowed(Rat))
+    {
+        SetRegState(LE_MRC_REG_SEARCHING);
+    }
+    else if (0 == RegistrationDelay)
+    {
+        CompleteRegistration();
+    }
+    else
+    {
+        SetRegState(LE_MRC_REG_SEARCHING);
+        le_timer_SetMsInterval(RegistrationTimerRef, RegistrationDelay);
+        le_timer_Start(RegistrationTimerRef);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Register again in automatic mode when the selected network is no longer the registered one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReselectNetwork
+(
+    void
+)
+{
+    char mcc[LE_MRC_MCC_BYTES];
+    char mnc[LE_MRC_MNC_BYTES];
+
+    if (IsManual || !IsRegistered())
+    {
+        return;
+    }
+
+    SelectAutomaticNetwork(false, mcc, mnc);
+    if ((0 != strcmp(mcc, RegisteredMcc)) || (0 != strcmp(mnc, RegisteredMnc)))
+    {
+        UpdateRegistration();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the RAT in use, and report the change. The registration follows the service on the new
+ * RAT.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetRat
+(
+    le_mrc_Rat_t rat    ///< [IN] RAT
+)
+{
+    le_mrc_Rat_t* ratPtr;
+    bool          wasAllowed = IsRatAllowed(Rat);
+
+    if (rat == Rat)
+    {
+        return;
+    }
+
+    Rat = rat;
+
+    ratPtr = le_mem_ForceAlloc(RatChangePool);
+    *ratPtr = rat;
+    LE_DEBUG("RAT change: %d", rat);
+    le_event_ReportWithRefCounting(RatChangeEvent, ratPtr);
+
+    if (IsRatAllowed(rat) != wasAllowed)
+    {
+        UpdateRegistration();
+    }
+    else
+    {
+        ReselectNetwork();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the RATs allowed by the RAT and band preferences, the band capabilities and the bands
+ * of the networks. The registration follows the service on the RAT in use.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateAllowedRats
+(
+    void
+)
+{
+    bool                wasAllowed = IsRatAllowed(Rat);
+    le_mrc_RatBitMask_t allowedRats = 0;
+    le_mrc_Rat_t        rat;
+
+    for (rat = LE_MRC_RAT_GSM; rat < RAT_COUNT; rat++)
+    {
+        uint64_t bands;
+
+        switch (rat)
+        {
+            case LE_MRC_RAT_LTE:
+                bands = CurrentLteBand & LTE_BAND_CAPABILITIES;
+                break;
+            case LE_MRC_RAT_TDSCDMA:
+                bands = CurrentTdScdmaBand & TDSCDMA_BAND_CAPABILITIES;
+                break;
+            default:
+                bands = CurrentBand & BAND_CAPABILITIES & RatBands[rat].bands;
+                break;
+        }
+
+        if ((RatPreferences & RatBands[rat].ratMask) && (bands & NetworkBands[rat]))
+        {
+            allowedRats |= RatBands[rat].ratMask;
+        }
+    }
+
+    AllowedRats = allowedRats;
+    LE_DEBUG("Allowed RATs: 0x%"PRIx32, (uint32_t)allowedRats);
+
+    if (IsRatAllowed(Rat) != wasAllowed)
+    {
+        UpdateRegistration();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a network reject indication.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportNetworkReject
+(
+    const char* mccPtr,     ///< [IN] MCC of the rejecting network
+    const char* mncPtr      ///< [IN] MNC of the rejecting network
+)
+{
+    pa_mrc_NetworkRejectIndication_t* indPtr = le_mem_ForceAlloc(NetworkRejectIndPool);
+
+    memset(indPtr, 0, sizeof(*indPtr));
+    indPtr->rat = Rat;
+    le_utf8_Copy(indPtr->mcc, mccPtr, sizeof(indPtr->mcc), NULL);
+    le_utf8_Copy(indPtr->mnc, mncPtr, sizeof(indPtr->mnc), NULL);
+
+    LE_DEBUG("Network reject indication: %s/%s on RAT %d", mccPtr, mncPtr, Rat);
+    le_event_ReportWithRefCounting(NetworkRejectIndEventId, indPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the registration scenario events. The events are ignored while the radio is off.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RegEventHandler
+(
+    const pa_regSimu_Event_t* eventPtr  ///< [IN] Event
+)
+{
+    char mcc[LE_MRC_MCC_BYTES];
+    char mnc[LE_MRC_MNC_BYTES];
+
+    if (RadioPower != LE_ON)
+    {
+        LE_DEBUG("Radio off, event %d ignored", eventPtr->type);
+        return;
+    }
+
+    switch (eventPtr->type)
+    {
+        case PA_REGSIMU_EVENT_NONE:
+            le_timer_Stop(RegistrationTimerRef);
+            SetRegState(LE_MRC_REG_NONE);
+            break;
+
+        case PA_REGSIMU_EVENT_SEARCHING:
+            le_timer_Stop(RegistrationTimerRef);
+            SetRegState(LE_MRC_REG_SEARCHING);
+            break;
+
+        case PA_REGSIMU_EVENT_HOME:
+            le_timer_Stop(RegistrationTimerRef);
+            if ('\0' != eventPtr->mcc[0])
+            {
+                le_utf8_Copy(RegisteredMcc, eventPtr->mcc, LE_MRC_MCC_BYTES, NULL);
+                le_utf8_Copy(RegisteredMnc, eventPtr->mnc, LE_MRC_MNC_BYTES, NULL);
+            }
+            else
+            {
+                GetHomeNetwork(RegisteredMcc, RegisteredMnc);
+            }
+            SetRegState(LE_MRC_REG_HOME);
+            break;
+
+        case PA_REGSIMU_EVENT_ROAMING:
+            if ('\0' != eventPtr->mcc[0])
+            {
+                le_utf8_Copy(mcc, eventPtr->mcc, LE_MRC_MCC_BYTES, NULL);
+                le_utf8_Copy(mnc, eventPtr->mnc, LE_MRC_MNC_BYTES, NULL);
+            }
+            else if (!SelectAutomaticNetwork(true, mcc, mnc))
+            {
+                LE_WARN("No visited network to roam on, event ignored");
+                break;
+            }
+            le_timer_Stop(RegistrationTimerRef);
+            le_utf8_Copy(RegisteredMcc, mcc, LE_MRC_MCC_BYTES, NULL);
+            le_utf8_Copy(RegisteredMnc, mnc, LE_MRC_MNC_BYTES, NULL);
+            SetRegState(LE_MRC_REG_ROAMING);
+            break;
+
+        case PA_REGSIMU_EVENT_DENIED:
+            le_timer_Stop(RegistrationTimerRef);
+            if ('\0' != eventPtr->mcc[0])
+            {
+                ReportNetworkReject(eventPtr->mcc, eventPtr->mnc);
+            }
+            else
+            {
+                GetSelectedNetwork(mcc, mnc);
+                ReportNetworkReject(mcc, mnc);
+            }
+            SetRegState(LE_MRC_REG_DENIED);
+            break;
+
+        case PA_REGSIMU_EVENT_RAT:
+            SetRat(eventPtr->rat);
+            break;
+
+        case PA_REGSIMU_EVENT_PS_ATTACH:
+        case PA_REGSIMU_EVENT_PS_DETACH:
+            IsPSAttached = (PA_REGSIMU_EVENT_PS_ATTACH == eventPtr->type);
+            SetRegState(RegState);
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the radio environment samples: the serving RAT and the coverage follow the radio
+ * scenario, and the signal strength indications are evaluated.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RadioSampleHandler
+(
+    const pa_radioSimu_Sample_t* samplePtr  ///< [IN] Sample
+)
+{
+    if (samplePtr->inCoverage)
+    {
+        SetRat(samplePtr->rat);
+
+        if (RadioPower == LE_ON)
+        {
+            EvaluateSignalInd(samplePtr);
+        }
+    }
+
+    if (samplePtr->inCoverage != InCoverage)
+    {
+        InCoverage = samplePtr->inCoverage;
+        UpdateRegistration();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the signal level of the serving cell.
+ *
+ * @return false if the radio is off or out of coverage.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mrc_BandBitMask_t CurrentBand = LE_MRC_BITMASK_BAND_GSM_DCS_1800;
-static le_mrc_LteBandBitMask_t CurrentLteBand = LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_11;
-static le_mrc_TdScdmaBandBitMask_t CurrentTdScdmaBand = LE_MRC_BITMASK_TDSCDMA_BAND_C;
+static bool GetServingLevel
+(
+    int32_t* levelPtr   ///< [OUT] Signal level in dBm
+)
+{
+    const pa_radioSimu_Sample_t* samplePtr = pa_radioSimu_GetSample();
+
+    if (RadioPower != LE_ON)
+    {
+        return false;
+    }
+
+    if (samplePtr)
+    {
+        *levelPtr = samplePtr->level;
+        return samplePtr->inCoverage;
+    }
+
+    *levelPtr = PA_RADIOSIMU_DEFAULT_LEVEL;
+    return true;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This event is reported when a Radio Access Technology change indication is received from the
- * modem. The report data is allocated from the associated pool.
+ * Find a network of the PLMN table.
+ *
+ * @return The network, NULL if not found.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t RatChangeEvent;
+static Plmn_t* FindPlmn
+(
+    const char* mccPtr,     ///< [IN] MCC
+    const char* mncPtr      ///< [IN] MNC
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    for (linkPtr = le_dls_Peek(&PlmnList); linkPtr; linkPtr = le_dls_PeekNext(&PlmnList, linkPtr))
+    {
+        Plmn_t* plmnPtr = CONTAINER_OF(linkPtr, Plmn_t, link);
+
+        if ((0 == strcmp(plmnPtr->mcc, mccPtr)) && (0 == strcmp(plmnPtr->mnc, mncPtr)))
+        {
+            return plmnPtr;
+        }
+    }
+
+    return NULL;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This event is reported when a registration state indication is received from the modem. The
- * report data is allocated from the associated pool.
+ * This function determine if the tupple (rat,mcc,mnc) is currently provided by the simulation:
+ * the RAT in use on the network of the last registration.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t NewRegStateEvent;
+static bool IsNetworkInUse
+(
+    le_mrc_Rat_t   rat,      /// [IN] RAT
+    const char    *mccPtr,   /// [IN] MCC
+    const char    *mncPtr    /// [IN] MNC
+)
+{
+    le_mrc_Rat_t currentRat;
+    le_result_t res;
+    res =  pa_mrc_GetRadioAccessTechInUse(&currentRat);
+    LE_FATAL_IF( (res != LE_OK), "Unable to get current RAT");
+
+    if(currentRat != rat)
+    {
+        return false;
+    }
 
+    return (0 == strcmp(RegisteredMcc, mccPtr)) && (0 == strcmp(RegisteredMnc, mncPtr));
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This event is reported when a Packet Switched change indication is received from the
- * modem. The report data is allocated from the associated pool.
+ * Append the networks of the PLMN table providing the specified RAT to the list of Scan
+ * Information.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t PSChangeEventId;
+static void AppendNetworkScanResult
+(
+    le_mrc_Rat_t   rat,                   /// [IN] Requested simulated RAT result
+    le_mrc_RatBitMask_t ratMask,          /// [IN] Bit mask of the RAT
+    le_dls_List_t *scanInformationListPtr ///< [OUT] list of pa_mrc_ScanInformation_t
+)
+{
+    pa_mrc_ScanInformation_t *newScanInformationPtr = NULL;
+    pa_sim_FPLMNOperator_t fplmn[FPLMN_MAX_COUNT];
+    uint32_t fplmnCount;
+    char homeMcc[LE_MRC_MCC_BYTES];
+    char homeMnc[LE_MRC_MNC_BYTES];
+    le_dls_Link_t* linkPtr;
+    int32_t level;
+
+    // No network is heard out of coverage.
+    if (!GetServingLevel(&level))
+    {
+        return;
+    }
+
+    GetHomeNetwork(homeMcc, homeMnc);
+    fplmnCount = ReadForbiddenNetworks(fplmn);
+
+    for (linkPtr = le_dls_Peek(&PlmnList); linkPtr; linkPtr = le_dls_PeekNext(&PlmnList, linkPtr))
+    {
+        Plmn_t* plmnPtr = CONTAINER_OF(linkPtr, Plmn_t, link);
+
+        if (!(plmnPtr->ratMask & ratMask))
+        {
+            continue;
+        }
+
+        newScanInformationPtr = le_mem_ForceAlloc(ScanInformationPool);
+
+        memset(newScanInformationPtr, 0, sizeof(*newScanInformationPtr));
+        newScanInformationPtr->link = LE_DLS_LINK_INIT;
+
+        newScanInformationPtr->rat = rat;
+        le_utf8_Copy(newScanInformationPtr->mobileCode.mcc, plmnPtr->mcc,
+                     sizeof(newScanInformationPtr->mobileCode.mcc), NULL);
+        le_utf8_Copy(newScanInformationPtr->mobileCode.mnc, plmnPtr->mnc,
+                     sizeof(newScanInformationPtr->mobileCode.mnc), NULL);
+        newScanInformationPtr->isInUse = IsNetworkInUse(rat, plmnPtr->mcc, plmnPtr->mnc);
+        newScanInformationPtr->isAvailable = !(newScanInformationPtr->isInUse);
+        newScanInformationPtr->isHome = (0 == strcmp(homeMcc, plmnPtr->mcc))
+                                        && (0 == strcmp(homeMnc, plmnPtr->mnc));
+        newScanInformationPtr->isForbidden = IsForbiddenNetwork(fplmn, fplmnCount, plmnPtr->mcc,
+                                                                plmnPtr->mnc);
+        if (newScanInformationPtr->isForbidden)
+        {
+            newScanInformationPtr->isAvailable = false;
+        }
+
+        le_dls_Queue(scanInformationListPtr, &(newScanInformationPtr->link));
+    }
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pool for Packet Switched change indication reporting.
+ * Check if an asynchronous network scan is in progress.
+ *
+ * @return true if a scan is in progress.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t PSChangePool;
+static bool IsNetworkScanInProgress
+(
+    void
+)
+{
+    return (NULL != AsyncScan.handlerPtr);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The pa_mrc_ScanInformation_t pool
+ * Start the network scan timer.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t ScanInformationPool;
+static void StartScanTimer
+(
+    uint32_t duration   ///< [IN] Duration in milliseconds, 0 to expire from the next event loop
+                        ///<      iteration
+)
+{
+    le_timer_SetMsInterval(ScanTimerRef, duration ? duration : 1);
+    le_timer_Start(ScanTimerRef);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The internal radio power state
+ * Move the asynchronous network scan to the next requested RAT.
+ *
+ * @return true if a RAT is left to scan, false if the scan is complete.
  */
 //--------------------------------------------------------------------------------------------------
-static le_onoff_t RadioPower = LE_ON;
+static bool FindNextScannedRat
+(
+    void
+)
+{
+    for (; AsyncScan.ratIndex < NUM_ARRAY_MEMBERS(ScannedRats); AsyncScan.ratIndex++)
+    {
+        if (AsyncScan.ratMask & ScannedRats[AsyncScan.ratIndex].ratMask)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The internal manual section mode status
+ * Complete the asynchronous network scan: its handler is called with the results.
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsManual = false;
+static void CompleteNetworkScan
+(
+    void
+)
+{
+    // The handler may start another scan.
+    pa_mrcSimu_ScanHandlerFunc_t handlerPtr = AsyncScan.handlerPtr;
+    le_dls_List_t resultList = AsyncScan.resultList;
 
+    AsyncScan.handlerPtr = NULL;
+    AsyncScan.resultList = LE_DLS_LIST_INIT;
 
-static char CurentMccStr[4];
-static char CurentMncStr[4];
+    LE_DEBUG("Network scan completed, %zu results", le_dls_NumLinks(&resultList));
+    handlerPtr((RadioPower == LE_ON) ? LE_OK : LE_NOT_POSSIBLE, &resultList, AsyncScan.contextPtr);
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function determine if the tupple (rat,mcc,mnc) is currently provided by the simulation.
+ * Network scan timer handler: the scan of a RAT is over, its results are appended and the next RAT
+ * is scanned. The handler is called once all the requested RATs are scanned.
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsNetworkInUse
+static void ScanTimerHandler
 (
-    le_mrc_Rat_t   rat,      /// [IN] RAT
-    const char    *mccPtr,   /// [IN] MCC
-    const char    *mncPtr    /// [IN] MNC
+    le_timer_Ref_t timerRef     ///< [IN] Network scan timer
 )
 {
-    le_mrc_Rat_t currentRat;
-    le_result_t res;
-
-    res =  pa_mrc_GetRadioAccessTechInUse(&currentRat);
-    LE_FATAL_IF( (res != LE_OK), "Unable to get current RAT");
-
-    if(currentRat != rat)
+    if (AsyncScan.ratIndex < NUM_ARRAY_MEMBERS(ScannedRats))
     {
-        return false;
+        AppendNetworkScanResult(ScannedRats[AsyncScan.ratIndex].rat,
+                                ScannedRats[AsyncScan.ratIndex].ratMask,
+                                &AsyncScan.resultList);
+        AsyncScan.ratIndex++;
     }
 
-    // @TODO Compare MCC/MNC
-
-    return true;
+    if (FindNextScannedRat())
+    {
+        StartScanTimer(ScanDurations[AsyncScan.ratIndex]);
+    }
+    else
+    {
+        CompleteNetworkScan();
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Append a simulated result for the specified RAT to the list of Scan Information
+ * Get the time elapsed since a start time.
+ *
+ * @return The elapsed time in nanoseconds.
  */
 //--------------------------------------------------------------------------------------------------
-static void AppendNetworkScanResult
+static uint64_t GetElapsedNs
 (
-    le_mrc_Rat_t   rat,                   /// [IN] Requested simulated RAT result
-    le_dls_List_t *scanInformationListPtr ///< [OUT] list of pa_mrc_ScanInformation_t
+    const struct timespec* startPtr     ///< [IN] Start time
 )
 {
-    pa_mrc_ScanInformation_t *newScanInformationPtr = NULL;
+    struct timespec now;
 
-    char mccStr[LE_MRC_MCC_BYTES];
-    char mncStr[LE_MRC_MNC_BYTES];
+    clock_gettime(CLOCK_MONOTONIC, &now);
 
-    newScanInformationPtr = le_mem_ForceAlloc(ScanInformationPool);
+    return (uint64_t)(now.tv_sec - startPtr->tv_sec) * 1000000000ULL +
+           now.tv_nsec - startPtr->tv_nsec;
+}
 
-    memset(newScanInformationPtr, 0, sizeof(*newScanInformationPtr));
-    newScanInformationPtr->link = LE_DLS_LINK_INIT;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of allocations from the pools of the polled functions: scan information and
+ * neighbouring cells.
+ *
+ * @return The number of allocations since the pools creation.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetPollingAllocCount
+(
+    void
+)
+{
+    le_mem_PoolStats_t scanStats;
+    le_mem_PoolStats_t cellStats;
 
-    // @TODO Default to SIM MCC/MNC
-    strncpy(mccStr, PA_SIMU_SIM_DEFAULT_MCC, sizeof(mccStr));
-    strncpy(mncStr, PA_SIMU_SIM_DEFAULT_MNC, sizeof(mncStr));
+    le_mem_GetStats(ScanInformationPool, &scanStats);
+    le_mem_GetStats(CellInfoPool, &cellStats);
 
-    newScanInformationPtr->rat = rat;
-    le_utf8_Copy(newScanInformationPtr->mobileCode.mcc, mccStr,
-                 sizeof(newScanInformationPtr->mobileCode.mcc), NULL);
-    le_utf8_Copy(newScanInformationPtr->mobileCode.mnc, mncStr,
-                 sizeof(newScanInformationPtr->mobileCode.mnc), NULL);
-    newScanInformationPtr->isInUse = IsNetworkInUse(rat, mccStr, mncStr);
-    newScanInformationPtr->isAvailable = !(newScanInformationPtr->isInUse);
-    newScanInformationPtr->isHome = true;
-    newScanInformationPtr->isForbidden = false;
+    return scanStats.numAllocs + cellStats.numAllocs;
+}
 
-    le_dls_Queue(scanInformationListPtr, &(newScanInformationPtr->link));
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the cost of a polled function from the start of its measurement.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetCallCost
+(
+    const struct timespec*  startPtr,       ///< [IN] Start time of the measurement
+    uint64_t                allocCount,     ///< [IN] Number of allocations at the start
+    uint32_t                callCount,      ///< [IN] Number of calls measured
+    pa_mrcSimu_CallCost_t*  costPtr         ///< [OUT] Cost
+)
+{
+    costPtr->nsPerCall = GetElapsedNs(startPtr) / callCount;
+    costPtr->allocsPerCall = (double)(GetPollingAllocCount() - allocCount) / callCount;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -185,6 +1563,8 @@ le_result_t pa_mrc_SetRadioPower
 
     LE_INFO("Turning radio %s", (RadioPower == LE_ON) ? "On" : "Off");
 
+    UpdateRegistration();
+
     return LE_OK;
 }
 
@@ -339,7 +1719,7 @@ le_result_t pa_mrc_GetNetworkRegState
     le_mrc_NetRegState_t* statePtr  ///< [OUT] The network registration state.
 )
 {
-    *statePtr = LE_MRC_REG_HOME;
+    *statePtr = RegState;
     return LE_OK;
 }
 
@@ -375,23 +1755,36 @@ le_result_t pa_mrc_GetSignalStrength
     int32_t*          rssiPtr    ///< [OUT] The received signal strength (in dBm).
 )
 {
+    const pa_radioSimu_Sample_t* samplePtr = pa_radioSimu_GetSample();
+
     if(RadioPower != LE_ON)
     {
         return LE_OUT_OF_RANGE;
     }
 
-    *rssiPtr = -60;
+    if (samplePtr)
+    {
+        if (!samplePtr->inCoverage)
+        {
+            return LE_OUT_OF_RANGE;
+        }
+        *rssiPtr = samplePtr->rssi;
+        return LE_OK;
+    }
+
+    *rssiPtr = PA_RADIOSIMU_DEFAULT_LEVEL;
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to get the current network information.
+ * This function must be called to get the current network information: the network of the last
+ * registration.
  *
  * @return
  *      - LE_OK on success
  *      - LE_OVERFLOW if the current network name can't fit in nameStr
- *      - LE_NOT_POSSIBLE on any other failure
+ *      - LE_NOT_POSSIBLE if not registered, or on any other failure
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_mrc_GetCurrentNetwork
@@ -404,103 +1797,252 @@ le_result_t pa_mrc_GetCurrentNetwork
     size_t      mncStrNumElements      ///< [IN]  the mncStr size
 )
 {
-    le_result_t res = LE_OK;
+    le_result_t res = LE_OK;
+    const Plmn_t* plmnPtr;
+
+    if ((RadioPower != LE_ON) || !IsRegistered())
+    {
+        if ((nameStr != NULL) && (nameStrSize > 0))
+        {
+            *nameStr = '\0';
+        }
+        return LE_NOT_POSSIBLE;
+    }
+
+    if (nameStr != NULL)
+    {
+        plmnPtr = FindPlmn(RegisteredMcc, RegisteredMnc);
+        res = le_utf8_Copy(nameStr, plmnPtr ? plmnPtr->name : PA_SIMU_MRC_DEFAULT_NAME,
+                           nameStrSize, NULL);
+        if (res != LE_OK)
+            return res;
+    }
+
+    if (mccStr != NULL)
+    {
+        res = le_utf8_Copy(mccStr, RegisteredMcc, mccStrNumElements, NULL);
+        if (res != LE_OK)
+            return res;
+    }
+
+    if (mncStr != NULL)
+    {
+        res = le_utf8_Copy(mncStr, RegisteredMnc, mncStrNumElements, NULL);
+    }
+
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to delete the list of Scan Information
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrc_DeleteScanInformation
+(
+    le_dls_List_t *scanInformationListPtr ///< [IN] list of pa_mrc_ScanInformation_t
+)
+{
+    pa_mrc_ScanInformation_t * nodePtr;
+    le_dls_Link_t * linkPtr;
+
+    while ((linkPtr = le_dls_Pop(scanInformationListPtr)) != NULL)
+    {
+        nodePtr = CONTAINER_OF(linkPtr, pa_mrc_ScanInformation_t, link);
+        le_mem_Release(nodePtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to perform a network scan.
+ *
+ * The caller is blocked for the scan durations of the scanned RATs.
+ *
+ * @return LE_FAULT         The function failed.
+ * @return LE_TIMEOUT       No response was received.
+ * @return LE_COMM_ERROR    Radio link failure occurred.
+ * @return LE_OK            The function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrc_PerformNetworkScan
+(
+    le_mrc_RatBitMask_t ratMask,               ///< [IN] The network mask
+    pa_mrc_ScanType_t   scanType,              ///< [IN] the scan type
+    le_dls_List_t      *scanInformationListPtr ///< [OUT] list of pa_mrc_ScanInformation_t
+)
+{
+    size_t i;
+
+    if(RadioPower != LE_ON)
+    {
+        return LE_NOT_POSSIBLE;
+    }
+
+    switch(scanType)
+    {
+        case PA_MRC_SCAN_PLMN:
+            break;
+
+        case PA_MRC_SCAN_CSG:
+            break;
+    }
+
+    if (ratMask & LE_MRC_BITMASK_RAT_ALL)
+    {
+        ratMask = ALL_RATS;
+    }
+    // RATs without allowed band are not scanned.
+    ratMask &= AllowedRats;
+
+    // The modem is busy during the whole scan.
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ScannedRats); i++)
+    {
+        if (ratMask & ScannedRats[i].ratMask)
+        {
+            if (ScanDurations[i])
+            {
+                usleep(ScanDurations[i] * 1000);
+            }
+            AppendNetworkScanResult(ScannedRats[i].rat, ScannedRats[i].ratMask,
+                                    scanInformationListPtr);
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform a network scan without blocking the caller: the RATs are scanned one after the other,
+ * each one during its scan duration, and the handler is called with the results from the event
+ * loop of the caller.
+ *
+ * @return LE_NOT_POSSIBLE  The radio is off.
+ * @return LE_BUSY          A scan is already in progress.
+ * @return LE_OK            The scan is started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_PerformNetworkScanAsync
+(
+    le_mrc_RatBitMask_t          ratMask,       ///< [IN] The network mask
+    pa_mrcSimu_ScanHandlerFunc_t handlerPtr,    ///< [IN] Completion handler
+    void*                        contextPtr     ///< [IN] Context of the handler
+)
+{
+    LE_ASSERT(handlerPtr);
 
     if (RadioPower != LE_ON)
     {
-        *nameStr = '\0';
         return LE_NOT_POSSIBLE;
     }
-
-    if (nameStr != NULL)
-    {
-        res = le_utf8_Copy(nameStr, PA_SIMU_MRC_DEFAULT_NAME, nameStrSize, NULL);
-        if (res != LE_OK)
-            return res;
-    }
-
-    if (mccStr != NULL)
+    if (IsNetworkScanInProgress())
     {
-        res = le_utf8_Copy(mccStr, CurentMccStr, mccStrNumElements, NULL);
-        if (res != LE_OK)
-            return res;
+        return LE_BUSY;
     }
 
-    if (mncStr != NULL)
-    {
-        res = le_utf8_Copy(mncStr, CurentMncStr, mncStrNumElements, NULL);
-    }
+    AsyncScan.ratMask = ((ratMask & LE_MRC_BITMASK_RAT_ALL) ? ALL_RATS : ratMask) & AllowedRats;
+    AsyncScan.ratIndex = 0;
+    AsyncScan.resultList = LE_DLS_LIST_INIT;
+    AsyncScan.handlerPtr = handlerPtr;
+    AsyncScan.contextPtr = contextPtr;
 
-    return res;
+    // Without any RAT to scan, the handler is still called from the event loop.
+    StartScanTimer(FindNextScannedRat() ? ScanDurations[AsyncScan.ratIndex] : 0);
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to delete the list of Scan Information
+ * Set the scan duration of a RAT.
  *
- * @TODO    implementation
+ * @return LE_BAD_PARAMETER Unknown RAT.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-void pa_mrc_DeleteScanInformation
+le_result_t pa_mrcSimu_SetScanDuration
 (
-    le_dls_List_t *scanInformationListPtr ///< [IN] list of pa_mrc_ScanInformation_t
+    le_mrc_Rat_t rat,       ///< [IN] RAT
+    uint32_t     duration   ///< [IN] Scan duration in milliseconds
 )
 {
-    pa_mrc_ScanInformation_t * nodePtr;
-    le_dls_Link_t * linkPtr;
+    size_t i;
 
-    while ((linkPtr = le_dls_Pop(scanInformationListPtr)) != NULL)
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ScannedRats); i++)
     {
-        nodePtr = CONTAINER_OF(linkPtr, pa_mrc_ScanInformation_t, link);
-        le_mem_Release(nodePtr);
+        if (ScannedRats[i].rat == rat)
+        {
+            ScanDurations[i] = duration;
+            return LE_OK;
+        }
     }
+
+    return LE_BAD_PARAMETER;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to perform a network scan.
+ * Add a network to the PLMN table, or update it if it is already in.
  *
- * @return LE_FAULT         The function failed.
- * @return LE_TIMEOUT       No response was received.
- * @return LE_COMM_ERROR    Radio link failure occurred.
- * @return LE_OK            The function succeeded.
+ * @return LE_BAD_PARAMETER Invalid MCC, MNC or name.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_mrc_PerformNetworkScan
+le_result_t pa_mrcSimu_AddPlmn
 (
-    le_mrc_RatBitMask_t ratMask,               ///< [IN] The network mask
-    pa_mrc_ScanType_t   scanType,              ///< [IN] the scan type
-    le_dls_List_t      *scanInformationListPtr ///< [OUT] list of pa_mrc_ScanInformation_t
+    const char*         mccPtr,     ///< [IN] Mobile Country Code
+    const char*         mncPtr,     ///< [IN] Mobile Network Code
+    const char*         namePtr,    ///< [IN] Operator name
+    le_mrc_RatBitMask_t ratMask     ///< [IN] RATs provided by the network
 )
 {
-    if(RadioPower != LE_ON)
-    {
-        return LE_NOT_POSSIBLE;
-    }
+    Plmn_t* plmnPtr;
 
-    switch(scanType)
+    if ((NULL == mccPtr) || (NULL == mncPtr) || (NULL == namePtr)
+        || (LE_MRC_MCC_LEN != strlen(mccPtr)) || (strlen(mncPtr) < 2)
+        || (strlen(mncPtr) > LE_MRC_MNC_LEN)
+        || (strlen(namePtr) >= PA_MRCSIMU_NETWORK_NAME_BYTES))
     {
-        case PA_MRC_SCAN_PLMN:
-            break;
-
-        case PA_MRC_SCAN_CSG:
-            break;
+        LE_ERROR("Invalid network");
+        return LE_BAD_PARAMETER;
     }
 
-    if (ratMask & LE_MRC_BITMASK_RAT_GSM)
-    {
-        AppendNetworkScanResult(LE_MRC_RAT_GSM, scanInformationListPtr);
-    }
-    if (ratMask & LE_MRC_BITMASK_RAT_UMTS)
+    plmnPtr = FindPlmn(mccPtr, mncPtr);
+    if (NULL == plmnPtr)
     {
-        AppendNetworkScanResult(LE_MRC_RAT_UMTS, scanInformationListPtr);
+        plmnPtr = le_mem_ForceAlloc(PlmnPool);
+        plmnPtr->link = LE_DLS_LINK_INIT;
+        le_utf8_Copy(plmnPtr->mcc, mccPtr, sizeof(plmnPtr->mcc), NULL);
+        le_utf8_Copy(plmnPtr->mnc, mncPtr, sizeof(plmnPtr->mnc), NULL);
+        le_dls_Queue(&PlmnList, &plmnPtr->link);
     }
-    if (ratMask & LE_MRC_BITMASK_RAT_LTE)
+
+    le_utf8_Copy(plmnPtr->name, namePtr, sizeof(plmnPtr->name), NULL);
+    plmnPtr->ratMask = ratMask;
+
+    ReselectNetwork();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the networks of the PLMN table.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_ClearPlmns
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(&PlmnList)) != NULL)
     {
-        AppendNetworkScanResult(LE_MRC_RAT_LTE, scanInformationListPtr);
+        le_mem_Release(CONTAINER_OF(linkPtr, Plmn_t, link));
     }
 
-    return LE_OK;
+    ReselectNetwork();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -520,16 +2062,17 @@ le_result_t pa_mrc_GetScanInformationName
     size_t nameSize ///< [IN] The size in bytes of the namePtr buffer
 )
 {
+    Plmn_t* plmnPtr;
+
     if ((!scanInformationPtr) || (!namePtr))
     {
         return LE_NOT_POSSIBLE;
     }
 
-    // @TODO Handle other names than default SIM MCC/MNC
-    if ( (0 == strcmp(scanInformationPtr->mobileCode.mcc, PA_SIMU_SIM_DEFAULT_MCC)) &&
-         (0 == strcmp(scanInformationPtr->mobileCode.mnc, PA_SIMU_SIM_DEFAULT_MNC)) )
+    plmnPtr = FindPlmn(scanInformationPtr->mobileCode.mcc, scanInformationPtr->mobileCode.mnc);
+    if (plmnPtr)
     {
-        return le_utf8_Copy(namePtr, PA_SIMU_MRC_DEFAULT_NAME, nameSize, NULL);
+        return le_utf8_Copy(namePtr, plmnPtr->name, nameSize, NULL);
     }
 
     return LE_NOT_POSSIBLE;
@@ -552,7 +2095,15 @@ le_result_t pa_mrc_CountPreferredOperators
     int32_t*  nbItemPtr     ///< [OUT] number of Preferred operator found if success.
 )
 {
-    return LE_FAULT;
+    if (NULL == nbItemPtr)
+    {
+        LE_ERROR("nbItemPtr is NULL");
+        return LE_FAULT;
+    }
+
+    // The simulated SIM has no static preferred operator.
+    *nbItemPtr = plmnUser ? (int32_t)le_hashmap_Size(PreferredOperatorMap) : 0;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -573,7 +2124,35 @@ le_result_t pa_mrc_GetPreferredOperators
     int32_t* nbItemPtr ///< [IN/OUT] number of Preferred operator to find (in) and written (out).
 )
 {
-    return LE_NOT_FOUND;
+    le_dls_Link_t* linkPtr;
+    int32_t        count = 0;
+
+    if ((NULL == preferredOperatorPtr) || (NULL == nbItemPtr))
+    {
+        LE_ERROR("NULL pointer");
+        return LE_NOT_FOUND;
+    }
+
+    if (plmnUser)
+    {
+        for (linkPtr = le_dls_Peek(&PreferredOperatorList);
+             linkPtr && (count < *nbItemPtr);
+             linkPtr = le_dls_PeekNext(&PreferredOperatorList, linkPtr))
+        {
+            PreferredOperator_t* operatorPtr = CONTAINER_OF(linkPtr, PreferredOperator_t, link);
+
+            le_utf8_Copy(preferredOperatorPtr[count].mobileCode.mcc, operatorPtr->mcc,
+                         LE_MRC_MCC_BYTES, NULL);
+            le_utf8_Copy(preferredOperatorPtr[count].mobileCode.mnc, operatorPtr->mnc,
+                         LE_MRC_MNC_BYTES, NULL);
+            preferredOperatorPtr[count].ratMask = operatorPtr->ratMask;
+            preferredOperatorPtr[count].link = LE_DLS_LINK_INIT;
+            count++;
+        }
+    }
+
+    *nbItemPtr = count;
+    return (count > 0) ? LE_OK : LE_NOT_FOUND;
 }
 
 
@@ -591,7 +2170,37 @@ le_result_t pa_mrc_SavePreferredOperators
     le_dls_List_t      *PreferredOperatorsListPtr ///< [IN] List of preferred network operator
 )
 {
-    return LE_FAULT;
+    le_dls_Link_t* linkPtr;
+    le_result_t    res = LE_OK;
+
+    if (NULL == PreferredOperatorsListPtr)
+    {
+        LE_ERROR("PreferredOperatorsListPtr is NULL");
+        return LE_FAULT;
+    }
+
+    // The list is kept up to the first invalid operator, like a modem writing the SIM records.
+    ClearPreferredOperators();
+    for (linkPtr = le_dls_Peek(PreferredOperatorsListPtr);
+         linkPtr && (LE_OK == res);
+         linkPtr = le_dls_PeekNext(PreferredOperatorsListPtr, linkPtr))
+    {
+        pa_mrc_PreferredNetworkOperator_t* operatorPtr =
+            CONTAINER_OF(linkPtr, pa_mrc_PreferredNetworkOperator_t, link);
+
+        if (LE_OK != AddPreferredOperator(operatorPtr->mobileCode.mcc,
+                                          operatorPtr->mobileCode.mnc,
+                                          operatorPtr->ratMask))
+        {
+            res = LE_FAULT;
+        }
+    }
+    StorePreferredOperators();
+
+    LE_INFO("%zu preferred operators saved", le_hashmap_Size(PreferredOperatorMap));
+
+    ReselectNetwork();
+    return res;
 }
 
 
@@ -615,6 +2224,8 @@ le_result_t pa_mrc_RegisterNetwork
     le_utf8_Copy(CurentMccStr, mccPtr, sizeof(CurentMccStr), NULL);
     le_utf8_Copy(CurentMncStr, mncPtr, sizeof(CurentMncStr), NULL);
 
+    UpdateRegistration();
+
     return LE_OK;
 }
 
@@ -638,6 +2249,8 @@ le_result_t pa_mrc_SetAutomaticNetworkRegistration
     le_utf8_Copy(CurentMccStr, PA_SIMU_MRC_DEFAULT_MCC, sizeof(CurentMccStr), NULL);
     le_utf8_Copy(CurentMncStr, PA_SIMU_MRC_DEFAULT_MNC, sizeof(CurentMncStr), NULL);
 
+    UpdateRegistration();
+
     return LE_OK;
 }
 
@@ -651,7 +2264,60 @@ void pa_mrcSimu_SetRadioAccessTechInUse
     le_mrc_Rat_t   rat  ///< [IN] The Radio Access Technology.
 )
 {
-    Rat = rat;
+    SetRat(rat);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bands of a RAT deployed by the simulated networks.
+ *
+ * @return LE_BAD_PARAMETER Unknown RAT.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_SetNetworkBands
+(
+    le_mrc_Rat_t rat,       ///< [IN] RAT
+    uint64_t     bands      ///< [IN] Bands, in the band bit mask of the RAT
+)
+{
+    if ((LE_MRC_RAT_UNKNOWN == rat) || ((uint32_t)rat >= RAT_COUNT))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    NetworkBands[rat] = bands;
+    UpdateAllowedRats();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the RATs allowed by the RAT and band preferences, the band capabilities and the network
+ * bands.
+ *
+ * @return The allowed RATs.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mrc_RatBitMask_t pa_mrcSimu_GetAllowedRats
+(
+    void
+)
+{
+    return AllowedRats;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time between the network finding and the registration.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_SetRegistrationDelay
+(
+    uint32_t delay  ///< [IN] Registration delay in milliseconds
+)
+{
+    RegistrationDelay = delay;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -686,8 +2352,19 @@ le_result_t pa_mrc_SetRatPreferences
     le_mrc_RatBitMask_t bitMask ///< [IN] A bit mask to set the Radio Access Technology preference.
 )
 {
-    // TODO: implement this function
-    return LE_UNSUPPORTED;
+    if (bitMask & LE_MRC_BITMASK_RAT_ALL)
+    {
+        bitMask = ALL_RATS;
+    }
+    if (0 == (bitMask & ALL_RATS))
+    {
+        LE_ERROR("No RAT in 0x%"PRIx32, (uint32_t)bitMask);
+        return LE_FAULT;
+    }
+
+    RatPreferences = bitMask & ALL_RATS;
+    UpdateAllowedRats();
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -704,8 +2381,9 @@ le_result_t pa_mrc_SetAutomaticRatPreference
     void
 )
 {
-    // TODO: implement this function
-    return LE_FAULT;
+    RatPreferences = ALL_RATS;
+    UpdateAllowedRats();
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -723,8 +2401,8 @@ le_result_t pa_mrc_GetRatPreferences
                                         ///<  preferences.
 )
 {
-    // TODO: implement this function
-    return LE_FAULT;
+    *ratMaskPtr = RatPreferences;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -742,6 +2420,7 @@ le_result_t pa_mrc_SetBandPreferences
 )
 {
     CurrentBand = bands;
+    UpdateAllowedRats();
     return LE_OK;
 }
 
@@ -780,6 +2459,7 @@ le_result_t pa_mrc_SetLteBandPreferences
 {
 
     CurrentLteBand = bands;
+    UpdateAllowedRats();
     return LE_OK;
 }
 
@@ -816,6 +2496,7 @@ le_result_t pa_mrc_SetTdScdmaBandPreferences
 )
 {
     CurrentTdScdmaBand = bands;
+    UpdateAllowedRats();
     return LE_OK;
 }
 
@@ -853,9 +2534,62 @@ int32_t pa_mrc_GetNeighborCellsInfo
     le_dls_List_t*   cellInfoListPtr    ///< [OUT] The Neighboring Cells information.
 )
 {
-    // TODO: implement this function
-    // No neighbours cells.
-    return 0;
+    const pa_cellSimu_Cell_t* cellPtr;
+    pa_mrc_SignalMetrics_t    metrics;
+    int32_t                   servingLevel;
+    int32_t                   sensitivity = pa_radioSimu_GetSensitivity(Rat);
+    uint32_t                  cellCount;
+    uint32_t                  i;
+
+    if (NULL == cellInfoListPtr)
+    {
+        return LE_FAULT;
+    }
+    if (!GetServingLevel(&servingLevel))
+    {
+        return 0;
+    }
+
+    cellPtr = pa_cellSimu_GetNeighbors(&cellCount);
+    for (i = 0; i < cellCount; i++)
+    {
+        double             level = servingLevel - cellPtr[i].attenuation;
+        pa_mrc_CellInfo_t* cellInfoPtr;
+
+        // Cells are sorted from the strongest: the next ones are not heard either.
+        if (level < sensitivity)
+        {
+            break;
+        }
+
+        pa_radioSimu_ComputeMetrics(Rat, level, &metrics);
+
+        cellInfoPtr = le_mem_ForceAlloc(CellInfoPool);
+        memset(cellInfoPtr, 0, sizeof(*cellInfoPtr));
+        cellInfoPtr->link = LE_DLS_LINK_INIT;
+        cellInfoPtr->index = i;
+        cellInfoPtr->id = cellPtr[i].id;
+        cellInfoPtr->lac = cellPtr[i].lac;
+        cellInfoPtr->rxLevel = (int16_t)lround(level);
+        cellInfoPtr->rat = Rat;
+        switch (Rat)
+        {
+            case LE_MRC_RAT_UMTS:
+            case LE_MRC_RAT_TDSCDMA:
+                cellInfoPtr->umtsEcIo = metrics.umts.ecio;
+                break;
+            case LE_MRC_RAT_LTE:
+                cellInfoPtr->lteIntraRsrp = metrics.lte.rsrp;
+                cellInfoPtr->lteIntraRsrq = metrics.lte.rsrq;
+                break;
+            default:
+                break;
+        }
+
+        le_dls_Queue(cellInfoListPtr, &cellInfoPtr->link);
+    }
+
+    return i;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -869,14 +2603,21 @@ void pa_mrc_DeleteNeighborCellsInfo
     le_dls_List_t *cellInfoListPtr ///< [IN] list of pa_mrc_CellInfo_t
 )
 {
-    // TODO: implement this function
-    return ;
+    le_dls_Link_t* linkPtr;
+
+    while ((linkPtr = le_dls_Pop(cellInfoListPtr)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, pa_mrc_CellInfo_t, link));
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to get current registration mode
+ * This function must be called to get current registration mode, and the network of the last
+ * registration.
  *
+ * @return LE_NOT_POSSIBLE  Not registered.
+ * @return LE_OK            The function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_mrc_GetNetworkRegistrationMode
@@ -888,11 +2629,15 @@ le_result_t pa_mrc_GetNetworkRegistrationMode
     size_t  mncPtrSize    ///< [IN] mncPtr buffer size
 )
 {
+    *isManualPtr = IsManual;
 
-    le_utf8_Copy(mccPtr, CurentMccStr, mccPtrSize, NULL);
-    le_utf8_Copy(mncPtr, CurentMncStr, mncPtrSize, NULL);
+    if (!IsRegistered())
+    {
+        return LE_NOT_POSSIBLE;
+    }
 
-    *isManualPtr = IsManual;
+    le_utf8_Copy(mccPtr, RegisteredMcc, mccPtrSize, NULL);
+    le_utf8_Copy(mncPtr, RegisteredMnc, mncPtrSize, NULL);
 
     return LE_OK;
 }
@@ -911,8 +2656,25 @@ le_result_t pa_mrc_MeasureSignalMetrics
     pa_mrc_SignalMetrics_t* metricsPtr    ///< [OUT] The signal metrics.
 )
 {
-    // TODO: implement this function
-    return LE_FAULT;
+    const pa_radioSimu_Sample_t* samplePtr = pa_radioSimu_GetSample();
+
+    if ((RadioPower != LE_ON) || (NULL == metricsPtr))
+    {
+        return LE_FAULT;
+    }
+
+    if (samplePtr)
+    {
+        if (!samplePtr->inCoverage)
+        {
+            return LE_FAULT;
+        }
+        *metricsPtr = samplePtr->metrics;
+        return LE_OK;
+    }
+
+    pa_radioSimu_ComputeMetrics(Rat, PA_RADIOSIMU_DEFAULT_LEVEL, metricsPtr);
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -931,8 +2693,16 @@ le_event_HandlerRef_t pa_mrc_AddSignalStrengthIndHandler
     void*                              contextPtr    ///< [IN] The context to be given to the handler.
 )
 {
-    // TODO: implement this function
-    return NULL;
+    le_event_HandlerRef_t handlerRef;
+
+    LE_ASSERT(ssIndHandler != NULL);
+
+    handlerRef = le_event_AddHandler("SignalStrengthIndHandler",
+                                     SignalStrengthIndEventId,
+                                     (le_event_HandlerFunc_t) ssIndHandler);
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return handlerRef;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -947,8 +2717,7 @@ void pa_mrc_RemoveSignalStrengthIndHandler
     le_event_HandlerRef_t handlerRef
 )
 {
-    // TODO: implement this function
-    return ;
+    le_event_RemoveHandler(handlerRef);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -983,6 +2752,17 @@ le_result_t pa_mrc_SetSignalStrengthIndThresholds
             return LE_FAULT;
     }
 
+    if (lowerRangeThreshold >= upperRangeThreshold)
+    {
+        LE_ERROR("Bad thresholds %"PRId32" >= %"PRId32, lowerRangeThreshold, upperRangeThreshold);
+        return LE_FAULT;
+    }
+
+    SignalIndStates[rat].thresholdsSet = true;
+    SignalIndStates[rat].lowerThreshold = lowerRangeThreshold * 10;
+    SignalIndStates[rat].upperThreshold = upperRangeThreshold * 10;
+    SignalIndStates[rat].primed = false;
+
     return LE_OK;
 }
 
@@ -1026,6 +2806,127 @@ le_result_t pa_mrc_SetSignalStrengthIndDelta
             return LE_FAULT;
     }
 
+    SignalIndStates[rat].delta = delta;
+    SignalIndStates[rat].primed = false;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the signal strength indication statistics: samples evaluated and indications reported.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_GetSignalIndStats
+(
+    pa_mrcSimu_SignalIndStats_t* statsPtr   ///< [OUT] Statistics
+)
+{
+    *statsPtr = SignalIndStats;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the signal strength indication statistics.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_ResetSignalIndStats
+(
+    void
+)
+{
+    memset(&SignalIndStats, 0, sizeof(SignalIndStats));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of the functions polled by the applications: the signal strength, the current
+ * network, a scan of all the RATs and the deletion of its results, and the neighbouring cells and
+ * their deletion. The scan durations are ignored during the measurement.
+ *
+ * @return LE_BAD_PARAMETER The number of calls is null.
+ * @return LE_NOT_POSSIBLE  The radio is off.
+ * @return LE_BUSY          An asynchronous scan is in progress.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_RunPollingBenchmark
+(
+    uint32_t                        callCount,  ///< [IN] Number of calls of each function
+    pa_mrcSimu_PollingBenchmark_t*  resultPtr   ///< [OUT] Cost of each function
+)
+{
+    uint32_t        scanDurations[NUM_ARRAY_MEMBERS(ScanDurations)];
+    struct timespec start;
+    uint64_t        allocCount;
+    uint32_t        i;
+    int32_t         rssi;
+    char            name[PA_MRCSIMU_NETWORK_NAME_BYTES];
+    char            mcc[LE_MRC_MCC_BYTES];
+    char            mnc[LE_MRC_MNC_BYTES];
+    le_dls_List_t   list;
+
+    if ((0 == callCount) || (NULL == resultPtr))
+    {
+        LE_ERROR("Invalid parameters");
+        return LE_BAD_PARAMETER;
+    }
+    if (RadioPower != LE_ON)
+    {
+        return LE_NOT_POSSIBLE;
+    }
+    if (IsNetworkScanInProgress())
+    {
+        return LE_BUSY;
+    }
+
+    allocCount = GetPollingAllocCount();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < callCount; i++)
+    {
+        pa_mrc_GetSignalStrength(&rssi);
+    }
+    SetCallCost(&start, allocCount, callCount, &resultPtr->signalStrength);
+
+    allocCount = GetPollingAllocCount();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < callCount; i++)
+    {
+        pa_mrc_GetCurrentNetwork(name, sizeof(name), mcc, sizeof(mcc), mnc, sizeof(mnc));
+    }
+    SetCallCost(&start, allocCount, callCount, &resultPtr->currentNetwork);
+
+    memcpy(scanDurations, ScanDurations, sizeof(scanDurations));
+    memset(ScanDurations, 0, sizeof(ScanDurations));
+    allocCount = GetPollingAllocCount();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < callCount; i++)
+    {
+        list = LE_DLS_LIST_INIT;
+        pa_mrc_PerformNetworkScan(LE_MRC_BITMASK_RAT_ALL, PA_MRC_SCAN_PLMN, &list);
+        pa_mrc_DeleteScanInformation(&list);
+    }
+    SetCallCost(&start, allocCount, callCount, &resultPtr->networkScan);
+    memcpy(ScanDurations, scanDurations, sizeof(ScanDurations));
+
+    allocCount = GetPollingAllocCount();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < callCount; i++)
+    {
+        list = LE_DLS_LIST_INIT;
+        pa_mrc_GetNeighborCellsInfo(&list);
+        pa_mrc_DeleteNeighborCellsInfo(&list);
+    }
+    SetCallCost(&start, allocCount, callCount, &resultPtr->neighborCells);
+
+    LE_INFO("MRC polling benchmark: %"PRIu32" calls, signal strength %"PRIu64" ns, current network"
+            " %"PRIu64" ns, network scan %"PRIu64" ns %.1f allocs, neighbour cells %"PRIu64" ns"
+            " %.1f allocs", callCount, resultPtr->signalStrength.nsPerCall,
+            resultPtr->currentNetwork.nsPerCall, resultPtr->networkScan.nsPerCall,
+            resultPtr->networkScan.allocsPerCall, resultPtr->neighborCells.nsPerCall,
+            resultPtr->neighborCells.allocsPerCall);
     return LE_OK;
 }
 
@@ -1043,8 +2944,15 @@ le_result_t pa_mrc_GetServingCellId
     uint32_t* cellIdPtr ///< [OUT] main Cell Identifier.
 )
 {
-    // TODO: implement this function
-    return LE_FAULT;
+    int32_t level;
+
+    if ((NULL == cellIdPtr) || !GetServingLevel(&level))
+    {
+        return LE_FAULT;
+    }
+
+    *cellIdPtr = pa_cellSimu_GetServingCell()->id;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1061,8 +2969,15 @@ le_result_t pa_mrc_GetServingCellLocAreaCode
     uint32_t* lacPtr ///< [OUT] Location Area Code of the serving cell.
 )
 {
-    // TODO: implement this function
-    return LE_FAULT;
+    int32_t level;
+
+    if ((NULL == lacPtr) || !GetServingLevel(&level))
+    {
+        return LE_FAULT;
+    }
+
+    *lacPtr = pa_cellSimu_GetServingCell()->lac;
+    return LE_OK;
 }
 
 
@@ -1080,7 +2995,14 @@ le_result_t pa_mrc_GetServingCellLteTracAreaCode
     uint16_t* tacPtr ///< [OUT] Tracking Area Code of the serving cell.
 )
 {
-    *tacPtr = 0xABCD;
+    int32_t level;
+
+    if ((NULL == tacPtr) || !GetServingLevel(&level))
+    {
+        return LE_FAULT;
+    }
+
+    *tacPtr = pa_cellSimu_GetServingCell()->lac;
     return LE_OK;
 }
 
@@ -1099,7 +3021,7 @@ le_result_t pa_mrc_GetBandCapabilities
     le_mrc_BandBitMask_t* bandsPtr ///< [OUT] A bit mask to get the Band capabilities.
 )
 {
-    *bandsPtr = LE_MRC_BITMASK_BAND_CLASS_1_ALL_BLOCKS | LE_MRC_BITMASK_BAND_GSM_DCS_1800;
+    *bandsPtr = BAND_CAPABILITIES;
     return LE_OK;
 }
 
@@ -1118,7 +3040,7 @@ le_result_t pa_mrc_GetLteBandCapabilities
     le_mrc_LteBandBitMask_t* bandsPtr ///< [OUT] Bit mask to get the LTE Band capabilities.
 )
 {
-    *bandsPtr = LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_3 | LE_MRC_BITMASK_LTE_BAND_E_UTRA_OP_BAND_7;
+    *bandsPtr = LTE_BAND_CAPABILITIES;
     return LE_OK;
 }
 
@@ -1138,7 +3060,7 @@ le_result_t pa_mrc_GetTdScdmaBandCapabilities
     le_mrc_TdScdmaBandBitMask_t* bandsPtr ///< [OUT] Bit mask to get the TD-SCDMA Band capabilities.
 )
 {
-    *bandsPtr = LE_MRC_BITMASK_TDSCDMA_BAND_A | LE_MRC_BITMASK_TDSCDMA_BAND_C;
+    *bandsPtr = TDSCDMA_BAND_CAPABILITIES;
     return LE_OK;
 }
 
@@ -1159,7 +3081,7 @@ le_result_t pa_mrc_GetPacketSwitchedState
 {
     if (statePtr)
     {
-        *statePtr = LE_MRC_REG_HOME;
+        *statePtr = PSState;
         return LE_OK;
     }
 
@@ -1221,8 +3143,47 @@ le_result_t mrc_simu_Init
 
     PSChangeEventId = le_event_CreateIdWithRefCounting("PSChangeEvent");
     PSChangePool = le_mem_CreatePool("PSChangePool", sizeof(le_mrc_NetRegState_t));
+    RegStatePool = le_mem_CreatePool("RegStatePool", sizeof(le_mrc_NetRegState_t));
+    RatChangePool = le_mem_CreatePool("RatChangePool", sizeof(le_mrc_Rat_t));
+
+    NetworkRejectIndEventId = le_event_CreateIdWithRefCounting("NetworkRejectIndEvent");
+    NetworkRejectIndPool = le_mem_CreatePool("NetworkRejectIndPool",
+                                             sizeof(pa_mrc_NetworkRejectIndication_t));
+
+    PreferredOperatorPool = le_mem_CreatePool("PreferredOperatorPool",
+                                              sizeof(PreferredOperator_t));
+    le_mem_ExpandPool(PreferredOperatorPool, PREFERRED_OPERATOR_POOL_SIZE);
+    PreferredOperatorMap = le_hashmap_Create("PreferredOperators", PREFERRED_OPERATOR_MAP_SIZE,
+                                             le_hashmap_HashString, le_hashmap_EqualsString);
+    LoadPreferredOperators();
+
+    RegistrationTimerRef = le_timer_Create("RegistrationTimer");
+    le_timer_SetHandler(RegistrationTimerRef, RegistrationTimerHandler);
+    UpdateAllowedRats();
 
     ScanInformationPool = le_mem_CreatePool("ScanInformationPool", sizeof(pa_mrc_ScanInformation_t));
+    le_mem_ExpandPool(ScanInformationPool, SCAN_INFORMATION_POOL_SIZE);
+
+    PlmnPool = le_mem_CreatePool("PlmnPool", sizeof(Plmn_t));
+    le_mem_ExpandPool(PlmnPool, PLMN_POOL_SIZE);
+    pa_mrcSimu_AddPlmn(PA_SIMU_SIM_DEFAULT_MCC, PA_SIMU_SIM_DEFAULT_MNC, PA_SIMU_MRC_DEFAULT_NAME,
+                       LE_MRC_BITMASK_RAT_GSM | LE_MRC_BITMASK_RAT_UMTS | LE_MRC_BITMASK_RAT_LTE);
+
+    ScanTimerRef = le_timer_Create("NetworkScanTimer");
+    le_timer_SetHandler(ScanTimerRef, ScanTimerHandler);
+
+    SignalStrengthIndEventId = le_event_CreateIdWithRefCounting("SignalStrengthIndEvent");
+    SignalStrengthIndPool = le_mem_CreatePool("SignalStrengthIndPool",
+                                              sizeof(pa_mrc_SignalStrengthIndication_t));
+
+    CellInfoPool = le_mem_CreatePool("CellInfoPool", sizeof(pa_mrc_CellInfo_t));
+    le_mem_ExpandPool(CellInfoPool, PA_CELLSIMU_MAX_NEIGHBORS);
+
+    pa_radioSimu_Init();
+    pa_cellSimu_Init();
+    pa_radioSimu_SetSampleHandler(RadioSampleHandler);
+    pa_regSimu_Init();
+    pa_regSimu_SetEventHandler(RegEventHandler);
 
     return LE_OK;
 }
@@ -1262,7 +3223,16 @@ le_event_HandlerRef_t pa_mrc_AddNetworkRejectIndHandler
                                                                ///< the handler.
 )
 {
-    return NULL;
+    le_event_HandlerRef_t handlerRef;
+
+    LE_ASSERT(networkRejectIndHandler != NULL);
+
+    handlerRef = le_event_AddHandler("NetworkRejectIndHandler",
+                                     NetworkRejectIndEventId,
+                                     (le_event_HandlerFunc_t) networkRejectIndHandler);
+    le_event_SetContextPtr(handlerRef, contextPtr);
+
+    return handlerRef;
 }
 
 //--------------------------------------------------------------------------------------------------
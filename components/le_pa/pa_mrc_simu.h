@@ -15,6 +15,67 @@
 #define PA_SIMU_MRC_DEFAULT_MCC     "01"
 #define PA_SIMU_MRC_DEFAULT_MNC     "001"
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the operator names of the simulated PLMN table, including the terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_MRCSIMU_NETWORK_NAME_BYTES   32
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the completion handler of an asynchronous network scan. The handler owns the
+ * results, and deletes them with pa_mrc_DeleteScanInformation().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_mrcSimu_ScanHandlerFunc_t)
+(
+    le_result_t    result,                  ///< [IN] LE_OK, or LE_NOT_POSSIBLE if the radio was
+                                            ///<      turned off during the scan
+    le_dls_List_t* scanInformationListPtr,  ///< [IN] List of pa_mrc_ScanInformation_t
+    void*          contextPtr               ///< [IN] Context of the handler
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength indication statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t sampleCount;       ///< Radio environment samples evaluated
+    uint64_t indicationCount;   ///< Signal strength indications reported
+}
+pa_mrcSimu_SignalIndStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cost of a polled function.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t nsPerCall;         ///< Time per call in nanoseconds
+    double   allocsPerCall;     ///< Pool allocations per call
+}
+pa_mrcSimu_CallCost_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Result of the polling benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_mrcSimu_CallCost_t signalStrength;   ///< pa_mrc_GetSignalStrength()
+    pa_mrcSimu_CallCost_t currentNetwork;   ///< pa_mrc_GetCurrentNetwork()
+    pa_mrcSimu_CallCost_t networkScan;      ///< pa_mrc_PerformNetworkScan() of all the RATs and
+                                            ///< pa_mrc_DeleteScanInformation()
+    pa_mrcSimu_CallCost_t neighborCells;    ///< pa_mrc_GetNeighborCellsInfo() and
+                                            ///< pa_mrc_DeleteNeighborCellsInfo()
+}
+pa_mrcSimu_PollingBenchmark_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function set the current Radio Access Technology in use.
@@ -25,6 +86,156 @@ void pa_mrcSimu_SetRadioAccessTechInUse
     le_mrc_Rat_t   rat  ///< [IN] The Radio Access Technology.
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the bands of a RAT deployed by the simulated networks: le_mrc_LteBandBitMask_t bands for
+ * LTE, le_mrc_TdScdmaBandBitMask_t bands for TD-SCDMA, le_mrc_BandBitMask_t bands otherwise. All
+ * the bands by default.
+ *
+ * A RAT is only scanned and registered on when the RAT preferences allow it and one of its
+ * network bands is allowed by both the band preferences and the band capabilities. Out of them,
+ * the registration state is searching.
+ *
+ * @return LE_BAD_PARAMETER Unknown RAT.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_SetNetworkBands
+(
+    le_mrc_Rat_t rat,       ///< [IN] RAT
+    uint64_t     bands      ///< [IN] Bands, in the band bit mask of the RAT
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the RATs allowed by the RAT and band preferences, the band capabilities and the network
+ * bands.
+ *
+ * @return The allowed RATs.
+ */
+//--------------------------------------------------------------------------------------------------
+le_mrc_RatBitMask_t pa_mrcSimu_GetAllowedRats
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the time between the network finding and the registration: on radio power on, on coverage
+ * recovery and on network selection, the registration state is searching during this time, then
+ * home or roaming as the selected network is the SIM home network or not. Null by default, the
+ * registration being immediate. The registration scenario of @ref pa_reg_simu forces the
+ * registration state, RAT and packet switched attachment at given times.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_SetRegistrationDelay
+(
+    uint32_t delay  ///< [IN] Registration delay in milliseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a network to the simulated PLMN table, or update it if it is already in. The table holds
+ * the home network of the default SIM, on GSM, UMTS and LTE, at start-up.
+ *
+ * @return LE_BAD_PARAMETER Invalid MCC, MNC or name.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_AddPlmn
+(
+    const char*         mccPtr,     ///< [IN] Mobile Country Code
+    const char*         mncPtr,     ///< [IN] Mobile Network Code
+    const char*         namePtr,    ///< [IN] Operator name
+    le_mrc_RatBitMask_t ratMask     ///< [IN] RATs provided by the network
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove all the networks of the simulated PLMN table.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_ClearPlmns
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the scan duration of a RAT: pa_mrc_PerformNetworkScan() blocks for the durations of the
+ * scanned RATs, pa_mrcSimu_PerformNetworkScanAsync() reports its results after them. Null by
+ * default.
+ *
+ * @return LE_BAD_PARAMETER Unknown RAT.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_SetScanDuration
+(
+    le_mrc_Rat_t rat,       ///< [IN] RAT
+    uint32_t     duration   ///< [IN] Scan duration in milliseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Perform a network scan without blocking the caller: the RATs are scanned one after the other,
+ * each one during its scan duration, and the handler is called with the results from the event
+ * loop of the caller.
+ *
+ * @return LE_NOT_POSSIBLE  The radio is off.
+ * @return LE_BUSY          A scan is already in progress.
+ * @return LE_OK            The scan is started.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_PerformNetworkScanAsync
+(
+    le_mrc_RatBitMask_t          ratMask,       ///< [IN] The network mask
+    pa_mrcSimu_ScanHandlerFunc_t handlerPtr,    ///< [IN] Completion handler
+    void*                        contextPtr     ///< [IN] Context of the handler
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the signal strength indication statistics: samples of the radio scenario evaluated against
+ * the thresholds and delta, and indications reported.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_GetSignalIndStats
+(
+    pa_mrcSimu_SignalIndStats_t* statsPtr   ///< [OUT] Statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the signal strength indication statistics.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_mrcSimu_ResetSignalIndStats
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the cost of the functions polled by the applications: the signal strength, the current
+ * network, a scan of all the RATs and the deletion of its results, and the neighbouring cells and
+ * their deletion. The scan durations are ignored during the measurement.
+ *
+ * @return LE_BAD_PARAMETER The number of calls is null.
+ * @return LE_NOT_POSSIBLE  The radio is off.
+ * @return LE_BUSY          An asynchronous scan is in progress.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_mrcSimu_RunPollingBenchmark
+(
+    uint32_t                        callCount,  ///< [IN] Number of calls of each function
+    pa_mrcSimu_PollingBenchmark_t*  resultPtr   ///< [OUT] Cost of each function
+);
+
 le_result_t mrc_simu_Init
 (
     void
@@ -0,0 +1,718 @@
+/**
+ * @file pa_radio_simu.c
+ *
+ * Radio environment of the simulated modem.
+ *
+ * The scenario is a list of segments played back by a timer: each expiry samples the signal level
+ * of the current segment, with its fading, and derives the metrics of the serving RAT from it. The
+ * metrics are computed once per sample and kept, so that polling them costs nothing. A cursor
+ * keeps the current segment, so that sampling doesn't walk the list from its head.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_radio_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of segments preallocated in the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SEGMENT_POOL_SIZE       64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default seed of the fast fading.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SEED            0x6C8E9CF5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Noise floor of the receiver over a 10 MHz LTE channel (9 MHz occupied, 7 dB noise figure), and
+ * number of resource blocks of this channel, in dBm.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LTE_NOISE_FLOOR         -97.5
+#define LTE_RESOURCE_BLOCKS     50
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment of the scenario.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;             ///< Link in the segment list of the scenario
+    uint32_t      duration;         ///< Duration in milliseconds
+    le_mrc_Rat_t  rat;              ///< Serving RAT, LE_MRC_RAT_UNKNOWN for a coverage hole
+    int32_t       startLevel;       ///< Signal level at the segment start in dBm
+    int32_t       endLevel;         ///< Signal level at the segment end in dBm
+    uint32_t      fadingDepth;      ///< Fading depth in dB
+    uint32_t      fadingPeriod;     ///< Period of the slow fading in milliseconds
+}
+Segment_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the segments.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t SegmentPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segments of the scenario, and their total duration in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t SegmentList = LE_DLS_LIST_INIT;
+static uint64_t ScenarioDuration;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Segment of the last sample, and its start time from the scenario start in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static Segment_t* CursorPtr;
+static uint64_t CursorStartTime;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loop the scenario playback.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool Loop;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample timer, and relative time of the scenario start.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t SampleTimerRef;
+static le_clk_Time_t StartTime;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Last sample of the playback.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_radioSimu_Sample_t Sample;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called on each sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_radioSimu_SampleHandlerFunc_t SampleHandlerPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the random generator of the fast fading.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RandomState = DEFAULT_SEED;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Draw a uniform number in ]0, 1[.
+ *
+ * @return The number.
+ */
+//--------------------------------------------------------------------------------------------------
+static double DrawUniform
+(
+    void
+)
+{
+    // xorshift32
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return (RandomState + 0.5) / 4294967296.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bound a value.
+ *
+ * @return The bounded value.
+ */
+//--------------------------------------------------------------------------------------------------
+static double Bound
+(
+    double value,       ///< [IN] Value
+    double min,         ///< [IN] Lower bound
+    double max          ///< [IN] Upper bound
+)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Ec/Io of a CDMA carrier: the pilot is 3 dB below the carrier when the signal is strong,
+ * and sinks in the noise when the signal is weak.
+ *
+ * @return The Ec/Io in dB.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetEcio
+(
+    double level        ///< [IN] Signal level in dBm
+)
+{
+    return Bound(-3.0 - 0.6 * (-90.0 - level), -24.0, -3.0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the segment of the scenario at a time, and move the cursor to it.
+ *
+ * @return The segment.
+ */
+//--------------------------------------------------------------------------------------------------
+static Segment_t* GetSegment
+(
+    uint64_t* timePtr   ///< [IN/OUT] Time from the scenario start, in the scenario when looping
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    if (Loop)
+    {
+        *timePtr %= ScenarioDuration;
+    }
+
+    if ((NULL == CursorPtr) || (*timePtr < CursorStartTime))
+    {
+        CursorPtr = CONTAINER_OF(le_dls_Peek(&SegmentList), Segment_t, link);
+        CursorStartTime = 0;
+    }
+
+    while ((*timePtr >= CursorStartTime + CursorPtr->duration)
+           && (NULL != (linkPtr = le_dls_PeekNext(&SegmentList, &CursorPtr->link))))
+    {
+        CursorStartTime += CursorPtr->duration;
+        CursorPtr = CONTAINER_OF(linkPtr, Segment_t, link);
+    }
+
+    return CursorPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample the scenario.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleScenario
+(
+    uint64_t time   ///< [IN] Time from the scenario start in milliseconds
+)
+{
+    Segment_t* segmentPtr = GetSegment(&time);
+    double     progress = Bound((double)(time - CursorStartTime) / segmentPtr->duration, 0.0, 1.0);
+    double     level = segmentPtr->startLevel
+                       + (segmentPtr->endLevel - segmentPtr->startLevel) * progress;
+
+    if (segmentPtr->fadingDepth)
+    {
+        double halfDepth = segmentPtr->fadingDepth / 2.0;
+
+        // Slow fading, then fast fading: power of a Rayleigh channel in dB.
+        level += halfDepth * sin(2 * M_PI * time / segmentPtr->fadingPeriod);
+        level += Bound(10 * log10(-log(DrawUniform())), -halfDepth, halfDepth);
+    }
+
+    Sample.time = time;
+    Sample.rat = segmentPtr->rat;
+    Sample.level = (int32_t)lround(level);
+    Sample.inCoverage = (Sample.level >= pa_radioSimu_GetSensitivity(Sample.rat));
+    pa_radioSimu_ComputeMetrics(Sample.rat, level, &Sample.metrics);
+    Sample.rssi = (LE_MRC_RAT_LTE == Sample.rat) ? Sample.metrics.lte.ss : Sample.level;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample timer handler: sample the scenario at the current time.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Sample timer
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+
+    SampleScenario((uint64_t)elapsed.sec * 1000 + elapsed.usec / 1000);
+
+    if (SampleHandlerPtr)
+    {
+        SampleHandlerPtr(&Sample);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_radio simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_Init
+(
+    void
+)
+{
+    SegmentPool = le_mem_CreatePool("RadioSegmentPool", sizeof(Segment_t));
+    le_mem_ExpandPool(SegmentPool, SEGMENT_POOL_SIZE);
+
+    SampleTimerRef = le_timer_Create("RadioSampleTimer");
+    le_timer_SetHandler(SampleTimerRef, SampleTimerHandler);
+    le_timer_SetRepeat(SampleTimerRef, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a segment to the scenario.
+ *
+ * @return LE_BAD_PARAMETER The duration is null, or the fading has a depth but no period.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_AddSegment
+(
+    uint32_t     duration,      ///< [IN] Duration in milliseconds
+    le_mrc_Rat_t rat,           ///< [IN] Serving RAT, LE_MRC_RAT_UNKNOWN for a coverage hole
+    int32_t      startLevel,    ///< [IN] Signal level at the segment start in dBm
+    int32_t      endLevel,      ///< [IN] Signal level at the segment end in dBm
+    uint32_t     fadingDepth,   ///< [IN] Fading depth in dB, 0 for no fading
+    uint32_t     fadingPeriod   ///< [IN] Period of the slow fading in milliseconds
+)
+{
+    Segment_t* segmentPtr;
+
+    if ((0 == duration) || (fadingDepth && (0 == fadingPeriod)))
+    {
+        LE_ERROR("Invalid segment: %"PRIu32" ms, fading %"PRIu32" dB/%"PRIu32" ms",
+                 duration, fadingDepth, fadingPeriod);
+        return LE_BAD_PARAMETER;
+    }
+
+    segmentPtr = le_mem_ForceAlloc(SegmentPool);
+    segmentPtr->link = LE_DLS_LINK_INIT;
+    segmentPtr->duration = duration;
+    segmentPtr->rat = rat;
+    segmentPtr->startLevel = startLevel;
+    segmentPtr->endLevel = endLevel;
+    segmentPtr->fadingDepth = fadingDepth;
+    segmentPtr->fadingPeriod = fadingPeriod;
+
+    le_dls_Queue(&SegmentList, &segmentPtr->link);
+    ScenarioDuration += duration;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the segments of a scenario file to the scenario.
+ *
+ * @return LE_NOT_FOUND     The file can't be opened.
+ * @return LE_FORMAT_ERROR  The file holds no valid segment.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_LoadScenario
+(
+    const char* pathPtr     ///< [IN] Scenario file path
+)
+{
+    FILE*    filePtr;
+    uint32_t segmentCount = 0;
+    uint32_t lineNumber = 0;
+    char*    linePtr = NULL;
+    size_t   lineSize = 0;
+
+    LE_ASSERT(pathPtr);
+
+    filePtr = fopen(pathPtr, "r");
+    if (NULL == filePtr)
+    {
+        LE_ERROR("Cannot open %s: %m", pathPtr);
+        return LE_NOT_FOUND;
+    }
+
+    while (getline(&linePtr, &lineSize, filePtr) > 0)
+    {
+        char*        savePtr;
+        char*        fieldPtr[6] = { NULL };
+        char*        endPtr;
+        size_t       fieldCount = 0;
+        double       value[NUM_ARRAY_MEMBERS(fieldPtr)] = { 0 };
+        le_mrc_Rat_t rat;
+        size_t       i;
+
+        lineNumber++;
+        if (('#' == linePtr[strspn(linePtr, " \t")]) || ('\0' == linePtr[strspn(linePtr, " \t\r\n")]))
+        {
+            continue;
+        }
+
+        for (fieldPtr[0] = strtok_r(linePtr, ",;\r\n", &savePtr);
+             NULL != fieldPtr[fieldCount];
+             fieldPtr[fieldCount] = strtok_r(NULL, ",;\r\n", &savePtr))
+        {
+            if (++fieldCount == NUM_ARRAY_MEMBERS(fieldPtr))
+            {
+                break;
+            }
+        }
+        if (fieldCount < 3)
+        {
+            LE_WARN("Line %"PRIu32": missing fields", lineNumber);
+            continue;
+        }
+
+        value[0] = strtod(fieldPtr[0], &endPtr);
+        if ((endPtr == fieldPtr[0]) || (value[0] <= 0))
+        {
+            // Header line
+            continue;
+        }
+        if (LE_OK != pa_radioSimu_ParseRat(fieldPtr[1], &rat))
+        {
+            LE_WARN("Line %"PRIu32": unknown RAT '%s'", lineNumber, fieldPtr[1]);
+            continue;
+        }
+        for (i = 2; i < fieldCount; i++)
+        {
+            value[i] = strtod(fieldPtr[i], &endPtr);
+            if (endPtr == fieldPtr[i])
+            {
+                break;
+            }
+        }
+        if (i < fieldCount)
+        {
+            LE_WARN("Line %"PRIu32": invalid field %zu", lineNumber, i + 1);
+            continue;
+        }
+        if (fieldCount < 4)
+        {
+            value[3] = value[2];
+        }
+
+        if (LE_OK == pa_radioSimu_AddSegment((uint32_t)lround(value[0] * 1000), rat,
+                                             (int32_t)lround(value[2]), (int32_t)lround(value[3]),
+                                             (value[4] > 0) ? (uint32_t)lround(value[4]) : 0,
+                                             (value[5] > 0) ? (uint32_t)lround(value[5] * 1000) : 0))
+        {
+            segmentCount++;
+        }
+    }
+
+    free(linePtr);
+    fclose(filePtr);
+
+    if (0 == segmentCount)
+    {
+        LE_ERROR("No valid segment in %s", pathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    LE_INFO("%"PRIu32" segments loaded from %s", segmentCount, pathPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the segments of the scenario, and stop its playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_ClearScenario
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    pa_radioSimu_Stop();
+
+    while (NULL != (linkPtr = le_dls_Pop(&SegmentList)))
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, Segment_t, link));
+    }
+    ScenarioDuration = 0;
+    CursorPtr = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loop the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_SetLoop
+(
+    bool loop   ///< [IN] Loop the playback
+)
+{
+    Loop = loop;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Seed the fast fading, to replay the same signal levels.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_SetSeed
+(
+    uint32_t seed   ///< [IN] Seed, not null
+)
+{
+    RandomState = (0 == seed) ? DEFAULT_SEED : seed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the scenario playback from its first segment.
+ *
+ * @return LE_NOT_FOUND     The scenario is empty.
+ * @return LE_BAD_PARAMETER The sample period is null.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_Start
+(
+    uint32_t samplePeriod   ///< [IN] Sample period in milliseconds
+)
+{
+    if (le_dls_IsEmpty(&SegmentList))
+    {
+        LE_ERROR("No radio scenario");
+        return LE_NOT_FOUND;
+    }
+    if (0 == samplePeriod)
+    {
+        LE_ERROR("Null sample period");
+        return LE_BAD_PARAMETER;
+    }
+
+    LE_INFO("Radio scenario of %"PRIu64" ms started, sampled every %"PRIu32" ms",
+            ScenarioDuration, samplePeriod);
+
+    le_timer_Stop(SampleTimerRef);
+    le_timer_SetMsInterval(SampleTimerRef, samplePeriod);
+
+    StartTime = le_clk_GetRelativeTime();
+    CursorPtr = NULL;
+    SampleScenario(0);
+    le_timer_Start(SampleTimerRef);
+
+    if (SampleHandlerPtr)
+    {
+        SampleHandlerPtr(&Sample);
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_Stop
+(
+    void
+)
+{
+    if (le_timer_IsRunning(SampleTimerRef))
+    {
+        le_timer_Stop(SampleTimerRef);
+        LE_INFO("Radio scenario stopped");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the last sample of the scenario playback.
+ *
+ * @return The sample, NULL if the scenario is not played back.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_radioSimu_Sample_t* pa_radioSimu_GetSample
+(
+    void
+)
+{
+    return le_timer_IsRunning(SampleTimerRef) ? &Sample : NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the handler called on each sample of the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_SetSampleHandler
+(
+    pa_radioSimu_SampleHandlerFunc_t handlerPtr     ///< [IN] Handler, NULL for none
+)
+{
+    SampleHandlerPtr = handlerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sensitivity of a RAT.
+ *
+ * @return The sensitivity in dBm, INT32_MAX for an unknown RAT.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t pa_radioSimu_GetSensitivity
+(
+    le_mrc_Rat_t rat    ///< [IN] RAT
+)
+{
+    switch (rat)
+    {
+        case LE_MRC_RAT_GSM:
+            return -108;
+        case LE_MRC_RAT_UMTS:
+        case LE_MRC_RAT_TDSCDMA:
+            return -112;
+        case LE_MRC_RAT_LTE:
+            // RSRP of -126 dBm
+            return -98;
+        case LE_MRC_RAT_CDMA:
+            return -110;
+        default:
+            return INT32_MAX;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the signal metrics of a RAT for a signal level.
+ *
+ * Error rates are the RxQual (0 to 7) on GSM, and the BLER in percent on the other RATs. Ec/Io,
+ * RSRP, RSRQ and SNR are given in 0.1 dB or 0.1 dBm.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_ComputeMetrics
+(
+    le_mrc_Rat_t            rat,        ///< [IN] RAT
+    double                  level,      ///< [IN] Signal level in dBm
+    pa_mrc_SignalMetrics_t* metricsPtr  ///< [OUT] Signal metrics
+)
+{
+    double ecio;
+    double rsrp;
+    double rssi;
+    double snr;
+
+    memset(metricsPtr, 0, sizeof(*metricsPtr));
+    metricsPtr->rat = rat;
+
+    switch (rat)
+    {
+        case LE_MRC_RAT_GSM:
+            metricsPtr->gsm.ss = (int32_t)lround(level);
+            metricsPtr->gsm.er = (uint32_t)Bound(floor((-95.0 - level) / 2.0), 0, 7);
+            break;
+
+        case LE_MRC_RAT_UMTS:
+        case LE_MRC_RAT_TDSCDMA:
+            ecio = GetEcio(level);
+            metricsPtr->umts.ss = (int32_t)lround(level);
+            metricsPtr->umts.ecio = (int32_t)lround(ecio * 10);
+            metricsPtr->umts.rscp = (int32_t)lround(level + ecio);
+            // Spreading gain of the TD-SCDMA midamble
+            metricsPtr->umts.sinr = (LE_MRC_RAT_TDSCDMA == rat) ? (int32_t)lround(ecio + 16) : 0;
+            metricsPtr->umts.er = (uint32_t)Bound(lround((-12.0 - ecio) * 10), 0, 100);
+            break;
+
+        case LE_MRC_RAT_LTE:
+            // RSSI over the whole channel, noise included: RSRQ and SNR fall with the signal.
+            rsrp = level - 10 * log10(LTE_RESOURCE_BLOCKS * 12);
+            rssi = 10 * log10(pow(10, level / 10) + pow(10, LTE_NOISE_FLOOR / 10));
+            snr = Bound(level - LTE_NOISE_FLOOR, -20, 30);
+            metricsPtr->lte.ss = (int32_t)lround(rssi);
+            metricsPtr->lte.rsrp = (int32_t)lround(rsrp * 10);
+            metricsPtr->lte.rsrq = (int32_t)lround(Bound(10 * log10(LTE_RESOURCE_BLOCKS) + rsrp - rssi,
+                                                         -20, -3) * 10);
+            metricsPtr->lte.snr = (int32_t)lround(snr * 10);
+            metricsPtr->lte.er = (uint32_t)Bound(lround(-snr * 10), 0, 100);
+            break;
+
+        case LE_MRC_RAT_CDMA:
+            ecio = GetEcio(level);
+            metricsPtr->cdma.ss = (int32_t)lround(level);
+            metricsPtr->cdma.ecio = (int32_t)lround(ecio * 10);
+            metricsPtr->cdma.sinr = (int32_t)lround(Bound(ecio + 21, -10, 20) * 10);
+            metricsPtr->cdma.io = (int32_t)lround(level);
+            metricsPtr->cdma.er = (uint32_t)Bound(lround((-12.0 - ecio) * 10), 0, 100);
+            break;
+
+        default:
+            break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the RAT of a scenario file field.
+ *
+ * @return LE_NOT_FOUND     Unknown RAT.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_ParseRat
+(
+    const char*   fieldPtr, ///< [IN] Field
+    le_mrc_Rat_t* ratPtr    ///< [OUT] RAT
+)
+{
+    static const struct
+    {
+        const char*  namePtr;
+        le_mrc_Rat_t rat;
+    }
+    RatNames[] =
+    {
+        { "NONE",    LE_MRC_RAT_UNKNOWN },
+        { "GSM",     LE_MRC_RAT_GSM },
+        { "UMTS",    LE_MRC_RAT_UMTS },
+        { "TDSCDMA", LE_MRC_RAT_TDSCDMA },
+        { "LTE",     LE_MRC_RAT_LTE },
+        { "CDMA",    LE_MRC_RAT_CDMA },
+    };
+    size_t i;
+
+    fieldPtr += strspn(fieldPtr, " \t");
+    for (i = 0; i < NUM_ARRAY_MEMBERS(RatNames); i++)
+    {
+        size_t length = strlen(RatNames[i].namePtr);
+
+        if ((0 == strncasecmp(fieldPtr, RatNames[i].namePtr, length))
+            && ('\0' == fieldPtr[length + strspn(fieldPtr + length, " \t")]))
+        {
+            *ratPtr = RatNames[i].rat;
+            return LE_OK;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
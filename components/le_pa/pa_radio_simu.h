@@ -0,0 +1,231 @@
+/** @file pa_radio_simu.h
+ *
+ * Legato @ref pa_radio_simu include file.
+ *
+ * Radio environment of the simulated modem: a scenario of timed segments, each one giving the
+ * serving RAT, a signal level trend and its fading, is played back and sampled periodically. A
+ * segment without RAT is a coverage hole.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_RADIO_SIMU_H_INCLUDE_GUARD
+#define PA_RADIO_SIMU_H_INCLUDE_GUARD
+
+#include "pa_mrc.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal level of the radio environment without scenario, in dBm.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_RADIOSIMU_DEFAULT_LEVEL          -60
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default sample period of the scenario playback, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_RADIOSIMU_DEFAULT_SAMPLE_PERIOD  1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample of the radio environment.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t               time;        ///< Time from the scenario start in milliseconds
+    le_mrc_Rat_t           rat;         ///< Serving RAT, LE_MRC_RAT_UNKNOWN in a coverage hole
+    bool                   inCoverage;  ///< The level is above the sensitivity of the RAT
+    int32_t                level;       ///< Signal level in dBm, with fading
+    int32_t                rssi;        ///< Received signal strength of the serving RAT in dBm
+    pa_mrc_SignalMetrics_t metrics;     ///< Signal metrics of the serving RAT
+}
+pa_radioSimu_Sample_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the handler called on each sample of the scenario playback.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_radioSimu_SampleHandlerFunc_t)
+(
+    const pa_radioSimu_Sample_t* samplePtr  ///< [IN] Sample
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_radio simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a segment to the scenario. The level goes linearly from its start value to its end
+ * value during the segment, and fades around this trend: slow fading of the given period and fast
+ * fading, both bounded by the fading depth.
+ *
+ * @return LE_BAD_PARAMETER The duration is null, or the fading has a depth but no period.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_AddSegment
+(
+    uint32_t     duration,      ///< [IN] Duration in milliseconds
+    le_mrc_Rat_t rat,           ///< [IN] Serving RAT, LE_MRC_RAT_UNKNOWN for a coverage hole
+    int32_t      startLevel,    ///< [IN] Signal level at the segment start in dBm
+    int32_t      endLevel,      ///< [IN] Signal level at the segment end in dBm
+    uint32_t     fadingDepth,   ///< [IN] Fading depth in dB, 0 for no fading
+    uint32_t     fadingPeriod   ///< [IN] Period of the slow fading in milliseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the segments of a scenario file to the scenario.
+ *
+ * Lines are "duration,rat,level[,endLevel[,fadingDepth[,fadingPeriod]]]", with the durations in
+ * seconds, the levels in dBm and the depth in dB. The RAT is GSM, UMTS, TDSCDMA, LTE, CDMA or NONE
+ * for a coverage hole. Empty lines, comments (#) and a header line are skipped.
+ *
+ * @return LE_NOT_FOUND     The file can't be opened.
+ * @return LE_FORMAT_ERROR  The file holds no valid segment.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_LoadScenario
+(
+    const char* pathPtr     ///< [IN] Scenario file path
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the segments of the scenario, and stop its playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_ClearScenario
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loop the scenario playback: once its last segment ends, the scenario restarts from its first
+ * one. Otherwise the last segment goes on.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_SetLoop
+(
+    bool loop   ///< [IN] Loop the playback
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Seed the fast fading, to replay the same signal levels.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_SetSeed
+(
+    uint32_t seed   ///< [IN] Seed, not null
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the scenario playback from its first segment.
+ *
+ * @return LE_NOT_FOUND     The scenario is empty.
+ * @return LE_BAD_PARAMETER The sample period is null.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_Start
+(
+    uint32_t samplePeriod   ///< [IN] Sample period in milliseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the scenario playback. The radio environment goes back to a constant level on the RAT in
+ * use.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_Stop
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the last sample of the scenario playback.
+ *
+ * @return The sample, NULL if the scenario is not played back.
+ */
+//--------------------------------------------------------------------------------------------------
+const pa_radioSimu_Sample_t* pa_radioSimu_GetSample
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the handler called on each sample of the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_SetSampleHandler
+(
+    pa_radioSimu_SampleHandlerFunc_t handlerPtr     ///< [IN] Handler, NULL for none
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sensitivity of a RAT: the lowest signal level giving a service.
+ *
+ * @return The sensitivity in dBm, INT32_MAX for an unknown RAT.
+ */
+//--------------------------------------------------------------------------------------------------
+int32_t pa_radioSimu_GetSensitivity
+(
+    le_mrc_Rat_t rat    ///< [IN] RAT
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the signal metrics of a RAT for a signal level: GSM RSSI and RxQual, UMTS and TD-SCDMA
+ * RSSI, Ec/Io, RSCP, SINR and BLER, LTE RSSI, RSRP, RSRQ, SNR and BLER, CDMA RSSI, Ec/Io, SINR and
+ * Io.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_radioSimu_ComputeMetrics
+(
+    le_mrc_Rat_t            rat,        ///< [IN] RAT
+    double                  level,      ///< [IN] Signal level in dBm
+    pa_mrc_SignalMetrics_t* metricsPtr  ///< [OUT] Signal metrics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the RAT of a scenario file field: GSM, UMTS, TDSCDMA, LTE, CDMA, or NONE for
+ * LE_MRC_RAT_UNKNOWN, whatever the case.
+ *
+ * @return LE_NOT_FOUND     Unknown RAT.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_radioSimu_ParseRat
+(
+    const char*   fieldPtr, ///< [IN] Field
+    le_mrc_Rat_t* ratPtr    ///< [OUT] RAT
+);
+
+#endif
@@ -0,0 +1,465 @@
+/**
+ * @file pa_reg_simu.c
+ *
+ * Network registration scenario of the simulated modem.
+ *
+ * The events are kept sorted by time, and a one-shot timer is armed for the next one only: the
+ * playback costs nothing between events, however long the scenario is. A cursor keeps the next
+ * event, so that the playback doesn't walk the list from its head.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_reg_simu.h"
+#include "pa_radio_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of events preallocated in the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EVENT_POOL_SIZE         64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event of the scenario list.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t      link;        ///< Link in the event list of the scenario
+    pa_regSimu_Event_t event;       ///< Event
+}
+EventNode_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the events.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t EventPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Events of the scenario, sorted by time.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t EventList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Next event of the playback, NULL once the last event is played back.
+ */
+//--------------------------------------------------------------------------------------------------
+static EventNode_t* CursorPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event timer, relative time of the scenario start and playback state.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t EventTimerRef;
+static le_clk_Time_t StartTime;
+static bool Running;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler called on each event.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_regSimu_EventHandlerFunc_t EventHandlerPtr;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Play back the events which are due, and arm the timer for the next one.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void PlayEvents
+(
+    void
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+    uint64_t      time = (uint64_t)elapsed.sec * 1000 + elapsed.usec / 1000;
+
+    while (Running && CursorPtr && (CursorPtr->event.time <= time))
+    {
+        EventNode_t* nodePtr = CursorPtr;
+        le_dls_Link_t* linkPtr = le_dls_PeekNext(&EventList, &nodePtr->link);
+
+        // The handler may stop or clear the scenario.
+        CursorPtr = linkPtr ? CONTAINER_OF(linkPtr, EventNode_t, link) : NULL;
+
+        LE_DEBUG("Event %d at %"PRIu32" ms", nodePtr->event.type, nodePtr->event.time);
+        if (EventHandlerPtr)
+        {
+            EventHandlerPtr(&nodePtr->event);
+        }
+    }
+
+    if (!Running)
+    {
+        return;
+    }
+    if (NULL == CursorPtr)
+    {
+        Running = false;
+        LE_INFO("Registration scenario completed");
+        return;
+    }
+
+    le_timer_SetMsInterval(EventTimerRef, CursorPtr->event.time - time);
+    le_timer_Start(EventTimerRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event timer handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void EventTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Event timer
+)
+{
+    PlayEvents();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the event of a scenario file field.
+ *
+ * @return LE_NOT_FOUND     Unknown event.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseEventType
+(
+    const char*             fieldPtr,   ///< [IN] Field
+    pa_regSimu_EventType_t* typePtr     ///< [OUT] Event
+)
+{
+    static const struct
+    {
+        const char*            namePtr;
+        pa_regSimu_EventType_t type;
+    }
+    EventNames[] =
+    {
+        { "NONE",      PA_REGSIMU_EVENT_NONE },
+        { "SEARCHING", PA_REGSIMU_EVENT_SEARCHING },
+        { "HOME",      PA_REGSIMU_EVENT_HOME },
+        { "ROAMING",   PA_REGSIMU_EVENT_ROAMING },
+        { "DENIED",    PA_REGSIMU_EVENT_DENIED },
+        { "RAT",       PA_REGSIMU_EVENT_RAT },
+        { "PS_ATTACH", PA_REGSIMU_EVENT_PS_ATTACH },
+        { "PS_DETACH", PA_REGSIMU_EVENT_PS_DETACH },
+    };
+    size_t i;
+
+    fieldPtr += strspn(fieldPtr, " \t");
+    for (i = 0; i < NUM_ARRAY_MEMBERS(EventNames); i++)
+    {
+        size_t length = strlen(EventNames[i].namePtr);
+
+        if ((0 == strncasecmp(fieldPtr, EventNames[i].namePtr, length))
+            && ('\0' == fieldPtr[length + strspn(fieldPtr + length, " \t")]))
+        {
+            *typePtr = EventNames[i].type;
+            return LE_OK;
+        }
+    }
+
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_reg simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_Init
+(
+    void
+)
+{
+    EventPool = le_mem_CreatePool("RegEventPool", sizeof(EventNode_t));
+    le_mem_ExpandPool(EventPool, EVENT_POOL_SIZE);
+
+    EventTimerRef = le_timer_Create("RegEventTimer");
+    le_timer_SetHandler(EventTimerRef, EventTimerHandler);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an event to the scenario.
+ *
+ * @return LE_BAD_PARAMETER The RAT of a PA_REGSIMU_EVENT_RAT event is unknown, or the event type is
+ *                          invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_regSimu_AddEvent
+(
+    const pa_regSimu_Event_t* eventPtr  ///< [IN] Event
+)
+{
+    EventNode_t*   nodePtr;
+    le_dls_Link_t* linkPtr;
+
+    LE_ASSERT(eventPtr);
+
+    if ((eventPtr->type > PA_REGSIMU_EVENT_PS_DETACH)
+        || ((PA_REGSIMU_EVENT_RAT == eventPtr->type)
+            && (INT32_MAX == pa_radioSimu_GetSensitivity(eventPtr->rat))))
+    {
+        LE_ERROR("Invalid event %d", eventPtr->type);
+        return LE_BAD_PARAMETER;
+    }
+
+    nodePtr = le_mem_ForceAlloc(EventPool);
+    nodePtr->link = LE_DLS_LINK_INIT;
+    nodePtr->event = *eventPtr;
+
+    // Scenarios are mostly written in time order: look for the place from the tail.
+    for (linkPtr = le_dls_PeekTail(&EventList);
+         linkPtr && (CONTAINER_OF(linkPtr, EventNode_t, link)->event.time > eventPtr->time);
+         linkPtr = le_dls_PeekPrev(&EventList, linkPtr))
+    {
+    }
+
+    if (linkPtr)
+    {
+        le_dls_AddAfter(&EventList, linkPtr, &nodePtr->link);
+    }
+    else
+    {
+        le_dls_Stack(&EventList, &nodePtr->link);
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the events of a scenario file to the scenario.
+ *
+ * @return LE_NOT_FOUND     The file can't be opened.
+ * @return LE_FORMAT_ERROR  The file holds no valid event.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_regSimu_LoadScenario
+(
+    const char* pathPtr     ///< [IN] Scenario file path
+)
+{
+    FILE*    filePtr;
+    uint32_t eventCount = 0;
+    uint32_t lineNumber = 0;
+    char*    linePtr = NULL;
+    size_t   lineSize = 0;
+
+    LE_ASSERT(pathPtr);
+
+    filePtr = fopen(pathPtr, "r");
+    if (NULL == filePtr)
+    {
+        LE_ERROR("Cannot open %s: %m", pathPtr);
+        return LE_NOT_FOUND;
+    }
+
+    while (getline(&linePtr, &lineSize, filePtr) > 0)
+    {
+        char*              savePtr;
+        char*              fieldPtr[4] = { NULL };
+        char*              endPtr;
+        size_t             fieldCount = 0;
+        double             time;
+        pa_regSimu_Event_t event;
+
+        lineNumber++;
+        if (('#' == linePtr[strspn(linePtr, " \t")]) || ('\0' == linePtr[strspn(linePtr, " \t\r\n")]))
+        {
+            continue;
+        }
+
+        for (fieldPtr[0] = strtok_r(linePtr, ",;\r\n", &savePtr);
+             NULL != fieldPtr[fieldCount];
+             fieldPtr[fieldCount] = strtok_r(NULL, ",;\r\n", &savePtr))
+        {
+            if (++fieldCount == NUM_ARRAY_MEMBERS(fieldPtr))
+            {
+                break;
+            }
+        }
+        if (fieldCount < 2)
+        {
+            LE_WARN("Line %"PRIu32": missing fields", lineNumber);
+            continue;
+        }
+
+        time = strtod(fieldPtr[0], &endPtr);
+        if (endPtr == fieldPtr[0])
+        {
+            // Header line
+            continue;
+        }
+        if ((time < 0) || (time * 1000 > UINT32_MAX))
+        {
+            LE_WARN("Line %"PRIu32": invalid time", lineNumber);
+            continue;
+        }
+
+        memset(&event, 0, sizeof(event));
+        event.time = (uint32_t)lround(time * 1000);
+        if (LE_OK != ParseEventType(fieldPtr[1], &event.type))
+        {
+            LE_WARN("Line %"PRIu32": unknown event '%s'", lineNumber, fieldPtr[1]);
+            continue;
+        }
+        if ((PA_REGSIMU_EVENT_RAT == event.type)
+            && ((fieldCount < 3) || (LE_OK != pa_radioSimu_ParseRat(fieldPtr[2], &event.rat))))
+        {
+            LE_WARN("Line %"PRIu32": missing or unknown RAT", lineNumber);
+            continue;
+        }
+        if (((PA_REGSIMU_EVENT_HOME == event.type) || (PA_REGSIMU_EVENT_ROAMING == event.type)
+             || (PA_REGSIMU_EVENT_DENIED == event.type))
+            && (fieldCount > 2)
+            && ((fieldCount < 4) || (1 != sscanf(fieldPtr[2], " %3[0-9]", event.mcc))
+                || (1 != sscanf(fieldPtr[3], " %3[0-9]", event.mnc))))
+        {
+            LE_WARN("Line %"PRIu32": invalid network", lineNumber);
+            continue;
+        }
+
+        if (LE_OK == pa_regSimu_AddEvent(&event))
+        {
+            eventCount++;
+        }
+    }
+
+    free(linePtr);
+    fclose(filePtr);
+
+    if (0 == eventCount)
+    {
+        LE_ERROR("No valid event in %s", pathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    LE_INFO("%"PRIu32" events loaded from %s", eventCount, pathPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the events of the scenario, and stop its playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_ClearScenario
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    pa_regSimu_Stop();
+
+    while (NULL != (linkPtr = le_dls_Pop(&EventList)))
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, EventNode_t, link));
+    }
+    CursorPtr = NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the scenario playback from its first event.
+ *
+ * @return LE_NOT_FOUND     The scenario is empty.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_regSimu_Start
+(
+    void
+)
+{
+    if (le_dls_IsEmpty(&EventList))
+    {
+        LE_ERROR("No registration scenario");
+        return LE_NOT_FOUND;
+    }
+
+    LE_INFO("Registration scenario of %zu events started", le_dls_NumLinks(&EventList));
+
+    le_timer_Stop(EventTimerRef);
+
+    StartTime = le_clk_GetRelativeTime();
+    CursorPtr = CONTAINER_OF(le_dls_Peek(&EventList), EventNode_t, link);
+    Running = true;
+    PlayEvents();
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_Stop
+(
+    void
+)
+{
+    if (Running)
+    {
+        le_timer_Stop(EventTimerRef);
+        Running = false;
+        LE_INFO("Registration scenario stopped");
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the scenario is played back.
+ *
+ * @return true until the last event is played back or the playback is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_regSimu_IsRunning
+(
+    void
+)
+{
+    return Running;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the handler called on each event of the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_SetEventHandler
+(
+    pa_regSimu_EventHandlerFunc_t handlerPtr    ///< [IN] Handler, NULL for none
+)
+{
+    EventHandlerPtr = handlerPtr;
+}
@@ -0,0 +1,169 @@
+/** @file pa_reg_simu.h
+ *
+ * Legato @ref pa_reg_simu include file.
+ *
+ * Network registration scenario of the simulated modem: a script of timestamped network events
+ * (coverage loss, registration, rejection, RAT change, packet switched attach and detach) is
+ * played back, each event being given to a handler at its time.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_REG_SIMU_H_INCLUDE_GUARD
+#define PA_REG_SIMU_H_INCLUDE_GUARD
+
+#include "pa_mrc.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network events of the scenario.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_REGSIMU_EVENT_NONE,          ///< Not registered and not searching
+    PA_REGSIMU_EVENT_SEARCHING,     ///< Coverage lost, searching for a network
+    PA_REGSIMU_EVENT_HOME,          ///< Registered on the home network
+    PA_REGSIMU_EVENT_ROAMING,       ///< Registered on a visited network
+    PA_REGSIMU_EVENT_DENIED,        ///< Registration rejected by the network
+    PA_REGSIMU_EVENT_RAT,           ///< Serving RAT changed
+    PA_REGSIMU_EVENT_PS_ATTACH,     ///< Packet switched domain attached
+    PA_REGSIMU_EVENT_PS_DETACH      ///< Packet switched domain detached
+}
+pa_regSimu_EventType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Network event of the scenario.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t               time;                    ///< Time from the scenario start in
+                                                    ///< milliseconds
+    pa_regSimu_EventType_t type;                    ///< Event
+    le_mrc_Rat_t           rat;                     ///< New RAT of PA_REGSIMU_EVENT_RAT
+    char                   mcc[LE_MRC_MCC_BYTES];   ///< Registered network of
+                                                    ///< PA_REGSIMU_EVENT_HOME and
+                                                    ///< PA_REGSIMU_EVENT_ROAMING, rejecting
+                                                    ///< network of PA_REGSIMU_EVENT_DENIED,
+                                                    ///< empty for the default network
+    char                   mnc[LE_MRC_MNC_BYTES];   ///< Network of the event, like mcc
+}
+pa_regSimu_Event_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype for the handler called on each event of the scenario playback.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_regSimu_EventHandlerFunc_t)
+(
+    const pa_regSimu_Event_t* eventPtr  ///< [IN] Event
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_reg simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an event to the scenario. Events are played back in time order, and events of the same time
+ * in the order they were added.
+ *
+ * @return LE_BAD_PARAMETER The RAT of a PA_REGSIMU_EVENT_RAT event is unknown, or the event type is
+ *                          invalid.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_regSimu_AddEvent
+(
+    const pa_regSimu_Event_t* eventPtr  ///< [IN] Event
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the events of a scenario file to the scenario.
+ *
+ * Lines are "time,event[,arguments]", with the time from the scenario start in seconds. The
+ * events are NONE, SEARCHING, HOME[,mcc,mnc], ROAMING[,mcc,mnc], DENIED[,mcc,mnc], RAT,rat (GSM,
+ * UMTS, TDSCDMA, LTE or CDMA), PS_ATTACH and PS_DETACH. Without network, HOME registers on the home
+ * network, ROAMING on the visited network selected in automatic mode and DENIED is rejected by the
+ * selected network. Empty lines, comments (#) and a header line are skipped.
+ *
+ * @return LE_NOT_FOUND     The file can't be opened.
+ * @return LE_FORMAT_ERROR  The file holds no valid event.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_regSimu_LoadScenario
+(
+    const char* pathPtr     ///< [IN] Scenario file path
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the events of the scenario, and stop its playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_ClearScenario
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the scenario playback from its first event.
+ *
+ * @return LE_NOT_FOUND     The scenario is empty.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_regSimu_Start
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_Stop
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether the scenario is played back.
+ *
+ * @return true until the last event is played back or the playback is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_regSimu_IsRunning
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the handler called on each event of the scenario playback.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_regSimu_SetEventHandler
+(
+    pa_regSimu_EventHandlerFunc_t handlerPtr    ///< [IN] Handler, NULL for none
+);
+
+#endif
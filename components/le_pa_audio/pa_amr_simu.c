@@ -3,6 +3,11 @@
  *
  * This file contains the source code of the low level Audio API for AMR playback / capture
  *
+ * The AMR files use the storage format of RFC 4867 (section 5): a magic number followed by
+ * frames made of a table of contents byte and the speech bits of the frame type. The codec is
+ * simulated: each frame carries a coarse subsampling of the 20 ms of PCM it replaces, so the
+ * decoded signal follows the encoded one with a loss depending on the bitrate.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -11,11 +16,319 @@
 #include "le_audio_local.h"
 #include "pa_audio.h"
 #include "pa_amr.h"
+#include "pa_amr_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic numbers of the AMR storage format.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_NB_MAGIC            "#!AMR\n"
+#define AMR_WB_MAGIC            "#!AMR-WB\n"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Table of contents byte: frame type and quality bit.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TOC_FT_SHIFT            3
+#define TOC_FT_MASK             0x0F
+#define TOC_Q_BIT               0x04
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Special frame types.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_NB_FT_SID           8
+#define AMR_WB_FT_SID           9
+#define AMR_FT_NO_DATA          15
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PCM frame: 20 ms of 16-bit mono samples at 8 kHz (NB) or 16 kHz (WB).
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_NB_SAMPLE_RATE      8000
+#define AMR_WB_SAMPLE_RATE      16000
+#define AMR_NB_FRAME_SAMPLES    160
+#define AMR_WB_FRAME_SAMPLES    320
+#define AMR_MAX_FRAME_SAMPLES   AMR_WB_FRAME_SAMPLES
+#define AMR_MAX_FRAME_SIZE      61              ///< Largest frame, TOC byte included
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of frames processed per decoding call, and size of the file read buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_FRAMES_PER_BATCH    10
+#define AMR_READ_BUFFER_SIZE    4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * In DTX mode, a frame whose samples all stay below this level is silence. A SID frame is sent
+ * every AMR_SID_PERIOD silent frames, NO_DATA frames are sent in between.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_DTX_SILENCE_LEVEL   256
+#define AMR_SID_PERIOD          8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of codec contexts preallocated in the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AMR_CODEC_POOL_SIZE     2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AMR codec context, stored in the media thread context.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool      isWideband;                               ///< AMR-WB or AMR-NB
+    const uint8_t* frameSizePtr;                        ///< Speech bytes per frame type
+    uint32_t  frameSamples;                             ///< Samples per PCM frame
+    uint8_t   frameType;                                ///< Encoding frame type
+    bool      dtx;                                      ///< Encoding with DTX
+    uint32_t  silentFrames;                             ///< Consecutive silent frames (DTX)
+    int16_t   lastSample;                               ///< Last decoded sample (interpolation)
+    uint32_t  readLen;                                  ///< Bytes in the read buffer
+    uint32_t  readIndex;                                ///< Next byte to parse
+    bool      endOfFile;                                ///< No more bytes to read
+    uint32_t  pcmLen;                                   ///< Bytes of pending PCM (encoder)
+    uint8_t   pcmBuffer[AMR_MAX_FRAME_SAMPLES * 2];     ///< Pending PCM of a partial frame
+    uint8_t   readBuffer[AMR_READ_BUFFER_SIZE];         ///< File read buffer (decoder)
+}
+AmrCodec_t;
 
 //--------------------------------------------------------------------------------------------------
 //                                       Static declarations
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Speech bytes per frame type, TOC byte excluded (3GPP TS 26.101 and TS 26.201).
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint8_t AmrNbFrameSize[16] = { 12, 13, 15, 17, 19, 20, 26, 31, 5, 6, 5, 5,
+                                            0, 0, 0, 0 };
+static const uint8_t AmrWbFrameSize[16] = { 17, 23, 32, 36, 40, 46, 50, 58, 60, 5, 0, 0,
+                                            0, 0, 0, 0 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Codec context pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AmrCodecPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Codec statistics, since the initialization of the pa_amr simu.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_amrSimu_Statistics_t Statistics;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the codec context for AMR-NB or AMR-WB.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetBand
+(
+    AmrCodec_t* codecPtr,       ///< [IN] Codec context
+    bool        isWideband      ///< [IN] AMR-WB or AMR-NB
+)
+{
+    codecPtr->isWideband = isWideband;
+    codecPtr->frameSizePtr = isWideband ? AmrWbFrameSize : AmrNbFrameSize;
+    codecPtr->frameSamples = isWideband ? AMR_WB_FRAME_SAMPLES : AMR_NB_FRAME_SAMPLES;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the PCM configuration of a stream to the one of the codec.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPcmConfig
+(
+    le_audio_Stream_t* streamPtr,   ///< [IN] Stream object
+    AmrCodec_t*        codecPtr     ///< [IN] Codec context
+)
+{
+    streamPtr->samplePcmConfig.sampleRate = codecPtr->isWideband ? AMR_WB_SAMPLE_RATE :
+                                                                   AMR_NB_SAMPLE_RATE;
+    streamPtr->samplePcmConfig.channelsCount = 1;
+    streamPtr->samplePcmConfig.bitsPerSample = 16;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Refill the read buffer of the decoder, keeping the bytes not parsed yet.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void FillReadBuffer
+(
+    AmrCodec_t* codecPtr,       ///< [IN] Codec context
+    int32_t     fd              ///< [IN] AMR file
+)
+{
+    uint32_t left = codecPtr->readLen - codecPtr->readIndex;
+
+    memmove(codecPtr->readBuffer, codecPtr->readBuffer + codecPtr->readIndex, left);
+    codecPtr->readLen = left;
+    codecPtr->readIndex = 0;
+
+    while (!codecPtr->endOfFile && (codecPtr->readLen < AMR_READ_BUFFER_SIZE))
+    {
+        ssize_t len = read(fd, codecPtr->readBuffer + codecPtr->readLen,
+                           AMR_READ_BUFFER_SIZE - codecPtr->readLen);
+
+        if ((len < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+
+        Statistics.readCount++;
+
+        if (len <= 0)
+        {
+            if (len < 0)
+            {
+                LE_ERROR("AMR read error: %m");
+            }
+            codecPtr->endOfFile = true;
+        }
+        else
+        {
+            codecPtr->readLen += len;
+            Statistics.bytesRead += len;
+            // One read per call is enough when the buffer holds a whole batch
+            break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode one frame into PCM samples.
+ *
+ * Speech frames are rebuilt by linear interpolation of the samples carried by the frame. SID,
+ * NO_DATA and erroneous frames are decoded as silence.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DecodeFrame
+(
+    AmrCodec_t*    codecPtr,    ///< [IN] Codec context
+    uint8_t        toc,         ///< [IN] TOC byte
+    const uint8_t* speechPtr,   ///< [IN] Speech bytes
+    int16_t*       samplesPtr   ///< [OUT] Decoded samples
+)
+{
+    uint8_t frameType = (toc >> TOC_FT_SHIFT) & TOC_FT_MASK;
+    uint8_t sidType = codecPtr->isWideband ? AMR_WB_FT_SID : AMR_NB_FT_SID;
+    uint32_t pointCount = codecPtr->frameSizePtr[frameType];
+    uint32_t i;
+
+    if ((frameType >= sidType) || !(toc & TOC_Q_BIT) || (pointCount == 0))
+    {
+        memset(samplesPtr, 0, codecPtr->frameSamples * sizeof(int16_t));
+        codecPtr->lastSample = 0;
+        return;
+    }
+
+    // Point p is located at the end of the p-th segment of the frame
+    uint32_t start = 0;
+    int32_t from = codecPtr->lastSample;
+
+    for (i = 0; i < pointCount; i++)
+    {
+        uint32_t end = ((i + 1) * codecPtr->frameSamples) / pointCount;
+        int32_t to = (int32_t)(int8_t) speechPtr[i] * 256;
+        uint32_t span = end - start;
+        uint32_t n;
+
+        for (n = 0; n < span; n++)
+        {
+            samplesPtr[start + n] = (int16_t)(from + ((to - from) * (int32_t)(n + 1)) / (int32_t)span);
+        }
+
+        from = to;
+        start = end;
+    }
+
+    codecPtr->lastSample = (int16_t) from;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Encode one PCM frame.
+ *
+ * @return The frame length, TOC byte included.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t EncodeFrame
+(
+    AmrCodec_t*    codecPtr,    ///< [IN] Codec context
+    const int16_t* samplesPtr,  ///< [IN] PCM frame
+    uint8_t*       framePtr     ///< [OUT] AMR frame
+)
+{
+    uint8_t frameType = codecPtr->frameType;
+    uint32_t pointCount = codecPtr->frameSizePtr[frameType];
+    uint32_t i;
+
+    if (codecPtr->dtx)
+    {
+        bool isSilent = true;
+
+        for (i = 0; (i < codecPtr->frameSamples) && isSilent; i++)
+        {
+            isSilent = (abs(samplesPtr[i]) < AMR_DTX_SILENCE_LEVEL);
+        }
+
+        if (isSilent)
+        {
+            bool sendSid = ((codecPtr->silentFrames++ % AMR_SID_PERIOD) == 0);
+
+            frameType = sendSid ? (codecPtr->isWideband ? AMR_WB_FT_SID : AMR_NB_FT_SID) :
+                                  AMR_FT_NO_DATA;
+            pointCount = codecPtr->frameSizePtr[frameType];
+
+            framePtr[0] = (frameType << TOC_FT_SHIFT) | TOC_Q_BIT;
+            memset(framePtr + 1, 0, pointCount);
+            return pointCount + 1;
+        }
+
+        codecPtr->silentFrames = 0;
+    }
+
+    framePtr[0] = (frameType << TOC_FT_SHIFT) | TOC_Q_BIT;
+
+    for (i = 0; i < pointCount; i++)
+    {
+        uint32_t index = ((i + 1) * codecPtr->frameSamples) / pointCount - 1;
+
+        framePtr[1 + i] = (uint8_t)(samplesPtr[index] >> 8);
+    }
+
+    return pointCount + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start AMR decoder
@@ -31,7 +344,36 @@ le_result_t pa_amr_StartDecoder
     le_audio_MediaThreadContext_t* mediaCtxPtr   ///< [IN] Media thread context
 )
 {
-    mediaCtxPtr->bufferSize = 10;
+    AmrCodec_t* codecPtr = le_mem_ForceAlloc(AmrCodecPool);
+
+    memset(codecPtr, 0, sizeof(AmrCodec_t));
+    FillReadBuffer(codecPtr, mediaCtxPtr->fd_in);
+
+    if ((codecPtr->readLen >= strlen(AMR_WB_MAGIC)) &&
+        (memcmp(codecPtr->readBuffer, AMR_WB_MAGIC, strlen(AMR_WB_MAGIC)) == 0))
+    {
+        SetBand(codecPtr, true);
+        codecPtr->readIndex = strlen(AMR_WB_MAGIC);
+    }
+    else if ((codecPtr->readLen >= strlen(AMR_NB_MAGIC)) &&
+             (memcmp(codecPtr->readBuffer, AMR_NB_MAGIC, strlen(AMR_NB_MAGIC)) == 0))
+    {
+        SetBand(codecPtr, false);
+        codecPtr->readIndex = strlen(AMR_NB_MAGIC);
+    }
+    else
+    {
+        LE_ERROR("Not an AMR file");
+        le_mem_Release(codecPtr);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("AMR-%s decoder started", codecPtr->isWideband ? "WB" : "NB");
+
+    SetPcmConfig(streamPtr, codecPtr);
+    mediaCtxPtr->codecPtr = codecPtr;
+    mediaCtxPtr->bufferSize = AMR_FRAMES_PER_BATCH * codecPtr->frameSamples * sizeof(int16_t);
+
     return LE_OK;
 }
 
@@ -39,6 +381,9 @@ le_result_t pa_amr_StartDecoder
 /**
  *Decode AMR frames
  *
+ * Up to mediaCtxPtr->bufferSize bytes of PCM samples are decoded per call. The read length is
+ * 0 once all the frames of the file have been decoded.
+ *
  * @return LE_FAULT         Function failed.
  * @return LE_OK            Function succeeded.
  *
@@ -51,8 +396,51 @@ le_result_t pa_amr_DecodeFrames
     uint32_t*                     readLenPtr       ///< [OUT] Length of the read data
 )
 {
-    int len = read(mediaCtxPtr->fd_in, bufferOutPtr, mediaCtxPtr->bufferSize);
-    *readLenPtr = len;
+    AmrCodec_t* codecPtr = mediaCtxPtr->codecPtr;
+    uint32_t frameBytes;
+    uint32_t outLen = 0;
+
+    if (codecPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    frameBytes = codecPtr->frameSamples * sizeof(int16_t);
+
+    while ((outLen + frameBytes) <= mediaCtxPtr->bufferSize)
+    {
+        if ((codecPtr->readLen - codecPtr->readIndex) < AMR_MAX_FRAME_SIZE)
+        {
+            FillReadBuffer(codecPtr, mediaCtxPtr->fd_in);
+        }
+
+        uint32_t left = codecPtr->readLen - codecPtr->readIndex;
+
+        if (left == 0)
+        {
+            break;
+        }
+
+        uint8_t toc = codecPtr->readBuffer[codecPtr->readIndex];
+        uint32_t speechLen = codecPtr->frameSizePtr[(toc >> TOC_FT_SHIFT) & TOC_FT_MASK];
+
+        if ((1 + speechLen) > left)
+        {
+            LE_WARN("Truncated AMR frame dropped (%d bytes)", left);
+            codecPtr->readIndex = codecPtr->readLen;
+            break;
+        }
+
+        // The samples are aligned: the output buffer holds whole 16-bit samples
+        DecodeFrame(codecPtr, toc, codecPtr->readBuffer + codecPtr->readIndex + 1,
+                    (int16_t*)(bufferOutPtr + outLen));
+
+        codecPtr->readIndex += 1 + speechLen;
+        outLen += frameBytes;
+        Statistics.framesDecoded++;
+    }
+
+    *readLenPtr = outLen;
 
     return LE_OK;
 }
@@ -71,13 +459,24 @@ le_result_t pa_amr_StopDecoder
     le_audio_MediaThreadContext_t*    mediaCtxPtr    ///< [IN] Media thread context
 )
 {
-    return LE_FAULT;
+    if (mediaCtxPtr->codecPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    le_mem_Release(mediaCtxPtr->codecPtr);
+    mediaCtxPtr->codecPtr = NULL;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Start AMR encoder
  *
+ * The AMR mode and DTX of the stream select the band and the frame type. The magic number is
+ * written to the output file.
+ *
  * @return LE_FAULT         Function failed.
  * @return LE_OK            Function succeeded.
  *
@@ -89,7 +488,48 @@ le_result_t pa_amr_StartEncoder
     le_audio_MediaThreadContext_t*  mediaCtxPtr  ///< [IN] Media thread context
 )
 {
-    return LE_FAULT;
+    le_audio_AmrMode_t amrMode = streamPtr->sampleAmrConfig.amrMode;
+    AmrCodec_t* codecPtr;
+    const char* magicPtr;
+
+    if ((amrMode < LE_AUDIO_AMR_NB_4_75_KBPS) || (amrMode > LE_AUDIO_AMR_WB_23_85_KBPS))
+    {
+        LE_ERROR("Bad AMR mode %d", amrMode);
+        return LE_FAULT;
+    }
+
+    codecPtr = le_mem_ForceAlloc(AmrCodecPool);
+    memset(codecPtr, 0, sizeof(AmrCodec_t));
+
+    if (amrMode >= LE_AUDIO_AMR_WB_6_6_KBPS)
+    {
+        SetBand(codecPtr, true);
+        codecPtr->frameType = amrMode - LE_AUDIO_AMR_WB_6_6_KBPS;
+        magicPtr = AMR_WB_MAGIC;
+    }
+    else
+    {
+        SetBand(codecPtr, false);
+        codecPtr->frameType = amrMode - LE_AUDIO_AMR_NB_4_75_KBPS;
+        magicPtr = AMR_NB_MAGIC;
+    }
+    codecPtr->dtx = streamPtr->sampleAmrConfig.dtx;
+
+    if (write(mediaCtxPtr->fd_out, magicPtr, strlen(magicPtr)) != (ssize_t) strlen(magicPtr))
+    {
+        LE_ERROR("Cannot write AMR header: %m");
+        le_mem_Release(codecPtr);
+        return LE_FAULT;
+    }
+
+    LE_DEBUG("AMR-%s encoder started, frame type %d, dtx %d",
+             codecPtr->isWideband ? "WB" : "NB", codecPtr->frameType, codecPtr->dtx);
+
+    SetPcmConfig(streamPtr, codecPtr);
+    mediaCtxPtr->codecPtr = codecPtr;
+    mediaCtxPtr->bufferSize = AMR_FRAMES_PER_BATCH * codecPtr->frameSamples * sizeof(int16_t);
+
+    return LE_OK;
 }
 
 
@@ -97,6 +537,10 @@ le_result_t pa_amr_StartEncoder
 /**
  * Encode AMR frames
  *
+ * All the whole PCM frames of the input are encoded in one call, the remaining samples are kept
+ * for the next call. An AMR frame is at most 61 bytes long for 320 bytes of PCM, so the output
+ * buffer must hold inputDataLen + AMR_MAX_FRAME_SIZE bytes.
+ *
  * @return LE_FAULT         Function failed.
  * @return LE_OK            Function succeeded.
  *
@@ -111,13 +555,74 @@ le_result_t pa_amr_EncodeFrames
     uint32_t* outputDataLen                    ///< [OUT] output PCM buffer length
 )
 {
-    return LE_FAULT;
+    AmrCodec_t* codecPtr = mediaCtxPtr->codecPtr;
+    uint32_t frameBytes;
+    uint32_t outLen = 0;
+
+    if (codecPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    frameBytes = codecPtr->frameSamples * sizeof(int16_t);
+
+    // Complete the pending partial frame first
+    if (codecPtr->pcmLen)
+    {
+        uint32_t len = frameBytes - codecPtr->pcmLen;
+
+        if (len > inputDataLen)
+        {
+            len = inputDataLen;
+        }
+
+        memcpy(codecPtr->pcmBuffer + codecPtr->pcmLen, inputDataPtr, len);
+        codecPtr->pcmLen += len;
+        inputDataPtr += len;
+        inputDataLen -= len;
+
+        if (codecPtr->pcmLen < frameBytes)
+        {
+            *outputDataLen = 0;
+            return LE_OK;
+        }
+
+        outLen += EncodeFrame(codecPtr, (int16_t*) codecPtr->pcmBuffer, outputDataPtr);
+        codecPtr->pcmLen = 0;
+        Statistics.framesEncoded++;
+    }
+
+    while (inputDataLen >= frameBytes)
+    {
+        int16_t samples[AMR_MAX_FRAME_SAMPLES];
+        const int16_t* samplesPtr = (const int16_t*) inputDataPtr;
+
+        if ((uintptr_t) inputDataPtr % sizeof(int16_t))
+        {
+            memcpy(samples, inputDataPtr, frameBytes);
+            samplesPtr = samples;
+        }
+
+        outLen += EncodeFrame(codecPtr, samplesPtr, outputDataPtr + outLen);
+        inputDataPtr += frameBytes;
+        inputDataLen -= frameBytes;
+        Statistics.framesEncoded++;
+    }
+
+    memcpy(codecPtr->pcmBuffer, inputDataPtr, inputDataLen);
+    codecPtr->pcmLen = inputDataLen;
+
+    *outputDataLen = outLen;
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Stop AMR encoder
  *
+ * The samples of a pending partial frame are dropped.
+ *
  * @return LE_FAULT         Function failed.
  * @return LE_OK            Function succeeded.
  *
@@ -128,7 +633,57 @@ le_result_t pa_amr_StopEncoder
     le_audio_MediaThreadContext_t*    mediaCtxPtr    ///< [IN] Media thread context
 )
 {
-    return LE_FAULT;
+    if (mediaCtxPtr->codecPtr == NULL)
+    {
+        return LE_FAULT;
+    }
+
+    le_mem_Release(mediaCtxPtr->codecPtr);
+    mediaCtxPtr->codecPtr = NULL;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bitrate of an AMR mode.
+ *
+ * @return The bitrate in bits per second, 0 for a bad mode.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_amrSimu_GetBitrate
+(
+    le_audio_AmrMode_t amrMode      ///< [IN] AMR mode
+)
+{
+    static const uint16_t NbBitrate[] = { 4750, 5150, 5900, 6700, 7400, 7950, 10200, 12200 };
+    static const uint16_t WbBitrate[] = { 6600, 8850, 12650, 14250, 15850, 18250, 19850, 23050,
+                                          23850 };
+
+    if ((amrMode >= LE_AUDIO_AMR_NB_4_75_KBPS) && (amrMode <= LE_AUDIO_AMR_NB_12_2_KBPS))
+    {
+        return NbBitrate[amrMode - LE_AUDIO_AMR_NB_4_75_KBPS];
+    }
+    if ((amrMode >= LE_AUDIO_AMR_WB_6_6_KBPS) && (amrMode <= LE_AUDIO_AMR_WB_23_85_KBPS))
+    {
+        return WbBitrate[amrMode - LE_AUDIO_AMR_WB_6_6_KBPS];
+    }
+
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the codec statistics since the initialization of the pa_amr simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_amrSimu_GetStatistics
+(
+    pa_amrSimu_Statistics_t* statisticsPtr  ///< [OUT] Codec statistics
+)
+{
+    *statisticsPtr = Statistics;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -142,6 +697,8 @@ void pa_amrSimu_Init
     void
 )
 {
-    return;
-}
+    AmrCodecPool = le_mem_CreatePool("AmrCodecPool", sizeof(AmrCodec_t));
+    le_mem_ExpandPool(AmrCodecPool, AMR_CODEC_POOL_SIZE);
 
+    memset(&Statistics, 0, sizeof(Statistics));
+}
@@ -8,6 +8,20 @@
 #ifndef PA_AMR_SIMU_H_INCLUDE_GUARD
 #define PA_AMR_SIMU_H_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * AMR codec statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t framesDecoded;     ///< Frames decoded
+    uint32_t framesEncoded;     ///< Frames encoded
+    uint32_t readCount;         ///< read() calls on the AMR files
+    uint64_t bytesRead;         ///< Bytes read from the AMR files
+}
+pa_amrSimu_Statistics_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the pa_amr simu.
@@ -19,4 +33,27 @@ void pa_amrSimu_Init
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the bitrate of an AMR mode.
+ *
+ * @return The bitrate in bits per second, 0 for a bad mode.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_amrSimu_GetBitrate
+(
+    le_audio_AmrMode_t amrMode      ///< [IN] AMR mode
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the codec statistics since the initialization of the pa_amr simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_amrSimu_GetStatistics
+(
+    pa_amrSimu_Statistics_t* statisticsPtr  ///< [OUT] Codec statistics
+);
+
 #endif
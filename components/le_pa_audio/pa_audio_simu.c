@@ -13,6 +13,8 @@
 #include "pa_audio_simu.h"
 #include "pa_pcm_simu.h"
 #include "pa_amr_simu.h"
+#include "pa_dtmf_simu.h"
+#include "pa_dsp_simu.h"
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -32,6 +34,38 @@
                            ((X == LE_AUDIO_IF_DSP_FRONTEND_I2S_TX) ? true :\
                            ((X == LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE) ? true : false)))))
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the mix buffer of an output interface, in samples (power of two).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MIX_BUFFER_SIZE     4096
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gain of the interfaces: percentage, 100 is unity.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNITY_GAIN          100
+#define MAX_GAIN            1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mix buffer of an output interface: ring where the samples of the connected inputs are added.
+ * Each input has its own fill level past the read index; the samples past the largest fill level
+ * are not initialized yet. The inputs late compared to the other ones contribute silence.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int16_t  samples[MIX_BUFFER_SIZE];
+    uint32_t readIndex;                         ///< Free-running index of the next sample to read
+    uint32_t fill[LE_AUDIO_NUM_INTERFACES];     ///< Samples added by each input
+    uint32_t maxFill;                           ///< Initialized samples
+    uint32_t overrunCount;                      ///< Input samples dropped (buffer full)
+}
+MixBuffer_t;
+
 
 //--------------------------------------------------------------------------------------------------
 //                                       Static declarations
@@ -42,8 +76,46 @@ static char* DtmfPtr = NULL;
 static uint32_t DtmfDuration = 0;
 static uint32_t DtmfPause = 0;
 static int8_t BuildAudioPath[LE_AUDIO_NUM_INTERFACES][LE_AUDIO_NUM_INTERFACES];
-static bool   IsNoiseSuppressorEnabled = false;
-static bool   IsEchoCancellerEnabled = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Routing graph: bitmask of the input interfaces connected to each output interface, and mix
+ * buffers of the output interfaces.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RouteInputMask[LE_AUDIO_NUM_INTERFACES];
+static MixBuffer_t* MixBufferPtr[LE_AUDIO_NUM_INTERFACES];
+static le_mem_PoolRef_t MixBufferPool;
+static le_mutex_Ref_t MixerMutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gain of each interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t Gain[LE_AUDIO_NUM_INTERFACES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Effect chain of each interface, created on first use.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_dspSimu_ChainRef_t DspChain[LE_AUDIO_NUM_INTERFACES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF detector running on the modem voice RX interface, NULL when the decoder is stopped.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_dtmfSimu_DetectorRef_t DtmfDetectorRef = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Samples of the last signalling DTMFs played.
+ */
+//--------------------------------------------------------------------------------------------------
+static int16_t* SignallingDtmfSamplesPtr = NULL;
+static uint32_t SignallingDtmfCount = 0;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -65,6 +137,123 @@ static void FirstDtmfLayeredHandler
     dtmfStreamEventHandler( streamEventPtr, le_event_GetContextPtr() );
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the effect chain of an interface.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_dspSimu_ChainRef_t GetDspChain
+(
+    le_audio_If_t interface
+)
+{
+    LE_ASSERT(interface < LE_AUDIO_NUM_INTERFACES);
+
+    if (DspChain[interface] == NULL)
+    {
+        DspChain[interface] = pa_dspSimu_CreateChain();
+    }
+
+    return DspChain[interface];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable a stage of the effect chain of a stream.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SwitchDspStage
+(
+    le_audio_Stream_t* streamPtr,
+    pa_dspSimu_Stage_t stage,
+    le_onoff_t         switchOnOff
+)
+{
+    pa_dspSimu_EnableStage(GetDspChain(streamPtr->audioInterface), stage, (switchOnOff == LE_ON));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the Q15 gain of an interface.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t GetQ15Gain
+(
+    le_audio_If_t interface
+)
+{
+    int32_t gain = Gain[interface];
+
+    gain = (gain < 0) ? 0 : ((gain > MAX_GAIN) ? MAX_GAIN : gain);
+
+    return (gain * PA_DSPSIMU_UNITY_GAIN) / UNITY_GAIN;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add input samples to the mix buffer of an output interface.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MixInput
+(
+    le_audio_If_t  outputInterface,
+    le_audio_If_t  inputInterface,
+    const int16_t* samplesPtr,
+    uint32_t       count
+)
+{
+    MixBuffer_t* mixPtr = MixBufferPtr[outputInterface];
+    uint32_t start = mixPtr->fill[inputInterface];
+    uint32_t space = MIX_BUFFER_SIZE - start;
+
+    if (count > space)
+    {
+        mixPtr->overrunCount += count - space;
+        count = space;
+    }
+
+    // Silence the part of the buffer that no input has reached yet
+    while (mixPtr->maxFill < (start + count))
+    {
+        mixPtr->samples[(mixPtr->readIndex + mixPtr->maxFill) & (MIX_BUFFER_SIZE - 1)] = 0;
+        mixPtr->maxFill++;
+    }
+
+    while (count)
+    {
+        uint32_t index = (mixPtr->readIndex + start) & (MIX_BUFFER_SIZE - 1);
+        uint32_t len = MIX_BUFFER_SIZE - index;
+
+        len = (len < count) ? len : count;
+        pa_dspSimu_MixSaturate(mixPtr->samples + index, samplesPtr, len);
+
+        samplesPtr += len;
+        start += len;
+        count -= len;
+    }
+
+    mixPtr->fill[inputInterface] = start;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF detection handler: report the DTMF as a received one.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DtmfDetectionHandler
+(
+    char dtmf
+)
+{
+    LE_DEBUG("DTMF '%c' detected", dtmf);
+    pa_audioSimu_ReceiveDtmf(dtmf);
+}
+
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
 //--------------------------------------------------------------------------------------------------
@@ -88,6 +277,212 @@ void pa_audioSimu_ReceiveDtmf
     le_event_Report(DtmfEvent, &streamEvent, sizeof(le_audio_StreamEvent_t));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a reception of PCM samples on an input interface, and run them through the DSP.
+ * The DTMFs are detected on the modem voice RX interface when the DTMF decoder is started.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_ProcessFrames
+(
+    le_audio_If_t  interface,
+    const int16_t* samplesPtr,
+    uint32_t       count
+)
+{
+    int16_t frame[PA_DTMFSIMU_FRAME_SAMPLES];
+    le_audio_If_t outItf;
+
+    LE_ASSERT( IS_INPUT_STREAM(interface) == true );
+
+    while (count)
+    {
+        uint32_t len = (count < PA_DTMFSIMU_FRAME_SAMPLES) ? count : PA_DTMFSIMU_FRAME_SAMPLES;
+
+        memcpy(frame, samplesPtr, len * sizeof(int16_t));
+
+        if (DspChain[interface] != NULL)
+        {
+            pa_dspSimu_Process(DspChain[interface], frame, len);
+        }
+
+        if ((interface == LE_AUDIO_IF_DSP_BACKEND_MODEM_VOICE_RX) && (DtmfDetectorRef != NULL))
+        {
+            pa_dtmfSimu_Detect(DtmfDetectorRef, frame, len);
+        }
+
+        pa_dspSimu_ApplyGain(frame, len, GetQ15Gain(interface));
+
+        le_mutex_Lock(MixerMutex);
+        for (outItf = 0; outItf < LE_AUDIO_NUM_INTERFACES; outItf++)
+        {
+            if (RouteInputMask[outItf] & (1 << interface))
+            {
+                MixInput(outItf, interface, frame, len);
+            }
+        }
+        le_mutex_Unlock(MixerMutex);
+
+        samplesPtr += len;
+        count -= len;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the playback of an output interface: read the mix of its connected inputs, after the
+ * interface gain and effect chain. The samples played on the speaker are the echo reference of
+ * the microphone.
+ *
+ * @return The number of samples read.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_audioSimu_ReadFrames
+(
+    le_audio_If_t  interface,
+    int16_t*       samplesPtr,
+    uint32_t       count
+)
+{
+    MixBuffer_t* mixPtr;
+    uint32_t readCount;
+    uint32_t n;
+    le_audio_If_t inItf;
+
+    LE_ASSERT( IS_OUTPUT_STREAM(interface) == true );
+
+    le_mutex_Lock(MixerMutex);
+
+    mixPtr = MixBufferPtr[interface];
+    if (mixPtr == NULL)
+    {
+        le_mutex_Unlock(MixerMutex);
+        return 0;
+    }
+
+    readCount = (count < mixPtr->maxFill) ? count : mixPtr->maxFill;
+
+    for (n = 0; n < readCount; n++)
+    {
+        samplesPtr[n] = mixPtr->samples[(mixPtr->readIndex + n) & (MIX_BUFFER_SIZE - 1)];
+    }
+
+    mixPtr->readIndex += readCount;
+    mixPtr->maxFill -= readCount;
+    for (inItf = 0; inItf < LE_AUDIO_NUM_INTERFACES; inItf++)
+    {
+        mixPtr->fill[inItf] = (mixPtr->fill[inItf] > readCount) ?
+                              (mixPtr->fill[inItf] - readCount) : 0;
+    }
+
+    le_mutex_Unlock(MixerMutex);
+
+    pa_dspSimu_ApplyGain(samplesPtr, readCount, GetQ15Gain(interface));
+
+    if (DspChain[interface] != NULL)
+    {
+        pa_dspSimu_Process(DspChain[interface], samplesPtr, readCount);
+    }
+
+    if ((interface == LE_AUDIO_IF_CODEC_SPEAKER) && (DspChain[LE_AUDIO_IF_CODEC_MIC] != NULL))
+    {
+        pa_dspSimu_FeedEchoReference(DspChain[LE_AUDIO_IF_CODEC_MIC], samplesPtr, readCount);
+    }
+
+    return readCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the far end signal played on an output interface, which the echo canceller of an
+ * input interface removes from the processed samples.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_FeedEchoReference
+(
+    le_audio_If_t  interface,
+    const int16_t* samplesPtr,
+    uint32_t       count
+)
+{
+    LE_ASSERT( IS_INPUT_STREAM(interface) == true );
+
+    pa_dspSimu_FeedEchoReference(GetDspChain(interface), samplesPtr, count);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the processing statistics of a DSP stage on an interface.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_GetDspStageStats
+(
+    le_audio_If_t            interface,
+    pa_dspSimu_Stage_t       stage,
+    pa_dspSimu_StageStats_t* statsPtr
+)
+{
+    pa_dspSimu_GetStageStats(GetDspChain(interface), stage, statsPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a reception of in-band DTMFs on the modem voice RX interface: the tones are generated
+ * and processed frame by frame.
+ *
+ * @return LE_BAD_PARAMETER An invalid DTMF is in the string.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_audioSimu_ReceiveDtmfTones
+(
+    const char*    dtmfPtr,
+    uint32_t       duration,
+    uint32_t       pause
+)
+{
+    uint32_t count = 0;
+    uint32_t i;
+    le_result_t res = pa_dtmfSimu_Generate(dtmfPtr, duration, pause, NULL, &count);
+
+    if (res != LE_OK)
+    {
+        return res;
+    }
+
+    int16_t* samplesPtr = malloc(count * sizeof(int16_t));
+    LE_ASSERT(samplesPtr != NULL);
+
+    res = pa_dtmfSimu_Generate(dtmfPtr, duration, pause, samplesPtr, &count);
+
+    for (i = 0; (res == LE_OK) && (i < count); i += PA_DTMFSIMU_FRAME_SAMPLES)
+    {
+        uint32_t len = ((count - i) < PA_DTMFSIMU_FRAME_SAMPLES) ? (count - i) :
+                                                                   PA_DTMFSIMU_FRAME_SAMPLES;
+
+        pa_audioSimu_ProcessFrames(LE_AUDIO_IF_DSP_BACKEND_MODEM_VOICE_RX, samplesPtr + i, len);
+    }
+
+    free(samplesPtr);
+
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the samples of the last signalling DTMFs played.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_GetSignallingDtmfSamples
+(
+    const int16_t** samplesPtr,
+    uint32_t*       countPtr
+)
+{
+    *samplesPtr = SignallingDtmfSamplesPtr;
+    *countPtr = SignallingDtmfCount;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Component initializer.  Called automatically by the application framework at process start.
@@ -95,9 +490,19 @@ void pa_audioSimu_ReceiveDtmf
 //--------------------------------------------------------------------------------------------------
 COMPONENT_INIT
 {
+    le_audio_If_t itf;
+
     memset(BuildAudioPath,0,LE_AUDIO_NUM_INTERFACES*LE_AUDIO_NUM_INTERFACES*sizeof(uint8_t));
+    for (itf = 0; itf < LE_AUDIO_NUM_INTERFACES; itf++)
+    {
+        Gain[itf] = UNITY_GAIN;
+    }
+    MixBufferPool = le_mem_CreatePool("MixBufferPool", sizeof(MixBuffer_t));
+    MixerMutex = le_mutex_CreateNonRecursive("MixerMutex");
     pa_amrSimu_Init();
     pa_pcmSimu_Init();
+    pa_dtmfSimu_Init();
+    pa_dspSimu_Init();
 
     DtmfEvent = le_event_CreateId("DtmfEventId", sizeof(le_audio_StreamEvent_t));
 }
@@ -124,6 +529,15 @@ le_result_t pa_audio_SetDspAudioPath
 
     BuildAudioPath[inputInterface][outputInterface] += 1;
 
+    le_mutex_Lock(MixerMutex);
+    if (MixBufferPtr[outputInterface] == NULL)
+    {
+        MixBufferPtr[outputInterface] = le_mem_ForceAlloc(MixBufferPool);
+        memset(MixBufferPtr[outputInterface], 0, sizeof(MixBuffer_t));
+    }
+    RouteInputMask[outputInterface] |= (1 << inputInterface);
+    le_mutex_Unlock(MixerMutex);
+
     return LE_OK;
 }
 
@@ -229,6 +643,19 @@ le_result_t pa_audio_ResetDspAudioPath
 
     LE_ASSERT( BuildAudioPath[inputInterface][outputInterface] >= 0 );
 
+    if (BuildAudioPath[inputInterface][outputInterface] == 0)
+    {
+        le_mutex_Lock(MixerMutex);
+        RouteInputMask[outputInterface] &= ~(1 << inputInterface);
+        MixBufferPtr[outputInterface]->fill[inputInterface] = 0;
+        if (RouteInputMask[outputInterface] == 0)
+        {
+            le_mem_Release(MixBufferPtr[outputInterface]);
+            MixBufferPtr[outputInterface] = NULL;
+        }
+        le_mutex_Unlock(MixerMutex);
+    }
+
     return LE_OK;
 }
 
@@ -236,6 +663,8 @@ le_result_t pa_audio_ResetDspAudioPath
 /**
  * This function must be called to set the interface gain
  *
+ * The gain is a percentage applied to the samples going through the interface, 100 is unity.
+ *
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_audio_SetGain
@@ -244,6 +673,10 @@ le_result_t pa_audio_SetGain
     int32_t            gain         ///< [IN] gain value
 )
 {
+    LE_ASSERT(streamPtr->audioInterface < LE_AUDIO_NUM_INTERFACES);
+
+    Gain[streamPtr->audioInterface] = gain;
+
     return LE_OK;
 }
 
@@ -261,6 +694,10 @@ le_result_t pa_audio_GetGain
     int32_t*           gainPtr      ///< [OUT] gain value
 )
 {
+    LE_ASSERT(streamPtr->audioInterface < LE_AUDIO_NUM_INTERFACES);
+
+    *gainPtr = Gain[streamPtr->audioInterface];
+
     return LE_OK;
 }
 
@@ -346,6 +783,11 @@ le_result_t pa_audio_StartDtmfDecoder
 {
     LE_ASSERT( streamPtr->audioInterface == LE_AUDIO_IF_DSP_BACKEND_MODEM_VOICE_RX );
 
+    if (DtmfDetectorRef == NULL)
+    {
+        DtmfDetectorRef = pa_dtmfSimu_CreateDetector(DtmfDetectionHandler);
+    }
+
     return LE_OK;
 }
 
@@ -365,6 +807,12 @@ le_result_t pa_audio_StopDtmfDecoder
 {
     LE_ASSERT( streamPtr->audioInterface == LE_AUDIO_IF_DSP_BACKEND_MODEM_VOICE_RX );
 
+    if (DtmfDetectorRef != NULL)
+    {
+        pa_dtmfSimu_DeleteDetector(DtmfDetectorRef);
+        DtmfDetectorRef = NULL;
+    }
+
     return LE_OK;
 }
 
@@ -383,14 +831,7 @@ le_result_t pa_audio_NoiseSuppressorSwitch
     le_onoff_t         switchOnOff  ///< [IN] switch ON or OFF
 )
 {
-    if (switchOnOff == LE_ON)
-    {
-        IsNoiseSuppressorEnabled = true;
-    }
-    else
-    {
-        IsNoiseSuppressorEnabled = false;
-    }
+    SwitchDspStage(streamPtr, PA_DSPSIMU_STAGE_NOISE_SUPPRESSOR, switchOnOff);
 
     return LE_OK;
 }
@@ -410,14 +851,8 @@ le_result_t pa_audio_EchoCancellerSwitch
     le_onoff_t         switchOnOff  ///< [IN] switch ON or OFF
 )
 {
-    if (switchOnOff == LE_ON)
-    {
-        IsEchoCancellerEnabled = true;
-    }
-    else
-    {
-        IsEchoCancellerEnabled = false;
-    }
+    SwitchDspStage(streamPtr, PA_DSPSIMU_STAGE_ECHO_CANCELLER, switchOnOff);
+
     return LE_OK;
 }
 
@@ -437,7 +872,9 @@ le_result_t pa_audio_FirFilterSwitch
     le_onoff_t         switchOnOff   ///< [IN] switch ON or OFF
 )
 {
-    return LE_FAULT;
+    SwitchDspStage(streamPtr, PA_DSPSIMU_STAGE_FIR_FILTER, switchOnOff);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -456,7 +893,9 @@ le_result_t pa_audio_IirFilterSwitch
     le_onoff_t         switchOnOff   ///< [IN] switch ON or OFF
 )
 {
-    return LE_FAULT;
+    SwitchDspStage(streamPtr, PA_DSPSIMU_STAGE_IIR_FILTER, switchOnOff);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -475,7 +914,9 @@ le_result_t pa_audio_AutomaticGainControlSwitch
     le_onoff_t         switchOnOff  ///< [IN] switch ON or OFF
 )
 {
-    return LE_FAULT;
+    SwitchDspStage(streamPtr, PA_DSPSIMU_STAGE_AGC, switchOnOff);
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -718,9 +1159,28 @@ le_result_t pa_audio_PlaySignallingDtmf
     uint32_t             pause      ///< [IN] The pause duration between tones in milliseconds.
 )
 {
+    uint32_t count = 0;
+
     LE_ASSERT(strncmp(dtmfPtr, DtmfPtr, strlen(DtmfPtr))==0);
     LE_ASSERT(duration == DtmfDuration);
     LE_ASSERT(DtmfPause == pause);
+
+    // Render the tones sent on the modem voice TX interface
+    if (pa_dtmfSimu_Generate(dtmfPtr, duration, pause, NULL, &count) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    free(SignallingDtmfSamplesPtr);
+    SignallingDtmfSamplesPtr = malloc(count * sizeof(int16_t));
+    LE_ASSERT((SignallingDtmfSamplesPtr != NULL) || (count == 0));
+
+    if (pa_dtmfSimu_Generate(dtmfPtr, duration, pause, SignallingDtmfSamplesPtr, &count) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+    SignallingDtmfCount = count;
+
     return LE_OK;
 }
 
@@ -826,7 +1286,8 @@ le_result_t pa_audio_GetNoiseSuppressorStatus
     bool*              noiseSuppressorStatusPtr     ///< [OUT] Noise Suppressor status
 )
 {
-    *noiseSuppressorStatusPtr = IsNoiseSuppressorEnabled;
+    *noiseSuppressorStatusPtr = pa_dspSimu_IsStageEnabled(GetDspChain(streamPtr->audioInterface),
+                                                          PA_DSPSIMU_STAGE_NOISE_SUPPRESSOR);
     return LE_OK;
 }
 
@@ -844,6 +1305,7 @@ le_result_t pa_audio_GetEchoCancellerStatus
     bool*              echoCancellerStatusPtr       ///< [OUT] Echo Canceller status
 )
 {
-    *echoCancellerStatusPtr = IsEchoCancellerEnabled;
+    *echoCancellerStatusPtr = pa_dspSimu_IsStageEnabled(GetDspChain(streamPtr->audioInterface),
+                                                        PA_DSPSIMU_STAGE_ECHO_CANCELLER);
     return LE_OK;
 }
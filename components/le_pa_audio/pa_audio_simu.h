@@ -8,6 +8,8 @@
 #ifndef PA_AUDIO_SIMU_H_INCLUDE_GUARD
 #define PA_AUDIO_SIMU_H_INCLUDE_GUARD
 
+#include "pa_dsp_simu.h"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Check the audio path set.
@@ -50,5 +52,86 @@ void pa_audioSimu_PlaySignallingDtmf
     uint32_t       pause
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a reception of PCM samples on an input interface, and run them through the DSP.
+ * The DTMFs are detected on the modem voice RX interface when the DTMF decoder is started.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_ProcessFrames
+(
+    le_audio_If_t  interface,
+    const int16_t* samplesPtr,
+    uint32_t       count
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the playback of an output interface: read the mix of its connected inputs, after the
+ * interface gain and effect chain. The samples played on the speaker are the echo reference of
+ * the microphone.
+ *
+ * @return The number of samples read.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_audioSimu_ReadFrames
+(
+    le_audio_If_t  interface,
+    int16_t*       samplesPtr,
+    uint32_t       count
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate the far end signal played on an output interface, which the echo canceller of an
+ * input interface removes from the processed samples.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_FeedEchoReference
+(
+    le_audio_If_t  interface,
+    const int16_t* samplesPtr,
+    uint32_t       count
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the processing statistics of a DSP stage on an interface.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_GetDspStageStats
+(
+    le_audio_If_t            interface,
+    pa_dspSimu_Stage_t       stage,
+    pa_dspSimu_StageStats_t* statsPtr
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulate a reception of in-band DTMFs on the modem voice RX interface: the tones are generated
+ * and processed frame by frame.
+ *
+ * @return LE_BAD_PARAMETER An invalid DTMF is in the string.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_audioSimu_ReceiveDtmfTones
+(
+    const char*    dtmfPtr,
+    uint32_t       duration,
+    uint32_t       pause
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the samples of the last signalling DTMFs played.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_audioSimu_GetSignallingDtmfSamples
+(
+    const int16_t** samplesPtr,
+    uint32_t*       countPtr
+);
+
 #endif
 
@@ -0,0 +1,993 @@
+/**
+ * @file pa_dsp_simu.c
+ *
+ * Effect chain of the simulated audio DSP.
+ *
+ * An effect chain is made of stages described by the StageOps table, processed in the order of
+ * pa_dspSimu_Stage_t over blocks of DSP_BLOCK_SIZE float samples. The kernels use GCC vector
+ * extensions, which are compiled to the SIMD instructions of the target (SSE/AVX, NEON) or to
+ * scalar code. The time spent in each stage is measured with the CPU time stamp counter.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_dsp_simu.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of lanes of the vectors: 128-bit vectors, native on NEON and SSE.
+ */
+//--------------------------------------------------------------------------------------------------
+#define VEC_LANES               4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Processing block: 20 ms of samples.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DSP_BLOCK_SIZE          160
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Echo canceller: NLMS filter length (8 ms), adaptation step and regularization, and size of the
+ * far end reference FIFO.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EC_TAPS                 64
+#define EC_STEP                 0.5f
+#define EC_REGULARIZATION       10000.0f
+#define EC_REF_FIFO_SIZE        2048
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Noise suppressor: rise of the noise floor estimate per block, over-subtraction factor, minimum
+ * gain and gain smoothing.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NS_NOISE_RISE           1.02f
+#define NS_OVERSUBTRACTION      2.0f
+#define NS_MIN_GAIN             0.1f
+#define NS_GAIN_SMOOTHING       0.5f
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * FIR filter: length and pass band (voice band).
+ */
+//--------------------------------------------------------------------------------------------------
+#define FIR_TAPS                32
+#define FIR_LOW_CUTOFF          300.0
+#define FIR_HIGH_CUTOFF         3400.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * IIR filter: a high-pass section removing DC and hum, then a presence peaking section.
+ */
+//--------------------------------------------------------------------------------------------------
+#define IIR_SECTIONS            2
+#define IIR_HIGHPASS_FREQ       120.0
+#define IIR_PEAK_FREQ           2000.0
+#define IIR_PEAK_GAIN_DB        4.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automatic gain control: target RMS level (about -20 dBFS), gain range, level under which the
+ * gain is frozen, attack and release factors.
+ */
+//--------------------------------------------------------------------------------------------------
+#define AGC_TARGET_LEVEL        3000.0f
+#define AGC_MAX_GAIN            8.0f
+#define AGC_MIN_GAIN            0.25f
+#define AGC_NOISE_GATE          100.0f
+#define AGC_ATTACK              0.5f
+#define AGC_RELEASE             0.05f
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of effect chains preallocated in the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CHAIN_POOL_SIZE         4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Vector of floats. The chain states are float arrays (pool blocks are not aligned for vectors),
+ * loaded and stored with LoadVec() and StoreVec().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef float Vec4f_t __attribute__((vector_size(VEC_LANES * sizeof(float))));
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Biquad coefficients, normalized by a0.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    float b0, b1, b2;
+    float a1, a2;
+}
+Biquad_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stage states.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    float    weights[EC_TAPS];              ///< Filter, oldest reference sample first
+    float    history[EC_TAPS - 1];          ///< Last reference samples of the previous block
+    float    fifo[EC_REF_FIFO_SIZE];        ///< Far end reference samples not processed yet
+    uint32_t fifoRead;
+    uint32_t fifoCount;
+}
+EchoCanceller_t;
+
+typedef struct
+{
+    float noise;                            ///< Noise floor estimate (mean power)
+    float gain;
+}
+NoiseSuppressor_t;
+
+typedef struct
+{
+    float history[FIR_TAPS - 1];            ///< Last input samples of the previous block
+}
+FirFilter_t;
+
+typedef struct
+{
+    float x[IIR_SECTIONS][2];               ///< Last inputs of the sections, oldest first
+    float y[IIR_SECTIONS][2];               ///< Last outputs of the sections, oldest first
+}
+IirFilter_t;
+
+typedef struct
+{
+    float gain;
+}
+Agc_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Effect chain.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_dspSimu_Chain
+{
+    bool                    enabled[PA_DSPSIMU_STAGE_MAX];
+    pa_dspSimu_StageStats_t stats[PA_DSPSIMU_STAGE_MAX];
+    EchoCanceller_t         echoCanceller;
+    NoiseSuppressor_t       noiseSuppressor;
+    FirFilter_t             firFilter;
+    IirFilter_t             iirFilter;
+    Agc_t                   agc;
+}
+Chain_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stage operations.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* namePtr;
+    void (*resetFunc)(Chain_t* chainPtr);
+    void (*processFunc)(Chain_t* chainPtr, float* samplesPtr, uint32_t count);
+}
+StageOps_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Filter coefficients computed at initialization. The FIR coefficients are reversed, so that an
+ * output is the dot product of the coefficients and of the FIR_TAPS last inputs, oldest first.
+ */
+//--------------------------------------------------------------------------------------------------
+static float FirCoeff[FIR_TAPS];
+static Biquad_t IirSection[IIR_SECTIONS];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Effect chain pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ChainPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the CPU time stamp counter, or the monotonic clock in nanoseconds where there is none.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint64_t ReadCycles
+(
+    void
+)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t cycles;
+
+    __asm__ volatile ("mrs %0, cntvct_el0" : "=r" (cycles));
+    return cycles;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Vector helpers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline Vec4f_t LoadVec
+(
+    const float* srcPtr
+)
+{
+    Vec4f_t v;
+
+    memcpy(&v, srcPtr, sizeof(v));
+    return v;
+}
+
+static inline void StoreVec
+(
+    float*  dstPtr,
+    Vec4f_t v
+)
+{
+    memcpy(dstPtr, &v, sizeof(v));
+}
+
+static inline float SumVec
+(
+    Vec4f_t v
+)
+{
+    float sum = 0;
+    uint32_t k;
+
+    for (k = 0; k < VEC_LANES; k++)
+    {
+        sum += v[k];
+    }
+    return sum;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the mean power of samples.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static float GetMeanPower
+(
+    const float* samplesPtr,
+    uint32_t     count
+)
+{
+    Vec4f_t acc = { 0 };
+    float sum;
+    uint32_t n;
+
+    for (n = 0; (n + VEC_LANES) <= count; n += VEC_LANES)
+    {
+        Vec4f_t x = LoadVec(samplesPtr + n);
+        acc += x * x;
+    }
+
+    sum = SumVec(acc);
+    for (; n < count; n++)
+    {
+        sum += samplesPtr[n] * samplesPtr[n];
+    }
+
+    return count ? (sum / count) : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a gain ramping linearly over the samples.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyGainRamp
+(
+    float*   samplesPtr,
+    uint32_t count,
+    float    fromGain,
+    float    toGain
+)
+{
+    const Vec4f_t laneIndex = { 1, 2, 3, 4 };
+    float step = (toGain - fromGain) / count;
+    uint32_t n;
+
+    for (n = 0; (n + VEC_LANES) <= count; n += VEC_LANES)
+    {
+        Vec4f_t gain = (laneIndex + (float) n) * step + fromGain;
+        StoreVec(samplesPtr + n, LoadVec(samplesPtr + n) * gain);
+    }
+
+    for (; n < count; n++)
+    {
+        samplesPtr[n] *= fromGain + step * (n + 1);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Echo canceller: normalized LMS filter estimating the echo of the far end reference.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetEchoCanceller
+(
+    Chain_t* chainPtr
+)
+{
+    memset(&chainPtr->echoCanceller, 0, sizeof(EchoCanceller_t));
+}
+
+static void ProcessEchoCanceller
+(
+    Chain_t* chainPtr,
+    float*   samplesPtr,
+    uint32_t count
+)
+{
+    EchoCanceller_t* ecPtr = &chainPtr->echoCanceller;
+    float ref[EC_TAPS - 1 + DSP_BLOCK_SIZE];
+    float* newRefPtr = ref + EC_TAPS - 1;
+    uint32_t n;
+    uint32_t k;
+
+    // Reference window: previous samples, then the samples played with this block
+    memcpy(ref, ecPtr->history, sizeof(ecPtr->history));
+    for (n = 0; n < count; n++)
+    {
+        if (ecPtr->fifoCount)
+        {
+            newRefPtr[n] = ecPtr->fifo[ecPtr->fifoRead];
+            ecPtr->fifoRead = (ecPtr->fifoRead + 1) % EC_REF_FIFO_SIZE;
+            ecPtr->fifoCount--;
+        }
+        else
+        {
+            newRefPtr[n] = 0;
+        }
+    }
+
+    for (n = 0; n < count; n++)
+    {
+        const float* windowPtr = ref + n;
+        Vec4f_t estimate = { 0 };
+        Vec4f_t power = { 0 };
+
+        for (k = 0; k < EC_TAPS; k += VEC_LANES)
+        {
+            Vec4f_t x = LoadVec(windowPtr + k);
+
+            estimate += LoadVec(ecPtr->weights + k) * x;
+            power += x * x;
+        }
+
+        float error = samplesPtr[n] - SumVec(estimate);
+        float step = EC_STEP * error / (SumVec(power) + EC_REGULARIZATION);
+
+        for (k = 0; k < EC_TAPS; k += VEC_LANES)
+        {
+            StoreVec(ecPtr->weights + k,
+                     LoadVec(ecPtr->weights + k) + LoadVec(windowPtr + k) * step);
+        }
+
+        samplesPtr[n] = error;
+    }
+
+    memcpy(ecPtr->history, ref + count, sizeof(ecPtr->history));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Noise suppressor: gain derived from the ratio between the block power and the noise floor, the
+ * noise floor following the minimum of the block powers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetNoiseSuppressor
+(
+    Chain_t* chainPtr
+)
+{
+    chainPtr->noiseSuppressor.noise = 0;
+    chainPtr->noiseSuppressor.gain = 1;
+}
+
+static void ProcessNoiseSuppressor
+(
+    Chain_t* chainPtr,
+    float*   samplesPtr,
+    uint32_t count
+)
+{
+    NoiseSuppressor_t* nsPtr = &chainPtr->noiseSuppressor;
+    float power = GetMeanPower(samplesPtr, count);
+    float gain = NS_MIN_GAIN;
+
+    if ((nsPtr->noise == 0) || (power < nsPtr->noise))
+    {
+        nsPtr->noise = power;
+    }
+    else
+    {
+        nsPtr->noise *= NS_NOISE_RISE;
+    }
+
+    if (power > 0)
+    {
+        gain = 1 - NS_OVERSUBTRACTION * nsPtr->noise / power;
+        gain = (gain < NS_MIN_GAIN) ? NS_MIN_GAIN : gain;
+    }
+
+    gain = nsPtr->gain + (gain - nsPtr->gain) * NS_GAIN_SMOOTHING;
+    ApplyGainRamp(samplesPtr, count, nsPtr->gain, gain);
+    nsPtr->gain = gain;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * FIR filter: VEC_LANES outputs are computed at once, one coefficient at a time.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetFirFilter
+(
+    Chain_t* chainPtr
+)
+{
+    memset(&chainPtr->firFilter, 0, sizeof(FirFilter_t));
+}
+
+static void ProcessFirFilter
+(
+    Chain_t* chainPtr,
+    float*   samplesPtr,
+    uint32_t count
+)
+{
+    FirFilter_t* firPtr = &chainPtr->firFilter;
+    float in[FIR_TAPS - 1 + DSP_BLOCK_SIZE];
+    uint32_t n;
+    uint32_t k;
+
+    memcpy(in, firPtr->history, sizeof(firPtr->history));
+    memcpy(in + FIR_TAPS - 1, samplesPtr, count * sizeof(float));
+
+    for (n = 0; (n + VEC_LANES) <= count; n += VEC_LANES)
+    {
+        Vec4f_t acc = { 0 };
+
+        for (k = 0; k < FIR_TAPS; k++)
+        {
+            acc += LoadVec(in + n + k) * FirCoeff[k];
+        }
+        StoreVec(samplesPtr + n, acc);
+    }
+
+    for (; n < count; n++)
+    {
+        float acc = 0;
+
+        for (k = 0; k < FIR_TAPS; k++)
+        {
+            acc += in[n + k] * FirCoeff[k];
+        }
+        samplesPtr[n] = acc;
+    }
+
+    memcpy(firPtr->history, in + count, sizeof(firPtr->history));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * IIR filter: cascade of biquads in direct form I. The feed-forward part of a section is computed
+ * VEC_LANES samples at once, the feedback part is recursive.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetIirFilter
+(
+    Chain_t* chainPtr
+)
+{
+    memset(&chainPtr->iirFilter, 0, sizeof(IirFilter_t));
+}
+
+static void ProcessIirFilter
+(
+    Chain_t* chainPtr,
+    float*   samplesPtr,
+    uint32_t count
+)
+{
+    IirFilter_t* iirPtr = &chainPtr->iirFilter;
+    float in[2 + DSP_BLOCK_SIZE];
+    uint32_t section;
+    uint32_t n;
+
+    for (section = 0; section < IIR_SECTIONS; section++)
+    {
+        const Biquad_t* bqPtr = &IirSection[section];
+        float y1 = iirPtr->y[section][1];
+        float y2 = iirPtr->y[section][0];
+
+        in[0] = iirPtr->x[section][0];
+        in[1] = iirPtr->x[section][1];
+        memcpy(in + 2, samplesPtr, count * sizeof(float));
+
+        for (n = 0; (n + VEC_LANES) <= count; n += VEC_LANES)
+        {
+            StoreVec(samplesPtr + n, LoadVec(in + n + 2) * bqPtr->b0 +
+                                     LoadVec(in + n + 1) * bqPtr->b1 +
+                                     LoadVec(in + n) * bqPtr->b2);
+        }
+        for (; n < count; n++)
+        {
+            samplesPtr[n] = in[n + 2] * bqPtr->b0 + in[n + 1] * bqPtr->b1 + in[n] * bqPtr->b2;
+        }
+
+        for (n = 0; n < count; n++)
+        {
+            float y = samplesPtr[n] - bqPtr->a1 * y1 - bqPtr->a2 * y2;
+
+            y2 = y1;
+            y1 = y;
+            samplesPtr[n] = y;
+        }
+
+        iirPtr->x[section][0] = in[count];
+        iirPtr->x[section][1] = in[count + 1];
+        iirPtr->y[section][0] = y2;
+        iirPtr->y[section][1] = y1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Automatic gain control: the gain moves towards the one bringing the block to the target level,
+ * quickly when it decreases and slowly when it increases.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetAgc
+(
+    Chain_t* chainPtr
+)
+{
+    chainPtr->agc.gain = 1;
+}
+
+static void ProcessAgc
+(
+    Chain_t* chainPtr,
+    float*   samplesPtr,
+    uint32_t count
+)
+{
+    Agc_t* agcPtr = &chainPtr->agc;
+    float level = sqrtf(GetMeanPower(samplesPtr, count));
+    float gain = agcPtr->gain;
+
+    if (level > AGC_NOISE_GATE)
+    {
+        float wanted = AGC_TARGET_LEVEL / level;
+
+        wanted = (wanted > AGC_MAX_GAIN) ? AGC_MAX_GAIN :
+                 ((wanted < AGC_MIN_GAIN) ? AGC_MIN_GAIN : wanted);
+        gain += (wanted - gain) * ((wanted < gain) ? AGC_ATTACK : AGC_RELEASE);
+    }
+
+    ApplyGainRamp(samplesPtr, count, agcPtr->gain, gain);
+    agcPtr->gain = gain;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stage operations, in processing order.
+ */
+//--------------------------------------------------------------------------------------------------
+static const StageOps_t StageOps[PA_DSPSIMU_STAGE_MAX] =
+{
+    [PA_DSPSIMU_STAGE_ECHO_CANCELLER]   = { "EchoCanceller", ResetEchoCanceller,
+                                            ProcessEchoCanceller },
+    [PA_DSPSIMU_STAGE_NOISE_SUPPRESSOR] = { "NoiseSuppressor", ResetNoiseSuppressor,
+                                            ProcessNoiseSuppressor },
+    [PA_DSPSIMU_STAGE_FIR_FILTER]       = { "FirFilter", ResetFirFilter, ProcessFirFilter },
+    [PA_DSPSIMU_STAGE_IIR_FILTER]       = { "IirFilter", ResetIirFilter, ProcessIirFilter },
+    [PA_DSPSIMU_STAGE_AGC]              = { "Agc", ResetAgc, ProcessAgc },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the coefficients of the filters.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ComputeFilters
+(
+    void
+)
+{
+    double fs = PA_DSPSIMU_SAMPLE_RATE;
+    double center = (FIR_TAPS - 1) / 2.0;
+    uint32_t k;
+
+    // FIR: windowed-sinc band-pass (Hamming window)
+    for (k = 0; k < FIR_TAPS; k++)
+    {
+        double t = k - center;
+        double window = 0.54 - 0.46 * cos(2 * M_PI * k / (FIR_TAPS - 1));
+        double h = (sin(2 * M_PI * FIR_HIGH_CUTOFF / fs * t) -
+                    sin(2 * M_PI * FIR_LOW_CUTOFF / fs * t)) / (M_PI * t);
+
+        FirCoeff[FIR_TAPS - 1 - k] = h * window;
+    }
+
+    // IIR: Butterworth high-pass, then peaking filter
+    double w0 = 2 * M_PI * IIR_HIGHPASS_FREQ / fs;
+    double alpha = sin(w0) / (2 * M_SQRT1_2);
+    double a0 = 1 + alpha;
+
+    IirSection[0].b0 = (1 + cos(w0)) / 2 / a0;
+    IirSection[0].b1 = -(1 + cos(w0)) / a0;
+    IirSection[0].b2 = (1 + cos(w0)) / 2 / a0;
+    IirSection[0].a1 = -2 * cos(w0) / a0;
+    IirSection[0].a2 = (1 - alpha) / a0;
+
+    double a = pow(10, IIR_PEAK_GAIN_DB / 40);
+
+    w0 = 2 * M_PI * IIR_PEAK_FREQ / fs;
+    alpha = sin(w0) / 2;
+    a0 = 1 + alpha / a;
+
+    IirSection[1].b0 = (1 + alpha * a) / a0;
+    IirSection[1].b1 = -2 * cos(w0) / a0;
+    IirSection[1].b2 = (1 - alpha * a) / a0;
+    IirSection[1].a1 = -2 * cos(w0) / a0;
+    IirSection[1].a2 = (1 - alpha / a) / a0;
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an effect chain, with all the stages disabled.
+ *
+ * @return The chain reference.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_dspSimu_ChainRef_t pa_dspSimu_CreateChain
+(
+    void
+)
+{
+    Chain_t* chainPtr = le_mem_ForceAlloc(ChainPool);
+
+    memset(chainPtr, 0, sizeof(Chain_t));
+
+    return chainPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an effect chain.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_DeleteChain
+(
+    pa_dspSimu_ChainRef_t chainRef      ///< [IN] Effect chain
+)
+{
+    le_mem_Release(chainRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable a stage of an effect chain. The stage state is reset when it is enabled.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_EnableStage
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    pa_dspSimu_Stage_t    stage,        ///< [IN] Stage
+    bool                  enable        ///< [IN] Enable or disable
+)
+{
+    LE_ASSERT(stage < PA_DSPSIMU_STAGE_MAX);
+
+    if (enable && !chainRef->enabled[stage])
+    {
+        StageOps[stage].resetFunc(chainRef);
+    }
+
+    chainRef->enabled[stage] = enable;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a stage of an effect chain is enabled.
+ *
+ * @return true if the stage is enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_dspSimu_IsStageEnabled
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    pa_dspSimu_Stage_t    stage         ///< [IN] Stage
+)
+{
+    LE_ASSERT(stage < PA_DSPSIMU_STAGE_MAX);
+
+    return chainRef->enabled[stage];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run PCM samples through the enabled stages of an effect chain, in place.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_Process
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    int16_t*              samplesPtr,   ///< [IN/OUT] PCM samples
+    uint32_t              count         ///< [IN] Number of samples
+)
+{
+    float block[DSP_BLOCK_SIZE];
+    pa_dspSimu_Stage_t stage;
+    bool isActive = false;
+    uint32_t n;
+
+    for (stage = 0; stage < PA_DSPSIMU_STAGE_MAX; stage++)
+    {
+        isActive |= chainRef->enabled[stage];
+    }
+
+    if (!isActive)
+    {
+        return;
+    }
+
+    while (count)
+    {
+        uint32_t len = (count < DSP_BLOCK_SIZE) ? count : DSP_BLOCK_SIZE;
+
+        for (n = 0; n < len; n++)
+        {
+            block[n] = samplesPtr[n];
+        }
+
+        for (stage = 0; stage < PA_DSPSIMU_STAGE_MAX; stage++)
+        {
+            if (chainRef->enabled[stage])
+            {
+                uint64_t start = ReadCycles();
+
+                StageOps[stage].processFunc(chainRef, block, len);
+
+                chainRef->stats[stage].cycles += ReadCycles() - start;
+                chainRef->stats[stage].blocks++;
+                chainRef->stats[stage].samples += len;
+            }
+        }
+
+        for (n = 0; n < len; n++)
+        {
+            float sample = block[n];
+
+            sample = (sample > INT16_MAX) ? INT16_MAX : ((sample < INT16_MIN) ? INT16_MIN : sample);
+            samplesPtr[n] = (int16_t) sample;
+        }
+
+        samplesPtr += len;
+        count -= len;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Feed the far end signal that the echo canceller of a chain removes from the processed samples.
+ *
+ * The reference is consumed in step with the processed samples; the oldest samples are dropped
+ * when the FIFO is full.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_FeedEchoReference
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    const int16_t*        samplesPtr,   ///< [IN] Far end PCM samples
+    uint32_t              count         ///< [IN] Number of samples
+)
+{
+    EchoCanceller_t* ecPtr = &chainRef->echoCanceller;
+    uint32_t n;
+
+    if (!chainRef->enabled[PA_DSPSIMU_STAGE_ECHO_CANCELLER])
+    {
+        return;
+    }
+
+    for (n = 0; n < count; n++)
+    {
+        if (ecPtr->fifoCount == EC_REF_FIFO_SIZE)
+        {
+            ecPtr->fifoRead = (ecPtr->fifoRead + 1) % EC_REF_FIFO_SIZE;
+            ecPtr->fifoCount--;
+        }
+
+        ecPtr->fifo[(ecPtr->fifoRead + ecPtr->fifoCount) % EC_REF_FIFO_SIZE] = samplesPtr[n];
+        ecPtr->fifoCount++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the processing statistics of a stage of an effect chain.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_GetStageStats
+(
+    pa_dspSimu_ChainRef_t    chainRef,  ///< [IN] Effect chain
+    pa_dspSimu_Stage_t       stage,     ///< [IN] Stage
+    pa_dspSimu_StageStats_t* statsPtr   ///< [OUT] Statistics
+)
+{
+    LE_ASSERT(stage < PA_DSPSIMU_STAGE_MAX);
+
+    *statsPtr = chainRef->stats[stage];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the processing statistics of all the stages of an effect chain.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_ResetStageStats
+(
+    pa_dspSimu_ChainRef_t chainRef      ///< [IN] Effect chain
+)
+{
+    memset(chainRef->stats, 0, sizeof(chainRef->stats));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mix PCM samples into a mix buffer, with saturating adds.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_MixSaturate
+(
+    int16_t*       mixPtr,          ///< [IN/OUT] Mix buffer
+    const int16_t* samplesPtr,      ///< [IN] PCM samples
+    uint32_t       count            ///< [IN] Number of samples
+)
+{
+    uint32_t n = 0;
+
+#if defined(__SSE2__)
+    for (; (n + 8) <= count; n += 8)
+    {
+        __m128i mix = _mm_loadu_si128((const __m128i*) (mixPtr + n));
+        __m128i in = _mm_loadu_si128((const __m128i*) (samplesPtr + n));
+
+        _mm_storeu_si128((__m128i*) (mixPtr + n), _mm_adds_epi16(mix, in));
+    }
+#elif defined(__ARM_NEON)
+    for (; (n + 8) <= count; n += 8)
+    {
+        vst1q_s16(mixPtr + n, vqaddq_s16(vld1q_s16(mixPtr + n), vld1q_s16(samplesPtr + n)));
+    }
+#endif
+
+    for (; n < count; n++)
+    {
+        int32_t sum = mixPtr[n] + samplesPtr[n];
+
+        mixPtr[n] = (sum > INT16_MAX) ? INT16_MAX : ((sum < INT16_MIN) ? INT16_MIN : sum);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a Q15 gain to PCM samples, in place.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_ApplyGain
+(
+    int16_t* samplesPtr,            ///< [IN/OUT] PCM samples
+    uint32_t count,                 ///< [IN] Number of samples
+    int32_t  gain                   ///< [IN] Gain, PA_DSPSIMU_UNITY_GAIN is unity
+)
+{
+    uint32_t n;
+
+    if (gain == PA_DSPSIMU_UNITY_GAIN)
+    {
+        return;
+    }
+
+    for (n = 0; n < count; n++)
+    {
+        int64_t sample = ((int64_t) samplesPtr[n] * gain + (PA_DSPSIMU_UNITY_GAIN / 2)) >> 15;
+
+        samplesPtr[n] = (sample > INT16_MAX) ? INT16_MAX :
+                        ((sample < INT16_MIN) ? INT16_MIN : sample);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the name of a stage.
+ *
+ * @return The stage name.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* pa_dspSimu_GetStageName
+(
+    pa_dspSimu_Stage_t stage            ///< [IN] Stage
+)
+{
+    LE_ASSERT(stage < PA_DSPSIMU_STAGE_MAX);
+
+    return StageOps[stage].namePtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_dsp simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_Init
+(
+    void
+)
+{
+    ComputeFilters();
+
+    ChainPool = le_mem_CreatePool("DspChainPool", sizeof(Chain_t));
+    le_mem_ExpandPool(ChainPool, CHAIN_POOL_SIZE);
+}
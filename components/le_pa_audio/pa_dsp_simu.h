@@ -0,0 +1,212 @@
+/** @file pa_dsp_simu.h
+ *
+ * Legato @ref pa_dsp_simu include file.
+ *
+ * Effect chain of the simulated audio DSP, applied to the 16-bit mono PCM samples of an audio
+ * path at PA_DSPSIMU_SAMPLE_RATE.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_DSP_SIMU_H_INCLUDE_GUARD
+#define PA_DSP_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample rate of the audio paths (narrowband voice).
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_DSPSIMU_SAMPLE_RATE      8000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unity of the Q15 gains.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_DSPSIMU_UNITY_GAIN       32768
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stages of the effect chain, in processing order.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_DSPSIMU_STAGE_ECHO_CANCELLER,    ///< NLMS echo canceller
+    PA_DSPSIMU_STAGE_NOISE_SUPPRESSOR,  ///< Noise suppressor
+    PA_DSPSIMU_STAGE_FIR_FILTER,        ///< FIR voice band filter
+    PA_DSPSIMU_STAGE_IIR_FILTER,        ///< IIR high-pass and presence filter
+    PA_DSPSIMU_STAGE_AGC,               ///< Automatic gain control
+    PA_DSPSIMU_STAGE_MAX
+}
+pa_dspSimu_Stage_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Processing statistics of a stage.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t cycles;        ///< Cycles spent in the stage (time stamp counter, or nanoseconds)
+    uint64_t blocks;        ///< Blocks processed
+    uint64_t samples;       ///< Samples processed
+}
+pa_dspSimu_StageStats_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference type for an effect chain.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_dspSimu_Chain* pa_dspSimu_ChainRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_dsp simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an effect chain, with all the stages disabled.
+ *
+ * @return The chain reference.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_dspSimu_ChainRef_t pa_dspSimu_CreateChain
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an effect chain.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_DeleteChain
+(
+    pa_dspSimu_ChainRef_t chainRef      ///< [IN] Effect chain
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Enable or disable a stage of an effect chain. The stage state is reset when it is enabled.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_EnableStage
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    pa_dspSimu_Stage_t    stage,        ///< [IN] Stage
+    bool                  enable        ///< [IN] Enable or disable
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a stage of an effect chain is enabled.
+ *
+ * @return true if the stage is enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+bool pa_dspSimu_IsStageEnabled
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    pa_dspSimu_Stage_t    stage         ///< [IN] Stage
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run PCM samples through the enabled stages of an effect chain, in place.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_Process
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    int16_t*              samplesPtr,   ///< [IN/OUT] PCM samples
+    uint32_t              count         ///< [IN] Number of samples
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Feed the far end signal that the echo canceller of a chain removes from the processed samples.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_FeedEchoReference
+(
+    pa_dspSimu_ChainRef_t chainRef,     ///< [IN] Effect chain
+    const int16_t*        samplesPtr,   ///< [IN] Far end PCM samples
+    uint32_t              count         ///< [IN] Number of samples
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the processing statistics of a stage of an effect chain.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_GetStageStats
+(
+    pa_dspSimu_ChainRef_t    chainRef,  ///< [IN] Effect chain
+    pa_dspSimu_Stage_t       stage,     ///< [IN] Stage
+    pa_dspSimu_StageStats_t* statsPtr   ///< [OUT] Statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the processing statistics of all the stages of an effect chain.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_ResetStageStats
+(
+    pa_dspSimu_ChainRef_t chainRef      ///< [IN] Effect chain
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mix PCM samples into a mix buffer, with saturating adds.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_MixSaturate
+(
+    int16_t*       mixPtr,          ///< [IN/OUT] Mix buffer
+    const int16_t* samplesPtr,      ///< [IN] PCM samples
+    uint32_t       count            ///< [IN] Number of samples
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a Q15 gain to PCM samples, in place.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dspSimu_ApplyGain
+(
+    int16_t* samplesPtr,            ///< [IN/OUT] PCM samples
+    uint32_t count,                 ///< [IN] Number of samples
+    int32_t  gain                   ///< [IN] Gain, PA_DSPSIMU_UNITY_GAIN is unity
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the name of a stage.
+ *
+ * @return The stage name.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* pa_dspSimu_GetStageName
+(
+    pa_dspSimu_Stage_t stage            ///< [IN] Stage
+);
+
+#endif
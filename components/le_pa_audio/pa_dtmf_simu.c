@@ -0,0 +1,608 @@
+/**
+ * @file pa_dtmf_simu.c
+ *
+ * DTMF tone generator and detector of the simulated audio DSP.
+ *
+ * Both work on the 8 DTMF frequencies at once with GCC vector extensions, which are compiled to
+ * the SIMD instructions of the target (SSE/AVX, NEON) or to scalar code:
+ * - the generator renders VEC_LANES consecutive samples per step, each lane rotating its phase by
+ *   VEC_LANES samples;
+ * - the detector runs one Goertzel filter per DTMF frequency, one frequency per lane, over blocks
+ *   of GOERTZEL_BLOCK_SIZE samples.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_dtmf_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of lanes of the vectors: the 8 DTMF frequencies, or 8 consecutive samples.
+ */
+//--------------------------------------------------------------------------------------------------
+#define VEC_LANES               8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lanes of the row (low group) and column (high group) frequencies.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ROW_FIRST_LANE          0
+#define COL_FIRST_LANE          4
+#define GROUP_SIZE              4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Amplitude of each of the two tones of a DTMF (about -9 dBFS).
+ */
+//--------------------------------------------------------------------------------------------------
+#define TONE_AMPLITUDE          11000.0f
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Goertzel block: 205 samples at 8 kHz give bins about 39 Hz wide, narrower than the spacing of
+ * the DTMF frequencies.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GOERTZEL_BLOCK_SIZE     205
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Detection thresholds:
+ * - minimum RMS level of a block;
+ * - minimum part of the block energy held by the two tones;
+ * - minimum ratio between the strongest and the second strongest tone of a group;
+ * - maximum power ratio between the two tones (twist).
+ */
+//--------------------------------------------------------------------------------------------------
+#define DETECT_MIN_LEVEL        200.0f
+#define DETECT_MIN_TONE_RATIO   0.7f
+#define DETECT_MIN_PEAK_RATIO   4.0f
+#define DETECT_MAX_TWIST        6.3f
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of detectors preallocated in the pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DETECTOR_POOL_SIZE      1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Vector of floats.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef float Vec8f_t __attribute__((vector_size(VEC_LANES * sizeof(float))));
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Phase rotator of a tone: VEC_LANES consecutive samples, advanced by VEC_LANES samples per step.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    Vec8f_t sinInit;    ///< sin(w.k) of the lanes k
+    Vec8f_t cosInit;    ///< cos(w.k) of the lanes k
+    float   sinStep;    ///< sin(w.VEC_LANES)
+    float   cosStep;    ///< cos(w.VEC_LANES)
+}
+Rotator_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF detector.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_dtmfSimu_Detector
+{
+    pa_dtmfSimu_DetectionFunc_t detectionFunc;  ///< Function called on each detected DTMF
+    float    s1[VEC_LANES];                     ///< Goertzel states, one frequency per lane (not
+    float    s2[VEC_LANES];                     ///< vectors: pool blocks are not 32-byte aligned)
+    float    energy;                            ///< Energy of the current block
+    uint32_t sampleCount;                       ///< Samples in the current block
+    char     lastDtmf;                          ///< DTMF of the previous block, 0 if none
+}
+Detector_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF frequencies: rows then columns.
+ */
+//--------------------------------------------------------------------------------------------------
+static const float DtmfFrequency[VEC_LANES] = { 697, 770, 852, 941, 1209, 1336, 1477, 1633 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF keypad, indexed by row * GROUP_SIZE + column.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char DtmfKeys[] = "123A456B789C*0#D";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tables computed at initialization: Goertzel coefficients and tone rotators.
+ */
+//--------------------------------------------------------------------------------------------------
+static Vec8f_t GoertzelCoeff;
+static Rotator_t Rotator[VEC_LANES];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Detector pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DetectorPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of DTMFs detected during the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t BenchmarkDetections;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the row and column lanes of a DTMF.
+ *
+ * @return LE_BAD_PARAMETER Not a DTMF.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetDtmfLanes
+(
+    char      dtmf,         ///< [IN] DTMF
+    uint32_t* rowPtr,       ///< [OUT] Row lane
+    uint32_t* colPtr        ///< [OUT] Column lane
+)
+{
+    const char* keyPtr = (dtmf != '\0') ? strchr(DtmfKeys, toupper((unsigned char) dtmf)) : NULL;
+
+    if (keyPtr == NULL)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    *rowPtr = ROW_FIRST_LANE + (keyPtr - DtmfKeys) / GROUP_SIZE;
+    *colPtr = COL_FIRST_LANE + (keyPtr - DtmfKeys) % GROUP_SIZE;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Render a DTMF tone.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RenderTone
+(
+    uint32_t row,           ///< [IN] Row lane
+    uint32_t col,           ///< [IN] Column lane
+    int16_t* samplesPtr,    ///< [OUT] Samples buffer
+    uint32_t count          ///< [IN] Number of samples
+)
+{
+    const Rotator_t* lowPtr = &Rotator[row];
+    const Rotator_t* highPtr = &Rotator[col];
+    Vec8f_t sinLow = lowPtr->sinInit;
+    Vec8f_t cosLow = lowPtr->cosInit;
+    Vec8f_t sinHigh = highPtr->sinInit;
+    Vec8f_t cosHigh = highPtr->cosInit;
+    uint32_t n;
+    uint32_t k;
+
+    for (n = 0; n < count; n += VEC_LANES)
+    {
+        Vec8f_t out = (sinLow + sinHigh) * TONE_AMPLITUDE;
+        Vec8f_t tmp;
+        uint32_t lanes = ((count - n) < VEC_LANES) ? (count - n) : VEC_LANES;
+
+        for (k = 0; k < lanes; k++)
+        {
+            samplesPtr[n + k] = (int16_t) out[k];
+        }
+
+        tmp = sinLow * lowPtr->cosStep + cosLow * lowPtr->sinStep;
+        cosLow = cosLow * lowPtr->cosStep - sinLow * lowPtr->sinStep;
+        sinLow = tmp;
+
+        tmp = sinHigh * highPtr->cosStep + cosHigh * highPtr->sinStep;
+        cosHigh = cosHigh * highPtr->cosStep - sinHigh * highPtr->sinStep;
+        sinHigh = tmp;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the strongest tone of a group.
+ *
+ * @return true if the tone stands out of the other tones of the group.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool FindPeak
+(
+    const float* powerPtr,  ///< [IN] Powers of the group
+    uint32_t*    indexPtr   ///< [OUT] Index of the strongest tone in the group
+)
+{
+    uint32_t peak = 0;
+    uint32_t i;
+
+    for (i = 1; i < GROUP_SIZE; i++)
+    {
+        if (powerPtr[i] > powerPtr[peak])
+        {
+            peak = i;
+        }
+    }
+
+    for (i = 0; i < GROUP_SIZE; i++)
+    {
+        if ((i != peak) && ((powerPtr[i] * DETECT_MIN_PEAK_RATIO) > powerPtr[peak]))
+        {
+            return false;
+        }
+    }
+
+    *indexPtr = peak;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Analyse a complete Goertzel block.
+ *
+ * @return The detected DTMF, 0 if none.
+ */
+//--------------------------------------------------------------------------------------------------
+static char AnalyseBlock
+(
+    Detector_t*    detectorPtr, ///< [IN] Detector
+    const Vec8f_t* s1Ptr,       ///< [IN] Goertzel states at the end of the block
+    const Vec8f_t* s2Ptr
+)
+{
+    Vec8f_t s1 = *s1Ptr;
+    Vec8f_t s2 = *s2Ptr;
+    Vec8f_t power = s1 * s1 + s2 * s2 - GoertzelCoeff * s1 * s2;
+    float powers[VEC_LANES];
+    // Power of a tone holding the whole block energy
+    float fullPower = detectorPtr->energy * GOERTZEL_BLOCK_SIZE / 2;
+    uint32_t row;
+    uint32_t col;
+    uint32_t i;
+
+    for (i = 0; i < VEC_LANES; i++)
+    {
+        powers[i] = power[i];
+    }
+
+    if (detectorPtr->energy <
+        (DETECT_MIN_LEVEL * DETECT_MIN_LEVEL * GOERTZEL_BLOCK_SIZE))
+    {
+        return 0;
+    }
+
+    if (!FindPeak(powers + ROW_FIRST_LANE, &row) || !FindPeak(powers + COL_FIRST_LANE, &col))
+    {
+        return 0;
+    }
+
+    float rowPower = powers[ROW_FIRST_LANE + row];
+    float colPower = powers[COL_FIRST_LANE + col];
+
+    if (((rowPower + colPower) < (fullPower * DETECT_MIN_TONE_RATIO)) ||
+        (rowPower > (colPower * DETECT_MAX_TWIST)) ||
+        (colPower > (rowPower * DETECT_MAX_TWIST)))
+    {
+        return 0;
+    }
+
+    return DtmfKeys[row * GROUP_SIZE + col];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the DTMFs detected by the benchmark.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountDetection
+(
+    char dtmf           ///< [IN] Detected DTMF
+)
+{
+    BenchmarkDetections++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the elapsed time since a start time, in nanoseconds.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    const struct timespec* startPtr     ///< [IN] Start time
+)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)(now.tv_sec - startPtr->tv_sec) * 1000000000ULL +
+           now.tv_nsec - startPtr->tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the tones of a DTMF string: each DTMF lasts duration ms and is followed by pause ms of
+ * silence. With a NULL sample buffer, only the number of samples is returned.
+ *
+ * @return LE_BAD_PARAMETER An invalid DTMF is in the string.
+ * @return LE_OVERFLOW      The sample buffer is too small.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dtmfSimu_Generate
+(
+    const char* dtmfPtr,        ///< [IN] DTMFs to generate
+    uint32_t    duration,       ///< [IN] DTMF duration in milliseconds
+    uint32_t    pause,          ///< [IN] Pause between DTMFs in milliseconds
+    int16_t*    samplesPtr,     ///< [OUT] Samples buffer (may be NULL)
+    uint32_t*   countPtr        ///< [IN/OUT] Buffer size / generated samples count
+)
+{
+    uint32_t toneCount = (duration * PA_DTMFSIMU_SAMPLE_RATE) / 1000;
+    uint32_t pauseCount = (pause * PA_DTMFSIMU_SAMPLE_RATE) / 1000;
+    size_t dtmfLen = strlen(dtmfPtr);
+    uint32_t row;
+    uint32_t col;
+    size_t i;
+
+    for (i = 0; i < dtmfLen; i++)
+    {
+        if (GetDtmfLanes(dtmfPtr[i], &row, &col) != LE_OK)
+        {
+            LE_ERROR("Invalid DTMF '%c'", dtmfPtr[i]);
+            return LE_BAD_PARAMETER;
+        }
+    }
+
+    uint64_t total = (uint64_t) dtmfLen * (toneCount + pauseCount);
+
+    if (samplesPtr == NULL)
+    {
+        *countPtr = (total > UINT32_MAX) ? UINT32_MAX : total;
+        return LE_OK;
+    }
+
+    if (total > *countPtr)
+    {
+        return LE_OVERFLOW;
+    }
+
+    for (i = 0; i < dtmfLen; i++)
+    {
+        GetDtmfLanes(dtmfPtr[i], &row, &col);
+        RenderTone(row, col, samplesPtr, toneCount);
+        memset(samplesPtr + toneCount, 0, pauseCount * sizeof(int16_t));
+        samplesPtr += toneCount + pauseCount;
+    }
+
+    *countPtr = total;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a DTMF detector.
+ *
+ * @return The detector reference.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_dtmfSimu_DetectorRef_t pa_dtmfSimu_CreateDetector
+(
+    pa_dtmfSimu_DetectionFunc_t detectionFunc   ///< [IN] Function called on each detected DTMF
+)
+{
+    Detector_t* detectorPtr = le_mem_ForceAlloc(DetectorPool);
+
+    memset(detectorPtr, 0, sizeof(Detector_t));
+    detectorPtr->detectionFunc = detectionFunc;
+
+    return detectorPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a DTMF detector over PCM samples. The samples may be split in any way across calls.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_Detect
+(
+    pa_dtmfSimu_DetectorRef_t detectorRef,      ///< [IN] Detector
+    const int16_t*            samplesPtr,       ///< [IN] PCM samples
+    uint32_t                  count             ///< [IN] Number of samples
+)
+{
+    Detector_t* detectorPtr = detectorRef;
+    Vec8f_t s1;
+    Vec8f_t s2;
+    float energy = detectorPtr->energy;
+
+    memcpy(&s1, detectorPtr->s1, sizeof(s1));
+    memcpy(&s2, detectorPtr->s2, sizeof(s2));
+
+    while (count)
+    {
+        uint32_t len = GOERTZEL_BLOCK_SIZE - detectorPtr->sampleCount;
+        uint32_t n;
+
+        if (len > count)
+        {
+            len = count;
+        }
+
+        for (n = 0; n < len; n++)
+        {
+            float x = samplesPtr[n];
+            Vec8f_t s0 = GoertzelCoeff * s1 - s2 + x;
+
+            s2 = s1;
+            s1 = s0;
+            energy += x * x;
+        }
+
+        samplesPtr += len;
+        count -= len;
+        detectorPtr->sampleCount += len;
+
+        if (detectorPtr->sampleCount == GOERTZEL_BLOCK_SIZE)
+        {
+            detectorPtr->energy = energy;
+
+            char dtmf = AnalyseBlock(detectorPtr, &s1, &s2);
+
+            // Report a DTMF once, when it starts
+            if (dtmf && (dtmf != detectorPtr->lastDtmf) && detectorPtr->detectionFunc)
+            {
+                detectorPtr->detectionFunc(dtmf);
+            }
+            detectorPtr->lastDtmf = dtmf;
+
+            s1 = (Vec8f_t){ 0 };
+            s2 = (Vec8f_t){ 0 };
+            energy = 0;
+            detectorPtr->sampleCount = 0;
+        }
+    }
+
+    memcpy(detectorPtr->s1, &s1, sizeof(s1));
+    memcpy(detectorPtr->s2, &s2, sizeof(s2));
+    detectorPtr->energy = energy;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a DTMF detector.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_DeleteDetector
+(
+    pa_dtmfSimu_DetectorRef_t detectorRef       ///< [IN] Detector
+)
+{
+    le_mem_Release(detectorRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of the generator and of the detector, in voice frames per second.
+ *
+ * The signal is a cycle over all the DTMFs, 60 ms tones followed by 40 ms pauses.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_RunBenchmark
+(
+    uint32_t  frameCount,           ///< [IN] Number of voice frames to process
+    uint32_t* generatorFpsPtr,      ///< [OUT] Generated frames per second
+    uint32_t* detectorFpsPtr        ///< [OUT] Analysed frames per second
+)
+{
+    uint32_t dtmfSamples = 0;
+    uint32_t dtmfCount;
+    uint32_t i;
+    struct timespec start;
+    uint64_t elapsedNs;
+
+    pa_dtmfSimu_Generate("0", 60, 40, NULL, &dtmfSamples);
+    dtmfCount = ((uint64_t) frameCount * PA_DTMFSIMU_FRAME_SAMPLES + dtmfSamples - 1) /
+                dtmfSamples;
+
+    uint32_t total = dtmfCount * dtmfSamples;
+    int16_t* samplesPtr = malloc(total * sizeof(int16_t));
+
+    LE_ASSERT(samplesPtr != NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < dtmfCount; i++)
+    {
+        char dtmf[2] = { DtmfKeys[i % (sizeof(DtmfKeys) - 1)], '\0' };
+        uint32_t count = dtmfSamples;
+
+        pa_dtmfSimu_Generate(dtmf, 60, 40, samplesPtr + i * dtmfSamples, &count);
+    }
+    elapsedNs = GetElapsedNs(&start);
+    *generatorFpsPtr = (elapsedNs != 0) ?
+        (uint64_t) total / PA_DTMFSIMU_FRAME_SAMPLES * 1000000000ULL / elapsedNs : UINT32_MAX;
+
+    pa_dtmfSimu_DetectorRef_t detectorRef = pa_dtmfSimu_CreateDetector(CountDetection);
+
+    BenchmarkDetections = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; (i + PA_DTMFSIMU_FRAME_SAMPLES) <= total; i += PA_DTMFSIMU_FRAME_SAMPLES)
+    {
+        pa_dtmfSimu_Detect(detectorRef, samplesPtr + i, PA_DTMFSIMU_FRAME_SAMPLES);
+    }
+    elapsedNs = GetElapsedNs(&start);
+    *detectorFpsPtr = (elapsedNs != 0) ?
+        (uint64_t) total / PA_DTMFSIMU_FRAME_SAMPLES * 1000000000ULL / elapsedNs : UINT32_MAX;
+
+    pa_dtmfSimu_DeleteDetector(detectorRef);
+    free(samplesPtr);
+
+    LE_INFO("DTMF benchmark: %u frames, generator %u frames/s, detector %u frames/s (%u/%u DTMF)",
+            total / PA_DTMFSIMU_FRAME_SAMPLES, *generatorFpsPtr, *detectorFpsPtr,
+            BenchmarkDetections, dtmfCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_dtmf simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_Init
+(
+    void
+)
+{
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0; i < VEC_LANES; i++)
+    {
+        double w = 2 * M_PI * DtmfFrequency[i] / PA_DTMFSIMU_SAMPLE_RATE;
+
+        GoertzelCoeff[i] = 2 * cos(w);
+
+        for (k = 0; k < VEC_LANES; k++)
+        {
+            Rotator[i].sinInit[k] = sin(w * k);
+            Rotator[i].cosInit[k] = cos(w * k);
+        }
+        Rotator[i].sinStep = sin(w * VEC_LANES);
+        Rotator[i].cosStep = cos(w * VEC_LANES);
+    }
+
+    DetectorPool = le_mem_CreatePool("DtmfDetectorPool", sizeof(Detector_t));
+    le_mem_ExpandPool(DetectorPool, DETECTOR_POOL_SIZE);
+}
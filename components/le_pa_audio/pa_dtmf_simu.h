@@ -0,0 +1,124 @@
+/** @file pa_dtmf_simu.h
+ *
+ * Legato @ref pa_dtmf_simu include file.
+ *
+ * DTMF tone generator and detector of the simulated audio DSP. The signals are 16-bit mono PCM
+ * samples at PA_DTMFSIMU_SAMPLE_RATE.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_DTMF_SIMU_H_INCLUDE_GUARD
+#define PA_DTMF_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample rate of the DTMF signals (narrowband voice).
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_DTMFSIMU_SAMPLE_RATE     8000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Samples per voice frame (20 ms).
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_DTMFSIMU_FRAME_SAMPLES   160
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference type for a DTMF detector.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_dtmfSimu_Detector* pa_dtmfSimu_DetectorRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prototype of the function called for each detected DTMF.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*pa_dtmfSimu_DetectionFunc_t)
+(
+    char dtmf           ///< [IN] Detected DTMF
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_dtmf simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate the tones of a DTMF string: each DTMF lasts duration ms and is followed by pause ms of
+ * silence. With a NULL sample buffer, only the number of samples is returned.
+ *
+ * @return LE_BAD_PARAMETER An invalid DTMF is in the string.
+ * @return LE_OVERFLOW      The sample buffer is too small.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_dtmfSimu_Generate
+(
+    const char* dtmfPtr,        ///< [IN] DTMFs to generate
+    uint32_t    duration,       ///< [IN] DTMF duration in milliseconds
+    uint32_t    pause,          ///< [IN] Pause between DTMFs in milliseconds
+    int16_t*    samplesPtr,     ///< [OUT] Samples buffer (may be NULL)
+    uint32_t*   countPtr        ///< [IN/OUT] Buffer size / generated samples count
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a DTMF detector.
+ *
+ * @return The detector reference.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_dtmfSimu_DetectorRef_t pa_dtmfSimu_CreateDetector
+(
+    pa_dtmfSimu_DetectionFunc_t detectionFunc   ///< [IN] Function called on each detected DTMF
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a DTMF detector over PCM samples. The samples may be split in any way across calls.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_Detect
+(
+    pa_dtmfSimu_DetectorRef_t detectorRef,      ///< [IN] Detector
+    const int16_t*            samplesPtr,       ///< [IN] PCM samples
+    uint32_t                  count             ///< [IN] Number of samples
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a DTMF detector.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_DeleteDetector
+(
+    pa_dtmfSimu_DetectorRef_t detectorRef       ///< [IN] Detector
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of the generator and of the detector, in voice frames per second.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_dtmfSimu_RunBenchmark
+(
+    uint32_t  frameCount,           ///< [IN] Number of voice frames to process
+    uint32_t* generatorFpsPtr,      ///< [OUT] Generated frames per second
+    uint32_t* detectorFpsPtr        ///< [OUT] Analysed frames per second
+);
+
+#endif
@@ -12,29 +12,1133 @@
 #include "pa_audio.h"
 #include "pa_pcm.h"
 
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Period size in bytes, i.e. the amount of data exchanged with the media threads at each tick of
+ * the simulated sample clock.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PERIOD_SIZE             3000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default PCM configuration used when the caller does not provide a usable one.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SAMPLE_RATE     16000
+#define DEFAULT_CHANNELS_COUNT  1
+#define DEFAULT_BITS_PER_SAMPLE 16
+
+#define NSEC_PER_SEC            1000000000ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default depth of the simulated device FIFO, in periods.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_FIFO_DEPTH      4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times per period the media side of the FIFO is serviced.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FIFO_POLLS_PER_PERIOD   4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of PCM streams preallocated in the stream pool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PCM_STREAM_POOL_SIZE    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Single producer / single consumer lock-free ring buffer.
+ *
+ * The size is a power of two and the indexes are free running: the fill level is head - tail.
+ * The head is only updated by the producer and the tail only by the consumer, each with release
+ * semantics so that the other side observes the data before the index.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t*  bufferPtr;                            ///< Ring storage
+    uint32_t  size;                                 ///< Ring size in bytes (power of two)
+    uint32_t  head __attribute__((aligned(64)));    ///< Write index, updated by the producer
+    uint32_t  tail __attribute__((aligned(64)));    ///< Read index, updated by the consumer
+}
+RingBuffer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Device string prefixes selecting a file or socket endpoint instead of the simulated data buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ENDPOINT_PREFIX_WAV     "wav:"
+#define ENDPOINT_PREFIX_RAW     "raw:"
+#define ENDPOINT_PREFIX_UNIX    "unix:"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the canonical WAV header written to the WAV sinks.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WAV_HEADER_SIZE         44
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Endpoint backing the simulated device.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ENDPOINT_BUFFER,        ///< Simulated data buffer, see pa_pcmSimu_InitData()
+    ENDPOINT_WAV,           ///< WAV file
+    ENDPOINT_RAW,           ///< Raw PCM file
+    ENDPOINT_SOCKET         ///< UNIX stream socket
+}
+EndpointType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Endpoint context.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    EndpointType_t  type;           ///< Endpoint type
+    int             fd;             ///< File or socket descriptor
+    int             pipeFd[2];      ///< Pipe splicing the frames played to a file, -1 if not used
+    uint32_t        sampleRate;     ///< PCM configuration
+    uint32_t        channelsCount;
+    uint32_t        bitsPerSample;
+    uint32_t        dataLen;        ///< Number of bytes written to the sink
+    bool            isPlayback;     ///< Sink (playback) or source (capture)
+    bool            isFaulty;       ///< An I/O error has already been reported
+}
+Endpoint_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PCM stream, i.e. the object behind a PCM handle.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;                           ///< Link in the stream list
+    bool                isPlayback;                     ///< Playback or capture stream
+    Endpoint_t          endpoint;                       ///< Endpoint selected by the device
+    uint64_t            periodNs;                       ///< Period duration in nanoseconds
+    RingBuffer_t        fifo;                           ///< FIFO of the simulated device
+    le_thread_Ref_t     pcmThreadRef;                   ///< Device (sample clock) thread
+    le_thread_Ref_t     fifoThreadRef;                  ///< Media side thread
+    GetSetFramesFunc_t  getSetFramesFunc;               ///< Media layer callbacks
+    ResultFunc_t        resultFunc;
+    void*               handlerContextPtr;
+    uint8_t*            dataPtr;                        ///< Simulated data buffer
+    uint32_t            dataLen;                        ///< Size of the simulated data buffer
+    uint32_t            dataIndex;                      ///< Position in the simulated data buffer
+    le_sem_Ref_t*       semaphorePtr;                   ///< Posted at the end of the capture
+    bool                mediaStarted;                   ///< Media side serviced at least once
+    bool                sourceDone;                     ///< All captured frames are in the FIFO
+    uint32_t            underrunCount;
+    uint32_t            overrunCount;
+    uint8_t             discardBuffer[PERIOD_SIZE];     ///< Receives the dropped frames
+}
+PcmStream_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulated data buffer and end of capture semaphore, given to the streams started afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* DataPtr = NULL;
+static uint32_t DataLen=0;
+static le_sem_Ref_t*    RecSemaphorePtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool and list of the PCM streams.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PcmStreamPool;
+static le_dls_List_t PcmStreamList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * FIFO depth in periods, applied to the streams started afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FifoDepth = DEFAULT_FIFO_DEPTH;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of xruns detected on all the streams.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t UnderrunCount = 0;
+static uint32_t OverrunCount = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate the ring buffer storage. The size is rounded up to the next power of two.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingInit
+(
+    RingBuffer_t* ringPtr,      ///< [IN] Ring buffer
+    uint32_t      minSize       ///< [IN] Minimum size in bytes
+)
+{
+    uint32_t size = 1;
+
+    while (size < minSize)
+    {
+        size <<= 1;
+    }
+
+    ringPtr->bufferPtr = malloc(size);
+    LE_ASSERT(ringPtr->bufferPtr != NULL);
+    ringPtr->size = size;
+    ringPtr->head = 0;
+    ringPtr->tail = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the ring buffer storage.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingRelease
+(
+    RingBuffer_t* ringPtr       ///< [IN] Ring buffer
+)
+{
+    free(ringPtr->bufferPtr);
+    memset(ringPtr, 0, sizeof(RingBuffer_t));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes stored in the ring buffer.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RingFill
+(
+    RingBuffer_t* ringPtr       ///< [IN] Ring buffer
+)
+{
+    return __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Producer side: get the contiguous free area of the ring buffer.
+ *
+ * @return Pointer to the free area, its length is returned in lenPtr.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* RingPeekWrite
+(
+    RingBuffer_t* ringPtr,      ///< [IN] Ring buffer
+    uint32_t*     lenPtr        ///< [OUT] Contiguous free length
+)
+{
+    uint32_t head = __atomic_load_n(&ringPtr->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&ringPtr->tail, __ATOMIC_ACQUIRE);
+    uint32_t offset = head & (ringPtr->size - 1);
+    uint32_t space = ringPtr->size - (head - tail);
+
+    *lenPtr = (space < (ringPtr->size - offset)) ? space : (ringPtr->size - offset);
+
+    return ringPtr->bufferPtr + offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Producer side: publish bytes written in the area returned by RingPeekWrite().
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingCommitWrite
+(
+    RingBuffer_t* ringPtr,      ///< [IN] Ring buffer
+    uint32_t      len           ///< [IN] Number of bytes written
+)
+{
+    uint32_t head = __atomic_load_n(&ringPtr->head, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&ringPtr->head, head + len, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Consumer side: get the contiguous used area of the ring buffer.
+ *
+ * @return Pointer to the used area, its length is returned in lenPtr.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* RingPeekRead
+(
+    RingBuffer_t* ringPtr,      ///< [IN] Ring buffer
+    uint32_t*     lenPtr        ///< [OUT] Contiguous used length
+)
+{
+    uint32_t tail = __atomic_load_n(&ringPtr->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&ringPtr->head, __ATOMIC_ACQUIRE);
+    uint32_t offset = tail & (ringPtr->size - 1);
+    uint32_t used = head - tail;
+
+    *lenPtr = (used < (ringPtr->size - offset)) ? used : (ringPtr->size - offset);
+
+    return ringPtr->bufferPtr + offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Consumer side: release bytes read from the area returned by RingPeekRead().
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingCommitRead
+(
+    RingBuffer_t* ringPtr,      ///< [IN] Ring buffer
+    uint32_t      len           ///< [IN] Number of bytes read
+)
+{
+    uint32_t tail = __atomic_load_n(&ringPtr->tail, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&ringPtr->tail, tail + len, __ATOMIC_RELEASE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Producer side: copy data into the ring buffer.
+ *
+ * @return Number of bytes copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RingWrite
+(
+    RingBuffer_t*  ringPtr,     ///< [IN] Ring buffer
+    const uint8_t* srcPtr,      ///< [IN] Data to copy
+    uint32_t       len          ///< [IN] Length of the data
+)
+{
+    uint32_t written = 0;
+
+    while (written < len)
+    {
+        uint32_t chunk;
+        uint8_t* dstPtr = RingPeekWrite(ringPtr, &chunk);
+
+        if (chunk == 0)
+        {
+            break;
+        }
+        if (chunk > (len - written))
+        {
+            chunk = len - written;
+        }
+
+        memcpy(dstPtr, srcPtr + written, chunk);
+        RingCommitWrite(ringPtr, chunk);
+        written += chunk;
+    }
+
+    return written;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Consumer side: copy data out of the ring buffer.
+ *
+ * @return Number of bytes copied.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RingRead
+(
+    RingBuffer_t* ringPtr,      ///< [IN] Ring buffer
+    uint8_t*      dstPtr,       ///< [OUT] Destination buffer
+    uint32_t      len           ///< [IN] Length to read
+)
+{
+    uint32_t read = 0;
+
+    while (read < len)
+    {
+        uint32_t chunk;
+        uint8_t* srcPtr = RingPeekRead(ringPtr, &chunk);
+
+        if (chunk == 0)
+        {
+            break;
+        }
+        if (chunk > (len - read))
+        {
+            chunk = len - read;
+        }
+
+        memcpy(dstPtr + read, srcPtr, chunk);
+        RingCommitRead(ringPtr, chunk);
+        read += chunk;
+    }
+
+    return read;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the period duration from the PCM configuration.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPeriodTiming
+(
+    PcmStream_t*                streamPtr,  ///< [IN] PCM stream
+    le_audio_SamplePcmConfig_t* pcmConfig   ///< [IN] Samples PCM configuration (may be NULL)
+)
+{
+    uint32_t sampleRate = DEFAULT_SAMPLE_RATE;
+    uint32_t channelsCount = DEFAULT_CHANNELS_COUNT;
+    uint32_t bitsPerSample = DEFAULT_BITS_PER_SAMPLE;
+
+    if (pcmConfig != NULL)
+    {
+        if (pcmConfig->sampleRate)
+        {
+            sampleRate = pcmConfig->sampleRate;
+        }
+        if (pcmConfig->channelsCount)
+        {
+            channelsCount = pcmConfig->channelsCount;
+        }
+        if (pcmConfig->bitsPerSample >= 8)
+        {
+            bitsPerSample = pcmConfig->bitsPerSample;
+        }
+    }
+
+    uint64_t bytesPerSec = (uint64_t) sampleRate * channelsCount * ((bitsPerSample + 7) / 8);
+
+    streamPtr->periodNs = (PERIOD_SIZE * NSEC_PER_SEC) / bytesPerSec;
+
+    LE_DEBUG("Period: %d bytes, %"PRIu64" ns (%d Hz, %d ch, %d bits)",
+             PERIOD_SIZE, streamPtr->periodNs, sampleRate, channelsCount, bitsPerSample);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a duration to a timespec.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddNs
+(
+    struct timespec* timePtr,   ///< [IN/OUT] Time to update
+    uint64_t         ns         ///< [IN] Duration to add in nanoseconds
+)
+{
+    uint64_t nsec = timePtr->tv_nsec + ns;
+
+    timePtr->tv_sec += nsec / NSEC_PER_SEC;
+    timePtr->tv_nsec = nsec % NSEC_PER_SEC;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for the next tick of the simulated sample clock.
+ *
+ * The deadline is absolute so that the time spent in the callbacks does not make the clock drift.
+ * clock_nanosleep() is a cancellation point, so the thread can be cancelled while waiting.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitNextPeriod
+(
+    PcmStream_t*     streamPtr,     ///< [IN] PCM stream
+    struct timespec* deadlinePtr    ///< [IN/OUT] Deadline of the current period
+)
+{
+    AddNs(deadlinePtr, streamPtr->periodNs);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadlinePtr, NULL) == EINTR);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Let the media side thread wait before polling the FIFO again.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void WaitFifoPoll
+(
+    PcmStream_t* streamPtr          ///< [IN] PCM stream
+)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    AddNs(&deadline, streamPtr->periodNs / FIFO_POLLS_PER_PERIOD);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a little-endian value in a header.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutLe
+(
+    uint8_t* dstPtr,        ///< [OUT] Destination
+    uint32_t value,         ///< [IN] Value
+    uint32_t size           ///< [IN] Size of the value in bytes
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        dstPtr[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load a little-endian value from a header.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetLe
+(
+    const uint8_t* srcPtr,  ///< [IN] Source
+    uint32_t       size     ///< [IN] Size of the value in bytes
+)
+{
+    uint32_t value = 0;
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        value |= (uint32_t) srcPtr[i] << (8 * i);
+    }
+
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read exactly len bytes from a file descriptor.
+ *
+ * @return LE_OK on success, LE_FAULT on error or end of file.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadFull
+(
+    int      fd,            ///< [IN] File descriptor
+    uint8_t* bufPtr,        ///< [OUT] Destination buffer
+    uint32_t len            ///< [IN] Length to read
+)
+{
+    while (len)
+    {
+        ssize_t n = read(fd, bufPtr, len);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return LE_FAULT;
+        }
+
+        bufPtr += n;
+        len -= n;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the WAV header of a sink. The sizes are patched when the endpoint is closed.
+ *
+ * @return LE_OK on success, LE_FAULT on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteWavHeader
+(
+    Endpoint_t* epPtr       ///< [IN] Endpoint
+)
+{
+    uint8_t header[WAV_HEADER_SIZE];
+    uint32_t blockAlign = epPtr->channelsCount * ((epPtr->bitsPerSample + 7) / 8);
+
+    memcpy(header, "RIFF", 4);
+    PutLe(header + 4, 36 + epPtr->dataLen, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    PutLe(header + 16, 16, 4);                                  // fmt chunk size
+    PutLe(header + 20, 1, 2);                                   // PCM format
+    PutLe(header + 22, epPtr->channelsCount, 2);
+    PutLe(header + 24, epPtr->sampleRate, 4);
+    PutLe(header + 28, epPtr->sampleRate * blockAlign, 4);      // byte rate
+    PutLe(header + 32, blockAlign, 2);
+    PutLe(header + 34, epPtr->bitsPerSample, 2);
+    memcpy(header + 36, "data", 4);
+    PutLe(header + 40, epPtr->dataLen, 4);
+
+    if (pwrite(epPtr->fd, header, sizeof(header), 0) != sizeof(header))
+    {
+        LE_ERROR("Cannot write WAV header: %m");
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the WAV header of a source and leave the file offset at the start of the samples.
+ *
+ * @return LE_OK on success, LE_FORMAT_ERROR if the file is not a PCM WAV file.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadWavHeader
+(
+    Endpoint_t* epPtr       ///< [IN] Endpoint
+)
+{
+    uint8_t chunk[16];
+
+    if ((ReadFull(epPtr->fd, chunk, 12) != LE_OK) ||
+        (memcmp(chunk, "RIFF", 4) != 0) ||
+        (memcmp(chunk + 8, "WAVE", 4) != 0))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    while (ReadFull(epPtr->fd, chunk, 8) == LE_OK)
+    {
+        uint32_t chunkLen = GetLe(chunk + 4, 4);
+
+        if (memcmp(chunk, "data", 4) == 0)
+        {
+            return LE_OK;
+        }
+
+        if ((memcmp(chunk, "fmt ", 4) == 0) && (chunkLen >= 16))
+        {
+            if (ReadFull(epPtr->fd, chunk, 16) != LE_OK)
+            {
+                break;
+            }
+            if (GetLe(chunk, 2) != 1)
+            {
+                LE_ERROR("Only PCM WAV files are supported");
+                break;
+            }
+
+            uint32_t channelsCount = GetLe(chunk + 2, 2);
+            uint32_t sampleRate = GetLe(chunk + 4, 4);
+            uint32_t bitsPerSample = GetLe(chunk + 14, 2);
+
+            if ((channelsCount != epPtr->channelsCount) ||
+                (sampleRate != epPtr->sampleRate) ||
+                (bitsPerSample != epPtr->bitsPerSample))
+            {
+                LE_WARN("WAV source is %d Hz, %d ch, %d bits, device configured with "
+                        "%d Hz, %d ch, %d bits", sampleRate, channelsCount, bitsPerSample,
+                        epPtr->sampleRate, epPtr->channelsCount, epPtr->bitsPerSample);
+            }
+
+            chunkLen -= 16;
+        }
+
+        // Skip the rest of the chunk, chunks are word aligned
+        if (lseek(epPtr->fd, chunkLen + (chunkLen & 1), SEEK_CUR) < 0)
+        {
+            break;
+        }
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the endpoint selected by the device string.
+ *
+ * Device strings starting with "wav:", "raw:" or "unix:" followed by a path select a WAV file, a
+ * raw PCM file or a UNIX stream socket. Any other device string selects the simulated data buffer.
+ *
+ * @return LE_OK on success, LE_FAULT or LE_FORMAT_ERROR on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EndpointOpen
+(
+    Endpoint_t*                 epPtr,          ///< [OUT] Endpoint
+    const char*                 devicePtr,      ///< [IN] Device string
+    le_audio_SamplePcmConfig_t* pcmConfig,      ///< [IN] Samples PCM configuration (may be NULL)
+    bool                        isPlayback      ///< [IN] Sink (playback) or source (capture)
+)
+{
+    const char* pathPtr = NULL;
+
+    memset(epPtr, 0, sizeof(Endpoint_t));
+    epPtr->type = ENDPOINT_BUFFER;
+    epPtr->fd = -1;
+    epPtr->pipeFd[0] = -1;
+    epPtr->pipeFd[1] = -1;
+    epPtr->isPlayback = isPlayback;
+    epPtr->sampleRate = (pcmConfig && pcmConfig->sampleRate) ?
+                        pcmConfig->sampleRate : DEFAULT_SAMPLE_RATE;
+    epPtr->channelsCount = (pcmConfig && pcmConfig->channelsCount) ?
+                           pcmConfig->channelsCount : DEFAULT_CHANNELS_COUNT;
+    epPtr->bitsPerSample = (pcmConfig && (pcmConfig->bitsPerSample >= 8)) ?
+                           pcmConfig->bitsPerSample : DEFAULT_BITS_PER_SAMPLE;
+
+    if (devicePtr == NULL)
+    {
+        return LE_OK;
+    }
+    else if (strncmp(devicePtr, ENDPOINT_PREFIX_WAV, strlen(ENDPOINT_PREFIX_WAV)) == 0)
+    {
+        epPtr->type = ENDPOINT_WAV;
+        pathPtr = devicePtr + strlen(ENDPOINT_PREFIX_WAV);
+    }
+    else if (strncmp(devicePtr, ENDPOINT_PREFIX_RAW, strlen(ENDPOINT_PREFIX_RAW)) == 0)
+    {
+        epPtr->type = ENDPOINT_RAW;
+        pathPtr = devicePtr + strlen(ENDPOINT_PREFIX_RAW);
+    }
+    else if (strncmp(devicePtr, ENDPOINT_PREFIX_UNIX, strlen(ENDPOINT_PREFIX_UNIX)) == 0)
+    {
+        epPtr->type = ENDPOINT_SOCKET;
+        pathPtr = devicePtr + strlen(ENDPOINT_PREFIX_UNIX);
+    }
+    else
+    {
+        return LE_OK;
+    }
+
+    if (epPtr->type == ENDPOINT_SOCKET)
+    {
+        struct sockaddr_un addr;
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (le_utf8_Copy(addr.sun_path, pathPtr, sizeof(addr.sun_path), NULL) != LE_OK)
+        {
+            LE_ERROR("Socket path too long: %s", pathPtr);
+            return LE_FAULT;
+        }
+
+        epPtr->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if ((epPtr->fd < 0) ||
+            (connect(epPtr->fd, (struct sockaddr*) &addr, sizeof(addr)) != 0))
+        {
+            LE_ERROR("Cannot connect to %s: %m", pathPtr);
+            goto error;
+        }
+    }
+    else
+    {
+        int flags = isPlayback ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY;
+
+        epPtr->fd = open(pathPtr, flags | O_CLOEXEC, 0644);
+        if (epPtr->fd < 0)
+        {
+            LE_ERROR("Cannot open %s: %m", pathPtr);
+            goto error;
+        }
+
+        if (epPtr->type == ENDPOINT_WAV)
+        {
+            le_result_t res = isPlayback ? WriteWavHeader(epPtr) : ReadWavHeader(epPtr);
+
+            if (res != LE_OK)
+            {
+                LE_ERROR("Bad WAV file %s", pathPtr);
+                close(epPtr->fd);
+                epPtr->fd = -1;
+                epPtr->type = ENDPOINT_BUFFER;
+                return LE_FORMAT_ERROR;
+            }
+
+            if (isPlayback && (lseek(epPtr->fd, WAV_HEADER_SIZE, SEEK_SET) < 0))
+            {
+                goto error;
+            }
+        }
+    }
+
+    // The frames played to files are handed to the kernel with vmsplice()/splice() to avoid
+    // copies. Sockets use send(): spliced pages could still be referenced by the socket buffers
+    // when the FIFO reuses them.
+    if (isPlayback && (epPtr->type != ENDPOINT_SOCKET) &&
+        (pipe2(epPtr->pipeFd, O_CLOEXEC) != 0))
+    {
+        epPtr->pipeFd[0] = -1;
+        epPtr->pipeFd[1] = -1;
+    }
+
+    LE_INFO("PCM %s endpoint: %s", isPlayback ? "playback" : "capture", devicePtr);
+
+    return LE_OK;
+
+error:
+    if (epPtr->fd >= 0)
+    {
+        close(epPtr->fd);
+    }
+    epPtr->fd = -1;
+    epPtr->type = ENDPOINT_BUFFER;
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the endpoint. The sizes of a WAV sink are updated.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndpointClose
+(
+    Endpoint_t* epPtr       ///< [IN] Endpoint
+)
+{
+    if ((epPtr->type == ENDPOINT_WAV) && epPtr->isPlayback)
+    {
+        WriteWavHeader(epPtr);
+    }
+
+    if (epPtr->fd >= 0)
+    {
+        close(epPtr->fd);
+    }
+    if (epPtr->pipeFd[0] >= 0)
+    {
+        close(epPtr->pipeFd[0]);
+        close(epPtr->pipeFd[1]);
+    }
+
+    epPtr->type = ENDPOINT_BUFFER;
+    epPtr->fd = -1;
+    epPtr->pipeFd[0] = -1;
+    epPtr->pipeFd[1] = -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write played frames to the endpoint.
+ *
+ * The frames played to files are first mapped into the pipe with vmsplice() then spliced to the
+ * file, so that they are not copied through an intermediate user buffer. Sockets have no pipe and
+ * are written with send(). If a file does not support splicing, the function falls back to
+ * write().
+ *
+ * @return LE_OK on success, LE_FAULT on error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t EndpointWrite
+(
+    Endpoint_t* epPtr,      ///< [IN] Endpoint
+    uint8_t*    dataPtr,    ///< [IN] Frames to write
+    uint32_t    len         ///< [IN] Length of the frames
+)
+{
+    while (len && (epPtr->pipeFd[1] >= 0))
+    {
+        struct iovec iov = { .iov_base = dataPtr, .iov_len = len };
+        ssize_t mapped = vmsplice(epPtr->pipeFd[1], &iov, 1, 0);
+
+        if (mapped <= 0)
+        {
+            break;
+        }
+
+        ssize_t left = mapped;
+        while (left)
+        {
+            ssize_t n = splice(epPtr->pipeFd[0], NULL, epPtr->fd, NULL, left, SPLICE_F_MOVE);
+
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            left -= n;
+        }
+
+        if (left)
+        {
+            // Splicing is not supported by this endpoint: stop using the pipe, the frames left
+            // in it are dropped with it and written again below.
+            LE_DEBUG("splice() not supported (%m), using write()");
+            close(epPtr->pipeFd[0]);
+            close(epPtr->pipeFd[1]);
+            epPtr->pipeFd[0] = -1;
+            epPtr->pipeFd[1] = -1;
+            mapped -= left;
+        }
+
+        epPtr->dataLen += mapped;
+        dataPtr += mapped;
+        len -= mapped;
+    }
+
+    while (len)
+    {
+        ssize_t n = (epPtr->type == ENDPOINT_SOCKET) ? send(epPtr->fd, dataPtr, len, MSG_NOSIGNAL)
+                                                      : write(epPtr->fd, dataPtr, len);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return LE_FAULT;
+        }
+
+        epPtr->dataLen += n;
+        dataPtr += n;
+        len -= n;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Play one period from the FIFO to the endpoint.
+ *
+ * @return Number of bytes played.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t EndpointPlay
+(
+    Endpoint_t*   epPtr,    ///< [IN] Endpoint
+    RingBuffer_t* ringPtr,  ///< [IN] FIFO
+    uint32_t      len       ///< [IN] Length to play
+)
+{
+    uint32_t played = 0;
+
+    while (played < len)
+    {
+        uint32_t chunk;
+        uint8_t* readPtr = RingPeekRead(ringPtr, &chunk);
+
+        if (chunk == 0)
+        {
+            break;
+        }
+        if (chunk > (len - played))
+        {
+            chunk = len - played;
+        }
+
+        if ((EndpointWrite(epPtr, readPtr, chunk) != LE_OK) && (!epPtr->isFaulty))
+        {
+            // Frames are dropped, as a real device would do when its output is broken
+            LE_ERROR("Cannot write to PCM endpoint: %m");
+            epPtr->isFaulty = true;
+        }
+
+        RingCommitRead(ringPtr, chunk);
+        played += chunk;
+    }
+
+    return played;
+}
+
 //--------------------------------------------------------------------------------------------------
-// Symbol and Enum definitions.
+/**
+ * Capture one period from the endpoint into the FIFO.
+ *
+ * The frames are read in place into the FIFO. If the FIFO is full, the remaining frames of the
+ * period are read and dropped.
+ *
+ * @return Number of bytes sampled, 0 at the end of the source.
+ */
 //--------------------------------------------------------------------------------------------------
+static uint32_t EndpointCapture
+(
+    Endpoint_t*   epPtr,        ///< [IN] Endpoint
+    RingBuffer_t* ringPtr,      ///< [IN] FIFO
+    uint32_t      len,          ///< [IN] Length to capture
+    uint8_t*      discardPtr,   ///< [IN] Buffer receiving the dropped frames, at least len bytes
+    bool*         isOverrunPtr  ///< [OUT] Some frames could not be stored in the FIFO
+)
+{
+    uint32_t captured = 0;
+
+    *isOverrunPtr = false;
+
+    while (captured < len)
+    {
+        uint32_t chunk;
+        uint8_t* writePtr = RingPeekWrite(ringPtr, &chunk);
+
+        if (chunk == 0)
+        {
+            *isOverrunPtr = true;
+            writePtr = discardPtr;
+            chunk = len;
+        }
+        if (chunk > (len - captured))
+        {
+            chunk = len - captured;
+        }
+
+        ssize_t n = read(epPtr->fd, writePtr, chunk);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
 
-#define PACKET_SIZE 10
+        if (!(*isOverrunPtr))
+        {
+            RingCommitWrite(ringPtr, n);
+        }
+        captured += n;
+    }
+
+    return captured;
+}
 
 //--------------------------------------------------------------------------------------------------
-//                                       Static declarations
+/**
+ * Get the PCM stream of a handle.
+ *
+ */
 //--------------------------------------------------------------------------------------------------
+static PcmStream_t* GetStream
+(
+    pcm_Handle_t pcmHandle          ///< [IN] PCM handle
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&PcmStreamList);
 
-static uint8_t* DataPtr = NULL;
-static uint32_t DataLen=0;
-static uint32_t DataIndex=0;
-static intptr_t PcmHandle = 0xBADCAFE;
-static le_sem_Ref_t*    RecSemaphorePtr = NULL;
-static le_thread_Ref_t PcmThreadRef = NULL;
-static GetSetFramesFunc_t GetSetFramesFunc = NULL;
-static ResultFunc_t ResultFunc = NULL;
-static void* HandlerContextPtr = NULL;
+    while (linkPtr != NULL)
+    {
+        PcmStream_t* streamPtr = CONTAINER_OF(linkPtr, PcmStream_t, link);
+
+        if ((pcm_Handle_t) streamPtr == pcmHandle)
+        {
+            return streamPtr;
+        }
+
+        linkPtr = le_dls_PeekNext(&PcmStreamList, linkPtr);
+    }
+
+    LE_FATAL("Invalid PCM handle %p", (void*) pcmHandle);
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count an underrun or an overrun, and report it to the media layer.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportXrun
+(
+    PcmStream_t* streamPtr,         ///< [IN] PCM stream
+    le_result_t  res                ///< [IN] Result reported to the media layer
+)
+{
+    if (streamPtr->isPlayback)
+    {
+        streamPtr->underrunCount++;
+        __atomic_add_fetch(&UnderrunCount, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        streamPtr->overrunCount++;
+        __atomic_add_fetch(&OverrunCount, 1, __ATOMIC_RELAXED);
+    }
+
+    LE_ASSERT(streamPtr->resultFunc != NULL);
+    streamPtr->resultFunc(res, streamPtr->handlerContextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Playback media thread: pull the frames to play from the media layer into the FIFO.
+ *
+ * The frames are written in place in the FIFO, without intermediate copy.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PlaybackFifoThread
+(
+    void* contextPtr
+)
+{
+    PcmStream_t* streamPtr = contextPtr;
+
+    LE_ASSERT(streamPtr->getSetFramesFunc != NULL);
+
+    while (1)
+    {
+        uint32_t space;
+        uint8_t* writePtr = RingPeekWrite(&streamPtr->fifo, &space);
+
+        if (space)
+        {
+            uint32_t len = (space < PERIOD_SIZE) ? space : PERIOD_SIZE;
+
+            LE_ASSERT( streamPtr->getSetFramesFunc(writePtr, &len,
+                                                   streamPtr->handlerContextPtr) == LE_OK );
+            RingCommitWrite(&streamPtr->fifo, len);
+            __atomic_store_n(&streamPtr->mediaStarted, true, __ATOMIC_RELEASE);
+
+            if (len)
+            {
+                continue;
+            }
+        }
+
+        WaitFifoPoll(streamPtr);
+    }
+
+    return NULL;
+}
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Playback thread
+ * Playback thread: play one period from the FIFO at each tick of the sample clock.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -43,48 +1147,63 @@ static void* PlaybackThread
     void* contextPtr
 )
 {
-    le_result_t res = LE_OK;
+    PcmStream_t* streamPtr = contextPtr;
+    RingBuffer_t* fifoPtr = &streamPtr->fifo;
 
     LE_DEBUG("Playback started");
-    uint32_t len = PACKET_SIZE;
-    uint32_t index = 0;
+    uint32_t len;
+    uint32_t wantedLen;
     bool previousNullLen = false;
+    struct timespec deadline;
+    sigset_t sigSet;
+
+    // Broken sockets are reported by EPIPE
+    sigemptyset(&sigSet);
+    sigaddset(&sigSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &sigSet, NULL);
 
-    LE_ASSERT(GetSetFramesFunc != NULL);
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
 
     while (1)
     {
-        if (index >= DataLen)
+        if (streamPtr->endpoint.type != ENDPOINT_BUFFER)
         {
-            // just read a char in that case
-            uint8_t data;
-            LE_ASSERT( GetSetFramesFunc(&data, &len, HandlerContextPtr) == LE_OK );
+            wantedLen = PERIOD_SIZE;
+            len = EndpointPlay(&streamPtr->endpoint, fifoPtr, wantedLen);
+        }
+        else if (streamPtr->dataIndex >= streamPtr->dataLen)
+        {
+            // Data buffer is full: play the period anyway, the frames are dropped
+            wantedLen = PERIOD_SIZE;
+            len = RingRead(fifoPtr, streamPtr->discardBuffer, wantedLen);
         }
         else
         {
-            len = ((index + PACKET_SIZE) < DataLen) ? PACKET_SIZE : (DataLen-index);
-            LE_ASSERT(len != 0);
-            LE_ASSERT( GetSetFramesFunc(DataPtr+index, &len, HandlerContextPtr) == LE_OK );
-            index += len;
+            wantedLen = ((streamPtr->dataIndex + PERIOD_SIZE) < streamPtr->dataLen) ?
+                        PERIOD_SIZE : (streamPtr->dataLen - streamPtr->dataIndex);
+            len = RingRead(fifoPtr, streamPtr->dataPtr + streamPtr->dataIndex, wantedLen);
+            streamPtr->dataIndex += len;
         }
 
-        if (len == 0)
+        if ((len < wantedLen) && __atomic_load_n(&streamPtr->mediaStarted, __ATOMIC_ACQUIRE))
         {
+            // The FIFO could not provide a whole period: underrun
             if (previousNullLen)
             {
-                res = LE_UNDERFLOW;
+                ReportXrun(streamPtr, LE_UNDERFLOW);
             }
             else
             {
-                res = LE_OK;
                 previousNullLen = true;
+                ReportXrun(streamPtr, LE_OK);
             }
-
-            LE_ASSERT(ResultFunc != NULL);
-            ResultFunc(res, HandlerContextPtr);
+        }
+        else if (len == wantedLen)
+        {
+            previousNullLen = false;
         }
 
-        pthread_testcancel();
+        WaitNextPeriod(streamPtr, &deadline);
     }
 
     return NULL;
@@ -92,54 +1211,254 @@ static void* PlaybackThread
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Capture thread
+ * Capture media thread: push the frames available in the FIFO to the media layer.
+ *
+ * The media layer reads the frames in place in the FIFO, without intermediate copy.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void* CaptureThread
+static void* CaptureFifoThread
 (
     void* contextPtr
 )
 {
+    PcmStream_t* streamPtr = contextPtr;
     le_result_t res = LE_OK;
-    uint32_t len = PACKET_SIZE;
 
-    while (1)
+    LE_ASSERT(streamPtr->getSetFramesFunc != NULL);
+
+    if ((streamPtr->endpoint.type != ENDPOINT_BUFFER) || (streamPtr->dataPtr && streamPtr->dataLen))
     {
-        if (DataPtr && DataLen)
+        while (1)
         {
-            LE_ASSERT( GetSetFramesFunc(DataPtr+DataIndex, &len, HandlerContextPtr) == LE_OK );
-            LE_ASSERT(len == PACKET_SIZE);
-            DataIndex += len;
+            uint32_t avail;
+            uint8_t* readPtr = RingPeekRead(&streamPtr->fifo, &avail);
 
-            if ( DataIndex == DataLen )
+            if (avail)
             {
-                DataIndex = 0;
+                uint32_t len = avail;
+
+                LE_ASSERT( streamPtr->getSetFramesFunc(readPtr, &len,
+                                                       streamPtr->handlerContextPtr) == LE_OK );
+                RingCommitRead(&streamPtr->fifo, len);
 
-                if (RecSemaphorePtr != NULL)
+                if (len)
                 {
-                    le_sem_Post(*RecSemaphorePtr);
-                    RecSemaphorePtr = NULL;
+                    continue;
                 }
-
+            }
+            else if (__atomic_load_n(&streamPtr->sourceDone, __ATOMIC_ACQUIRE) &&
+                     (RingFill(&streamPtr->fifo) == 0))
+            {
                 break;
             }
+
+            WaitFifoPoll(streamPtr);
         }
-        else
+
+        le_sem_Ref_t* semaphorePtr = __atomic_exchange_n(&streamPtr->semaphorePtr, NULL,
+                                                         __ATOMIC_ACQ_REL);
+        if (semaphorePtr != NULL)
         {
-            res = LE_FAULT;
-            break;
+            le_sem_Post(*semaphorePtr);
         }
     }
+    else
+    {
+        res = LE_FAULT;
+    }
 
-    LE_ASSERT(GetSetFramesFunc != NULL);
-    ResultFunc(res, HandlerContextPtr);
+    LE_ASSERT(streamPtr->resultFunc != NULL);
+    streamPtr->resultFunc(res, streamPtr->handlerContextPtr);
 
     le_event_RunLoop();
 
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capture thread: sample one period into the FIFO at each tick of the sample clock.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CaptureThread
+(
+    void* contextPtr
+)
+{
+    PcmStream_t* streamPtr = contextPtr;
+    RingBuffer_t* fifoPtr = &streamPtr->fifo;
+    uint32_t len;
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    if (streamPtr->endpoint.type != ENDPOINT_BUFFER)
+    {
+        bool isOverrun;
+
+        do
+        {
+            // Frames become available once a whole period has been sampled
+            WaitNextPeriod(streamPtr, &deadline);
+
+            len = EndpointCapture(&streamPtr->endpoint, fifoPtr, PERIOD_SIZE,
+                                  streamPtr->discardBuffer, &isOverrun);
+
+            if (isOverrun)
+            {
+                // The media layer did not empty the FIFO in time: the sampled frames are lost
+                ReportXrun(streamPtr, LE_OVERFLOW);
+            }
+        }
+        while (len == PERIOD_SIZE);
+
+        __atomic_store_n(&streamPtr->sourceDone, true, __ATOMIC_RELEASE);
+        return NULL;
+    }
+
+    if ((streamPtr->dataPtr == NULL) || (streamPtr->dataLen == 0))
+    {
+        return NULL;
+    }
+
+    while (1)
+    {
+        len = ((streamPtr->dataIndex + PERIOD_SIZE) < streamPtr->dataLen) ?
+              PERIOD_SIZE : (streamPtr->dataLen - streamPtr->dataIndex);
+
+        // Frames become available once a whole period has been sampled
+        WaitNextPeriod(streamPtr, &deadline);
+
+        if (RingWrite(fifoPtr, streamPtr->dataPtr + streamPtr->dataIndex, len) < len)
+        {
+            // The media layer did not empty the FIFO in time: the sampled frames are lost
+            ReportXrun(streamPtr, LE_OVERFLOW);
+        }
+
+        streamPtr->dataIndex += len;
+
+        if (streamPtr->dataIndex == streamPtr->dataLen)
+        {
+            streamPtr->dataIndex = 0;
+            __atomic_store_n(&streamPtr->sourceDone, true, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the FIFO and start the device and media side threads of a stream.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartThreads
+(
+    PcmStream_t*         streamPtr,         ///< [IN] PCM stream
+    const char*          devThreadNamePtr,  ///< [IN] Device thread name
+    le_thread_MainFunc_t devThreadFunc,     ///< [IN] Device thread main function
+    const char*          fifoThreadNamePtr, ///< [IN] Media side thread name
+    le_thread_MainFunc_t fifoThreadFunc     ///< [IN] Media side thread main function
+)
+{
+    LE_ASSERT(streamPtr->pcmThreadRef == NULL);
+
+    RingInit(&streamPtr->fifo, FifoDepth * PERIOD_SIZE);
+    streamPtr->dataPtr = DataPtr;
+    streamPtr->dataLen = DataLen;
+    streamPtr->dataIndex = 0;
+    streamPtr->semaphorePtr = RecSemaphorePtr;
+    streamPtr->mediaStarted = false;
+    streamPtr->sourceDone = false;
+    streamPtr->underrunCount = 0;
+    streamPtr->overrunCount = 0;
+
+    streamPtr->pcmThreadRef = le_thread_Create(devThreadNamePtr, devThreadFunc, streamPtr);
+    streamPtr->fifoThreadRef = le_thread_Create(fifoThreadNamePtr, fifoThreadFunc, streamPtr);
+
+    le_thread_SetJoinable(streamPtr->pcmThreadRef);
+    le_thread_SetJoinable(streamPtr->fifoThreadRef);
+
+    le_thread_Start(streamPtr->fifoThreadRef);
+    le_thread_Start(streamPtr->pcmThreadRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the threads of a stream and release its FIFO.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopThreads
+(
+    PcmStream_t* streamPtr          ///< [IN] PCM stream
+)
+{
+    if (streamPtr->pcmThreadRef == NULL)
+    {
+        return;
+    }
+
+    le_thread_Cancel(streamPtr->pcmThreadRef);
+    le_thread_Join(streamPtr->pcmThreadRef, NULL);
+    streamPtr->pcmThreadRef = NULL;
+
+    le_thread_Cancel(streamPtr->fifoThreadRef);
+    le_thread_Join(streamPtr->fifoThreadRef, NULL);
+    streamPtr->fifoThreadRef = NULL;
+
+    if (streamPtr->underrunCount || streamPtr->overrunCount)
+    {
+        LE_INFO("Stream %p FIFO xruns: %d underrun(s), %d overrun(s)", streamPtr,
+                streamPtr->underrunCount, streamPtr->overrunCount);
+    }
+
+    RingRelease(&streamPtr->fifo);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a PCM stream and open its endpoint.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateStream
+(
+    pcm_Handle_t*               pcmHandlePtr,   ///< [OUT] PCM handle
+    char*                       devicePtr,      ///< [IN] Device to be initialized
+    le_audio_SamplePcmConfig_t* pcmConfig,      ///< [IN] Samples PCM configuration
+    bool                        isPlayback      ///< [IN] Playback or capture stream
+)
+{
+    PcmStream_t* streamPtr = le_mem_ForceAlloc(PcmStreamPool);
+    le_result_t res;
+
+    memset(streamPtr, 0, sizeof(PcmStream_t));
+    streamPtr->link = LE_DLS_LINK_INIT;
+    streamPtr->isPlayback = isPlayback;
+
+    SetPeriodTiming(streamPtr, pcmConfig);
+
+    res = EndpointOpen(&streamPtr->endpoint, devicePtr, pcmConfig, isPlayback);
+    if (res != LE_OK)
+    {
+        le_mem_Release(streamPtr);
+        return res;
+    }
+
+    le_dls_Queue(&PcmStreamList, &streamPtr->link);
+
+    LE_DEBUG("%s stream %p created (%zu streams)", isPlayback ? "Playback" : "Capture",
+             streamPtr, le_dls_NumLinks(&PcmStreamList));
+
+    *pcmHandlePtr = (pcm_Handle_t) streamPtr;
+    return LE_OK;
+}
+
 
 //--------------------------------------------------------------------------------------------------
 //                                       Public declarations
@@ -147,7 +1466,8 @@ static void* CaptureThread
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the semaphore to unlock the test thread.
+ * Set the semaphore to unlock the test thread, posted at the end of the captures of the streams
+ * started afterwards.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -161,7 +1481,8 @@ void pa_pcmSimu_SetSemaphore
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Init the data buffer with the correct size.
+ * Init the data buffer with the correct size. The streams started afterwards play into it, or
+ * capture from it.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -187,8 +1508,8 @@ void pa_pcmSimu_ReleaseData
 )
 {
     free(DataPtr);
+    DataPtr = NULL;
     DataLen = 0;
-    DataIndex = 0;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -205,6 +1526,52 @@ uint8_t* pa_pcmSimu_GetDataPtr
     return DataPtr;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the depth of the simulated device FIFO, in periods. Applies to the next playback/capture.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_pcmSimu_SetFifoDepth
+(
+    uint32_t periodCount
+)
+{
+    LE_ASSERT(periodCount != 0);
+    FifoDepth = periodCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of FIFO underruns and overruns detected on all the streams since the
+ * initialization of the pa_pcm simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_pcmSimu_GetXrunCount
+(
+    uint32_t* underrunCountPtr,
+    uint32_t* overrunCountPtr
+)
+{
+    *underrunCountPtr = __atomic_load_n(&UnderrunCount, __ATOMIC_RELAXED);
+    *overrunCountPtr = __atomic_load_n(&OverrunCount, __ATOMIC_RELAXED);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of PCM streams currently opened.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_pcmSimu_GetStreamCount
+(
+    void
+)
+{
+    return le_dls_NumLinks(&PcmStreamList);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start the playback.
@@ -219,18 +1586,10 @@ le_result_t pa_pcm_Play
                                             ///< initialization functions
 )
 {
-    LE_ASSERT(pcmHandle == (pcm_Handle_t) PcmHandle);
-    LE_ASSERT(PcmThreadRef == NULL);
-
-    char threadName[]="PlaybackThread";
+    PcmStream_t* streamPtr = GetStream(pcmHandle);
 
-    PcmThreadRef = le_thread_Create( threadName,
-                                     PlaybackThread,
-                                     NULL );
-
-    le_thread_SetJoinable(PcmThreadRef);
-
-    le_thread_Start(PcmThreadRef);
+    StartThreads(streamPtr, "PlaybackThread", PlaybackThread,
+                 "PlaybackFifoThread", PlaybackFifoThread);
 
     return LE_OK;
 }
@@ -249,18 +1608,10 @@ le_result_t pa_pcm_Capture
                                             ///< initialization functions
 )
 {
-    LE_ASSERT(pcmHandle == (pcm_Handle_t) PcmHandle);
-    LE_ASSERT(PcmThreadRef == NULL);
-
-    char threadName[]="CaptureThread";
-
-    PcmThreadRef = le_thread_Create( threadName,
-                                     CaptureThread,
-                                     NULL );
+    PcmStream_t* streamPtr = GetStream(pcmHandle);
 
-    le_thread_SetJoinable(PcmThreadRef);
-
-    le_thread_Start(PcmThreadRef);
+    StartThreads(streamPtr, "CaptureThread", CaptureThread,
+                 "CaptureFifoThread", CaptureFifoThread);
 
     return LE_OK;
 }
@@ -278,12 +1629,13 @@ le_result_t pa_pcm_Close
                                            ///< initialization functions
 )
 {
-    if (PcmThreadRef)
-    {
-        le_thread_Cancel(PcmThreadRef);
-        le_thread_Join(PcmThreadRef, NULL);
-        PcmThreadRef = NULL;
-    }
+    PcmStream_t* streamPtr = GetStream(pcmHandle);
+
+    StopThreads(streamPtr);
+    EndpointClose(&streamPtr->endpoint);
+
+    le_dls_Remove(&PcmStreamList, &streamPtr->link);
+    le_mem_Release(streamPtr);
 
     return LE_OK;
 }
@@ -301,7 +1653,7 @@ uint32_t pa_pcm_GetPeriodSize
                                             ///< initialization functions
 )
 {
-    return 3000;
+    return PERIOD_SIZE;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -318,8 +1670,7 @@ le_result_t pa_pcm_InitCapture
     le_audio_SamplePcmConfig_t* pcmConfig   ///< [IN] Samples PCM configuration
 )
 {
-    *pcmHandlePtr = (pcm_Handle_t) PcmHandle;
-    return LE_OK;
+    return CreateStream(pcmHandlePtr, devicePtr, pcmConfig, false);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -336,8 +1687,7 @@ le_result_t pa_pcm_InitPlayback
     le_audio_SamplePcmConfig_t* pcmConfig   ///< [IN] Samples PCM configuration
 )
 {
-    *pcmHandlePtr = (pcm_Handle_t) PcmHandle;
-    return LE_OK;
+    return CreateStream(pcmHandlePtr, devicePtr, pcmConfig, true);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -351,7 +1701,8 @@ void pa_pcmSimu_Init
     void
 )
 {
-    return;
+    PcmStreamPool = le_mem_CreatePool("PcmStreamPool", sizeof(PcmStream_t));
+    le_mem_ExpandPool(PcmStreamPool, PCM_STREAM_POOL_SIZE);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -373,9 +1724,11 @@ le_result_t pa_pcm_SetCallbackHandlers
     void* contextPtr
 )
 {
-    GetSetFramesFunc = getSetFramesFunc;
-    ResultFunc = setResultFunc;
-    HandlerContextPtr = contextPtr;
+    PcmStream_t* streamPtr = GetStream(pcmHandle);
+
+    streamPtr->getSetFramesFunc = getSetFramesFunc;
+    streamPtr->resultFunc = setResultFunc;
+    streamPtr->handlerContextPtr = contextPtr;
 
     return LE_OK;
 }
@@ -21,7 +21,8 @@ void pa_pcmSimu_Init
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Init the data buffer with the correct size.
+ * Init the data buffer with the correct size. The streams started afterwards play into it, or
+ * capture from it.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -54,7 +55,8 @@ uint8_t* pa_pcmSimu_GetDataPtr
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Set the semaphore to unlock the test thread.
+ * Set the semaphore to unlock the test thread, posted at the end of the captures of the streams
+ * started afterwards.
  *
  */
 //--------------------------------------------------------------------------------------------------
@@ -63,5 +65,40 @@ void pa_pcmSimu_SetSemaphore
     le_sem_Ref_t*    semaphorePtr
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the depth of the simulated device FIFO, in periods. Applies to the next playback/capture.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_pcmSimu_SetFifoDepth
+(
+    uint32_t periodCount
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of FIFO underruns and overruns detected on all the streams since the
+ * initialization of the pa_pcm simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_pcmSimu_GetXrunCount
+(
+    uint32_t* underrunCountPtr,
+    uint32_t* overrunCountPtr
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of PCM streams currently opened.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_pcmSimu_GetStreamCount
+(
+    void
+);
+
 #endif
 
@@ -0,0 +1,433 @@
+/**
+ * @file pa_constellation_simu.c
+ *
+ * Satellite constellations of the simulated GNSS receiver.
+ *
+ * The almanacs describe groups of satellites on circular orbits: Walker constellations for the MEO
+ * satellites, and geosynchronous orbits whose ascending node stays at a fixed longitude for the GEO
+ * and IGSO ones. They are expanded once into a table of per-satellite orbital constants, so
+ * locating a satellite only takes a few sines and cosines. Signal strengths are read from a table
+ * indexed by elevation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include <pa_gnss.h>
+#include "pa_constellation_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of satellites of the almanacs.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SATELLITE_MAX               128
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Earth gravitational constant in km3/s2, rotation rate in rad/s and radius in km.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EARTH_MU                    398600.4418
+#define EARTH_ROTATION_RATE         7.2921151467e-5
+#define EARTH_RADIUS                6371.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Almanac epoch: start of the GPS time, Jan. 6, 1980, in UTC milliseconds and in Julian days.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALMANAC_EPOCH_TIME          315964800000ULL
+#define ALMANAC_EPOCH_JULIAN_DAY    2444244.5
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength at the horizon and at the zenith in dBHz, and weakest signal tracked.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SNR_HORIZON                 20.0
+#define SNR_ZENITH                  46.0
+#define SNR_TRACKING                25
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default minimum elevation in degrees.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_MIN_ELEVATION       10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Latency of the satellite measurements in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MEASUREMENT_LATENCY         20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Almanac of a group of satellites sharing an orbit radius and an inclination.
+ *
+ * Satellites are numbered plane by plane from the first identifier. In a Walker constellation,
+ * satellites are evenly spaced in their plane and shifted by phasing x 360 / total count from a
+ * plane to the next one.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gnss_Constellation_t constellation;  ///< Constellation
+    uint16_t                firstSatId;     ///< Identifier of the first satellite
+    uint8_t                 planeCount;     ///< Number of orbital planes
+    uint8_t                 satsPerPlane;   ///< Number of satellites per plane
+    uint8_t                 phasing;        ///< Walker phasing factor
+    bool                    earthFixed;     ///< Geosynchronous: the node is a fixed longitude
+    double                  radius;         ///< Orbit radius in km
+    double                  inclination;    ///< Inclination in degrees
+    double                  node;           ///< Node of the first plane in degrees: right
+                                            ///< ascension at the epoch, or longitude
+    int8_t                  snrOffset;      ///< Signal strength offset in dB
+}
+Almanac_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Orbital constants of a satellite.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t                satId;          ///< Satellite identifier
+    le_gnss_Constellation_t constellation;  ///< Constellation
+    int8_t                  snrOffset;      ///< Signal strength offset in dB
+    double                  radius;         ///< Orbit radius in km
+    double                  cosInclination; ///< Cosine of the inclination
+    double                  sinInclination; ///< Sine of the inclination
+    double                  node;           ///< Right ascension of the node in radians
+    double                  anomaly;        ///< Argument of latitude at the epoch in radians
+    double                  meanMotion;     ///< Mean motion in radians/second
+}
+Satellite_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Area restricting a constellation outside the US: latitude and longitude ranges in degrees.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    double minLatitude;
+    double maxLatitude;
+    double minLongitude;
+    double maxLongitude;
+}
+Area_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Almanacs of the constellations.
+ */
+//--------------------------------------------------------------------------------------------------
+static const Almanac_t Almanacs[] =
+{
+    // GPS: Walker 30/6/1 MEO.
+    { LE_GNSS_SV_CONSTELLATION_GPS,       1, 6, 5, 1, false, 26559.7, 55.0,   0.0,  0 },
+    // GLONASS: Walker 24/3/1 MEO.
+    { LE_GNSS_SV_CONSTELLATION_GLONASS,  65, 3, 8, 1, false, 25508.0, 64.8,  15.0, -2 },
+    // Galileo: Walker 24/3/1 MEO.
+    { LE_GNSS_SV_CONSTELLATION_GALILEO, 301, 3, 8, 1, false, 29600.3, 56.0,  30.0,  1 },
+    // BeiDou: GEO, IGSO and Walker 24/3/1 MEO.
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  201, 1, 1, 0, true,  42164.2,  0.0,  58.75, -1 },
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  202, 1, 1, 0, true,  42164.2,  0.0,  80.0,  -1 },
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  203, 1, 1, 0, true,  42164.2,  0.0, 110.5,  -1 },
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  204, 1, 1, 0, true,  42164.2,  0.0, 140.0,  -1 },
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  205, 1, 1, 0, true,  42164.2,  0.0, 160.0,  -1 },
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  206, 1, 3, 0, true,  42164.2, 55.0, 118.0,  -1 },
+    { LE_GNSS_SV_CONSTELLATION_BEIDOU,  211, 3, 8, 1, false, 27906.1, 55.0,  45.0,  -1 },
+    // QZSS: quasi-zenith orbits centered on 135E, and GEO.
+    { LE_GNSS_SV_CONSTELLATION_QZSS,    193, 1, 3, 0, true,  42164.2, 41.0, 135.0,   0 },
+    { LE_GNSS_SV_CONSTELLATION_QZSS,    199, 1, 1, 0, true,  42164.2,  0.0, 127.0,   0 },
+    // SBAS: EGNOS, WAAS, GAGAN and MSAS GEO.
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    123, 1, 1, 0, true,  42164.2,  0.0,  31.5,  -3 },
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    136, 1, 1, 0, true,  42164.2,  0.0,   5.0,  -3 },
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    131, 1, 1, 0, true,  42164.2,  0.0, -117.0, -3 },
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    133, 1, 1, 0, true,  42164.2,  0.0, -129.0, -3 },
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    138, 1, 1, 0, true,  42164.2,  0.0, -107.3, -3 },
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    127, 1, 1, 0, true,  42164.2,  0.0,  55.0,  -3 },
+    { LE_GNSS_SV_CONSTELLATION_SBAS,    137, 1, 1, 0, true,  42164.2,  0.0, 140.0,  -3 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * US areas: contiguous states, Alaska and Hawaii.
+ */
+//--------------------------------------------------------------------------------------------------
+static const Area_t UsAreas[] =
+{
+    { 24.5, 49.5, -125.0,  -66.9 },
+    { 51.2, 71.5, -170.0, -129.9 },
+    { 18.9, 22.3, -160.3, -154.8 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Constellation bit of the constellations.
+ */
+//--------------------------------------------------------------------------------------------------
+static const le_gnss_ConstellationBitMask_t ConstellationBits[LE_GNSS_SV_CONSTELLATION_MAX] =
+{
+    [LE_GNSS_SV_CONSTELLATION_GPS]     = LE_GNSS_CONSTELLATION_GPS,
+    [LE_GNSS_SV_CONSTELLATION_SBAS]    = LE_GNSS_CONSTELLATION_SBAS,
+    [LE_GNSS_SV_CONSTELLATION_GLONASS] = LE_GNSS_CONSTELLATION_GLONASS,
+    [LE_GNSS_SV_CONSTELLATION_GALILEO] = LE_GNSS_CONSTELLATION_GALILEO,
+    [LE_GNSS_SV_CONSTELLATION_BEIDOU]  = LE_GNSS_CONSTELLATION_BEIDOU,
+    [LE_GNSS_SV_CONSTELLATION_QZSS]    = LE_GNSS_CONSTELLATION_QZSS,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Satellites of the almanacs.
+ */
+//--------------------------------------------------------------------------------------------------
+static Satellite_t Satellites[SATELLITE_MAX];
+static size_t      SatelliteCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Signal strength in dBHz per degree of elevation.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t SnrTable[91];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sidereal angle of the Earth at the almanac epoch, in radians.
+ */
+//--------------------------------------------------------------------------------------------------
+static double EpochSiderealAngle;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a position is in the US.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsInUs
+(
+    double latitude,    // [IN] Latitude in degrees.
+    double longitude    // [IN] Longitude in degrees.
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(UsAreas); i++)
+    {
+        if ((latitude >= UsAreas[i].minLatitude) && (latitude <= UsAreas[i].maxLatitude) &&
+            (longitude >= UsAreas[i].minLongitude) && (longitude <= UsAreas[i].maxLongitude))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_constellation simu: build the satellite tables from the almanacs.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_constellationSimu_Init
+(
+    void
+)
+{
+    double julianCenturyDays = ALMANAC_EPOCH_JULIAN_DAY - 2451545.0;
+    size_t a;
+    size_t i;
+
+    // Greenwich mean sidereal angle.
+    EpochSiderealAngle = 0.7790572732640 + 1.00273781191135448 * julianCenturyDays;
+    EpochSiderealAngle = (EpochSiderealAngle - floor(EpochSiderealAngle)) * 2 * M_PI;
+
+    SatelliteCount = 0;
+    for (a = 0; a < NUM_ARRAY_MEMBERS(Almanacs); a++)
+    {
+        const Almanac_t* almanacPtr = &Almanacs[a];
+        int satCount = almanacPtr->planeCount * almanacPtr->satsPerPlane;
+        int plane;
+        int slot;
+
+        for (plane = 0; plane < almanacPtr->planeCount; plane++)
+        {
+            for (slot = 0; slot < almanacPtr->satsPerPlane; slot++)
+            {
+                Satellite_t* satPtr = &Satellites[SatelliteCount++];
+                double inclination = almanacPtr->inclination * M_PI / 180;
+                double node = almanacPtr->node * M_PI / 180;
+
+                LE_ASSERT(SatelliteCount <= SATELLITE_MAX);
+
+                satPtr->satId = almanacPtr->firstSatId + plane * almanacPtr->satsPerPlane + slot;
+                satPtr->constellation = almanacPtr->constellation;
+                satPtr->snrOffset = almanacPtr->snrOffset;
+                satPtr->radius = almanacPtr->radius;
+                satPtr->cosInclination = cos(inclination);
+                satPtr->sinInclination = sin(inclination);
+                satPtr->anomaly = 2 * M_PI * slot / almanacPtr->satsPerPlane
+                                  + 2 * M_PI * plane * almanacPtr->phasing / satCount;
+
+                if (almanacPtr->earthFixed)
+                {
+                    // Nodes crossed at the same longitude: the satellites share a ground track.
+                    satPtr->node = node + EpochSiderealAngle - satPtr->anomaly;
+                    satPtr->meanMotion = EARTH_ROTATION_RATE;
+                }
+                else
+                {
+                    satPtr->node = node + 2 * M_PI * plane / almanacPtr->planeCount;
+                    satPtr->meanMotion = sqrt(EARTH_MU / pow(almanacPtr->radius, 3));
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(SnrTable); i++)
+    {
+        SnrTable[i] = lround(SNR_HORIZON + (SNR_ZENITH - SNR_HORIZON)
+                                           * sqrt(sin(i * M_PI / 180)));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the default receiver settings: GPS and GLONASS, worldwide, 10 degrees of minimum elevation.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_constellationSimu_SetDefaultConfig
+(
+    pa_constellationSimu_Config_t* configPtr    ///< [OUT] Receiver settings
+)
+{
+    int i;
+
+    configPtr->constellationMask = LE_GNSS_CONSTELLATION_GPS | LE_GNSS_CONSTELLATION_GLONASS;
+    for (i = 0; i < LE_GNSS_SV_CONSTELLATION_MAX; i++)
+    {
+        configPtr->area[i] = LE_GNSS_WORLDWIDE_AREA;
+    }
+    configPtr->minElevation = DEFAULT_MIN_ELEVATION;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the satellite info, satellite measurements and satellite counts of the position data with
+ * the satellites in view of a position.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_constellationSimu_GetSky
+(
+    const pa_constellationSimu_Config_t* configPtr,     ///< [IN] Receiver settings
+    double                               latitude,      ///< [IN] Latitude in degrees
+    double                               longitude,     ///< [IN] Longitude in degrees
+    uint64_t                             utcTime,       ///< [IN] UTC time in milliseconds
+    pa_Gnss_Position_t*                  posDataPtr     ///< [IN/OUT] Position data
+)
+{
+    double   elapsed = ((int64_t)utcTime - (int64_t)ALMANAC_EPOCH_TIME) / 1000.0;
+    double   siderealAngle = fmod(EpochSiderealAngle + EARTH_ROTATION_RATE * elapsed, 2 * M_PI);
+    double   sinLat = sin(latitude * M_PI / 180);
+    double   cosLat = cos(latitude * M_PI / 180);
+    double   sinLon = sin(longitude * M_PI / 180);
+    double   cosLon = cos(longitude * M_PI / 180);
+    // Receiver position and vertical, Earth-fixed.
+    double   up[3] = { cosLat * cosLon, cosLat * sinLon, sinLat };
+    bool     inUs = IsInUs(latitude, longitude);
+    uint8_t  inViewCount = 0;
+    uint8_t  trackingCount = 0;
+    uint8_t  usedCount = 0;
+    size_t   i;
+
+    for (i = 0; (i < SatelliteCount) && (inViewCount < LE_GNSS_SV_INFO_MAX_LEN); i++)
+    {
+        const Satellite_t* satPtr = &Satellites[i];
+        pa_Gnss_SvInfo_t*  svPtr = &posDataPtr->satInfo[inViewCount];
+        double anomaly;
+        double node;
+        double cosAnomaly;
+        double sinAnomaly;
+        double cosNode;
+        double sinNode;
+        double los[3];
+        double east;
+        double north;
+        double vertical;
+        double elevation;
+        double azimuth;
+        int    snr;
+
+        if (!(configPtr->constellationMask & ConstellationBits[satPtr->constellation]))
+        {
+            continue;
+        }
+
+        // Satellite position, Earth-fixed.
+        anomaly = fmod(satPtr->anomaly + satPtr->meanMotion * elapsed, 2 * M_PI);
+        node = satPtr->node - siderealAngle;
+        cosAnomaly = cos(anomaly);
+        sinAnomaly = sin(anomaly);
+        cosNode = cos(node);
+        sinNode = sin(node);
+        los[0] = satPtr->radius * (cosAnomaly * cosNode - sinAnomaly * satPtr->cosInclination
+                                                          * sinNode) - EARTH_RADIUS * up[0];
+        los[1] = satPtr->radius * (cosAnomaly * sinNode + sinAnomaly * satPtr->cosInclination
+                                                          * cosNode) - EARTH_RADIUS * up[1];
+        los[2] = satPtr->radius * sinAnomaly * satPtr->sinInclination - EARTH_RADIUS * up[2];
+
+        vertical = los[0] * up[0] + los[1] * up[1] + los[2] * up[2];
+        if (vertical < 0)
+        {
+            // Below the horizon.
+            continue;
+        }
+        east = -sinLon * los[0] + cosLon * los[1];
+        north = -sinLat * cosLon * los[0] - sinLat * sinLon * los[1] + cosLat * los[2];
+        elevation = atan2(vertical, sqrt(east * east + north * north)) * 180 / M_PI;
+        azimuth = atan2(east, north) * 180 / M_PI;
+        snr = SnrTable[lround(elevation)] + satPtr->snrOffset + (int)(satPtr->satId % 5) - 2;
+
+        svPtr->satId = satPtr->satId;
+        svPtr->satConst = satPtr->constellation;
+        svPtr->satElev = lround(elevation);
+        svPtr->satAzim = lround((azimuth < 0) ? azimuth + 360 : azimuth) % 360;
+        svPtr->satSnr = snr;
+        svPtr->satTracked = (snr >= SNR_TRACKING);
+        svPtr->satUsed = svPtr->satTracked
+                         && (svPtr->satElev >= configPtr->minElevation)
+                         && (LE_GNSS_SV_CONSTELLATION_SBAS != satPtr->constellation)
+                         && !(inUs && (LE_GNSS_OUTSIDE_US_AREA ==
+                                       configPtr->area[satPtr->constellation]));
+
+        posDataPtr->satMeas[inViewCount].satId = svPtr->satTracked ? satPtr->satId : 0;
+        posDataPtr->satMeas[inViewCount].satLatency = svPtr->satTracked ?
+                                                      MEASUREMENT_LATENCY + inViewCount : 0;
+
+        trackingCount += svPtr->satTracked;
+        usedCount += svPtr->satUsed;
+        inViewCount++;
+    }
+
+    for (i = inViewCount; i < LE_GNSS_SV_INFO_MAX_LEN; i++)
+    {
+        memset(&posDataPtr->satInfo[i], 0, sizeof(posDataPtr->satInfo[i]));
+        posDataPtr->satInfo[i].satConst = LE_GNSS_SV_CONSTELLATION_UNDEFINED;
+        posDataPtr->satMeas[i].satId = 0;
+        posDataPtr->satMeas[i].satLatency = 0;
+    }
+
+    posDataPtr->satInfoValid = true;
+    posDataPtr->satMeasValid = true;
+    posDataPtr->satsInViewCountValid = true;
+    posDataPtr->satsInViewCount = inViewCount;
+    posDataPtr->satsTrackingCountValid = true;
+    posDataPtr->satsTrackingCount = trackingCount;
+    posDataPtr->satsUsedCountValid = true;
+    posDataPtr->satsUsedCount = usedCount;
+}
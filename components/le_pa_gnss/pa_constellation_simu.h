@@ -0,0 +1,70 @@
+/** @file pa_constellation_simu.h
+ *
+ * Legato @ref pa_constellation_simu include file.
+ *
+ * Satellite constellations of the simulated GNSS receiver: GPS, GLONASS, Galileo, BeiDou, QZSS and
+ * SBAS satellites on circular orbits given by simple almanacs, seen from the receiver position.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_CONSTELLATION_SIMU_H_INCLUDE_GUARD
+#define PA_CONSTELLATION_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receiver settings applied to the satellites.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gnss_ConstellationBitMask_t constellationMask;   ///< Constellations acquired
+    le_gnss_ConstellationArea_t    area[LE_GNSS_SV_CONSTELLATION_MAX]; ///< Area of each
+                                                                       ///< constellation
+    uint8_t                        minElevation;        ///< Minimum elevation of the satellites
+                                                        ///< used in the solution, in degrees
+}
+pa_constellationSimu_Config_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_constellation simu: build the satellite tables from the almanacs.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_constellationSimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the default receiver settings: GPS and GLONASS, worldwide, 10 degrees of minimum elevation.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_constellationSimu_SetDefaultConfig
+(
+    pa_constellationSimu_Config_t* configPtr    ///< [OUT] Receiver settings
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the satellite info, satellite measurements and satellite counts of the position data with
+ * the satellites in view of a position.
+ *
+ * Satellites above the horizon of the acquired constellations are in view, and tracked if their
+ * signal is strong enough. Tracked satellites above the minimum elevation are used in the solution,
+ * except SBAS ones and the ones of constellations restricted outside the US while in the US.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_constellationSimu_GetSky
+(
+    const pa_constellationSimu_Config_t* configPtr,     ///< [IN] Receiver settings
+    double                               latitude,      ///< [IN] Latitude in degrees
+    double                               longitude,     ///< [IN] Longitude in degrees
+    uint64_t                             utcTime,       ///< [IN] UTC time in milliseconds
+    pa_Gnss_Position_t*                  posDataPtr     ///< [IN/OUT] Position data
+);
+
+#endif
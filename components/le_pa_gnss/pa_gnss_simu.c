@@ -8,13 +8,31 @@
 
 #include <pa_gnss.h>
 #include "pa_gnss_simu.h"
+#include "pa_nmea_simu.h"
+#include "pa_constellation_simu.h"
+#include "pa_ttff_simu.h"
+#include "pa_xtra_simu.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
  * Set the NMEA string for NMEA handler
  */
 //--------------------------------------------------------------------------------------------------
-#define NMEA_STR_LEN                  32
+#define NMEA_STR_LEN                  (PA_NMEASIMU_SENTENCE_MAX_LEN + 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * NMEA event data preallocated, enough for the sentences of a fix with every sentence enabled.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_POOL_SIZE                48
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer formatting the NMEA sentences of a fix.
+ */
+//--------------------------------------------------------------------------------------------------
+#define NMEA_BUFFER_SIZE              (NMEA_POOL_SIZE * PA_NMEASIMU_SENTENCE_MAX_LEN + 1)
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -25,24 +43,244 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Position event ID used to report position events to the registered event handlers.
+ * Default acquisition rate in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_ACQUISITION_RATE    1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * UTC time of the start of the undated trajectories, in milliseconds (2017-10-04T23:59:50.100Z).
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_START_TIME          1507161590100ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GPS time: start of the GPS time scale (1980-01-06T00:00:00Z) in UTC milliseconds, leap seconds
+ * between GPS time and UTC, and milliseconds in a GPS week.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GPS_EPOCH_TIME              315964800000ULL
+#define GPS_LEAP_SECONDS            18
+#define GPS_WEEK_DURATION           604800000ULL
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scale of the DOP values (3 decimal places).
+ */
+//--------------------------------------------------------------------------------------------------
+#define DOP_SCALE                   1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error model of the trajectory fixes: user equivalent range error (m), separation between the
+ * geoid and the WGS84 ellipsoid (m), speed uncertainty (m/s) and fix latency (ms).
+ */
+//--------------------------------------------------------------------------------------------------
+#define RANGE_ERROR                 5.0
+#define GEOID_SEPARATION            47.0
+#define SPEED_UNCERTAINTY           0.2
+#define FIX_LATENCY                 50
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Speed of light in meters per nanosecond.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LIGHT_SPEED                 0.299792458
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Period of the sky updates in milliseconds: the satellites in view of the fixes of a period are
+ * the ones at its start.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SKY_UPDATE_PERIOD           10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest uncertainty of an injected UTC time giving the time to the receiver, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_INJECTION_MAX_UNCERTAINTY  10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of position event slots of a receiver: the fixes being reported while the subscribers
+ * still hold the previous ones.
+ */
+//--------------------------------------------------------------------------------------------------
+#define POSITION_SLOT_COUNT         8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of fixes kept in the fix history.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FIX_HISTORY_SIZE            256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fix stream benchmark: maximum number of subscribers, and route driven around (a square of
+ * BENCHMARK_LEG_LENGTH meters at BENCHMARK_SPEED meters/second).
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_MAX_SUBSCRIBERS   64
+#define BENCHMARK_LATITUDE          45.0
+#define BENCHMARK_LONGITUDE         5.0
+#define BENCHMARK_LEG_LENGTH        500.0
+#define BENCHMARK_SPEED             15.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact fix of the fix history, delta-encoded against the previous fix. Only the solution is
+ * kept, not the satellite info.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    int32_t  timeDelta;         ///< Time since the previous fix in milliseconds
+    int32_t  latitudeDelta;     ///< Latitude change, degrees with 6 decimal places
+    int32_t  longitudeDelta;    ///< Longitude change, degrees with 6 decimal places
+    int32_t  altitudeDelta;     ///< Altitude change, meters with 3 decimal places
+    uint16_t hSpeed;            ///< Horizontal speed, meters/second with 2 decimal places
+    int16_t  vSpeed;            ///< Vertical speed, meters/second with 2 decimal places
+    uint16_t direction;         ///< Direction, degrees with 1 decimal place
+    uint16_t hdop;              ///< Horizontal DOP, 3 decimal places
+    uint16_t vdop;              ///< Vertical DOP, 3 decimal places
+    uint8_t  fixState;          ///< Fix state
+    uint8_t  satsUsedCount;     ///< Satellites used in the solution
+}
+FixRecord_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fix history: ring of compact fixes, and last fix in full for the decoding.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    FixRecord_t records[FIX_HISTORY_SIZE];  ///< Compact fixes
+    uint32_t    index;                      ///< Index of the next compact fix
+    uint32_t    count;                      ///< Number of compact fixes
+    uint64_t    epochTime;                  ///< Last fix time
+    int32_t     latitude;                   ///< Last fix latitude
+    int32_t     longitude;                  ///< Last fix longitude
+    int32_t     altitude;                   ///< Last fix altitude
+}
+FixHistory_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batch of the receivers started at the same acquisition rate, fired together by one timer.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t       rate;            ///< Acquisition rate in milliseconds
+    le_timer_Ref_t timerRef;        ///< Timer firing the receivers at the acquisition rate
+    le_dls_List_t  receiverList;    ///< Receivers started and following a trajectory
+    le_dls_Link_t  link;            ///< Link in the batch list
+}
+Batch_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position event slot. The position is the first member, the subscribers only see it.
+ *
+ * The satellite info and measurements are most of the position data, and change much less often
+ * than the fixes: a slot keeps the version of the ones it holds, to skip copying them again.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    pa_Gnss_Position_t position;    ///< Reported position data
+    uint32_t           satVersion;  ///< Version of the satellite info held in the position, 0 if
+                                    ///< none
+    uint64_t           reportTime;  ///< Monotonic time of the report in nanoseconds
+}
+PositionSlot_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Simulated receiver: settings, position data, acquisition and subscribers.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_gnssSimu_Receiver
+{
+    pa_Gnss_Position_t            positionData;         ///< Computed position data
+    uint32_t                      satVersion;           ///< Version of the satellite info and
+                                                        ///< measurements of the position data,
+                                                        ///< increased on each change
+    PositionSlot_t*               slotPtr[POSITION_SLOT_COUNT]; ///< Position event slots, each one
+                                                        ///< referenced by the receiver: a slot is
+                                                        ///< free when no subscriber holds it
+    le_event_Id_t                 positionEventId;      ///< Position event ID
+    le_event_Id_t                 nmeaEventId;          ///< NMEA event ID
+    le_gnss_AssistedMode_t        suplAssistedMode;     ///< Configured SUPL assisted mode
+    le_gnss_NmeaBitMask_t         nmeaBitMask;          ///< Enabled NMEA sentences
+    uint32_t                      acquisitionRate;      ///< Acquisition rate in milliseconds
+    bool                          acquisitionStarted;   ///< Acquisition started
+    pa_trajectorySimu_TrackRef_t  trajectoryRef;        ///< Trajectory followed, NULL if the
+                                                        ///< position data are only set by the tests
+    uint64_t                      trajectoryTime;       ///< Playback time of the next trajectory fix,
+                                                        ///< in milliseconds from its start
+    uint64_t                      trajectoryStartTime;  ///< UTC time of the trajectory start in
+                                                        ///< milliseconds
+    int64_t                       skyEpoch;             ///< Sky update period of the satellite info
+                                                        ///< of the last trajectory fix, -1 if not a
+                                                        ///< trajectory fix or if the settings changed
+    pa_constellationSimu_Config_t constellationConfig;  ///< Constellations, areas and minimum
+                                                        ///< elevation
+    pa_ttffSimu_Knowledge_t       knowledge;            ///< Knowledge giving the start type of the
+                                                        ///< acquisitions
+    uint64_t                      injectedTime;         ///< Last injected UTC time in milliseconds,
+                                                        ///< 0 if none or if the time was lost
+    uint64_t                      injectionNanoTime;    ///< Monotonic time of the injection in
+                                                        ///< nanoseconds
+    bool                          fixAcquired;          ///< First fix of the acquisition obtained
+    uint32_t                      acquisitionTime;      ///< Time since the acquisition start in ms
+    uint32_t                      ttff;                 ///< TTFF drawn in milliseconds, the TTFF of
+                                                        ///< the acquisition once the fix obtained
+    FixHistory_t*                 historyPtr;           ///< Fix history, NULL if not recorded
+    Batch_t*                      batchPtr;             ///< Batch firing the receiver, NULL if not
+                                                        ///< started or not following a trajectory
+    le_dls_Link_t                 link;                 ///< Link in the batch or free receiver list
+}
+Receiver_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receiver of the PA API, and its fix history.
+ */
+//--------------------------------------------------------------------------------------------------
+static Receiver_t*          DefaultReceiverPtr;
+static FixHistory_t         DefaultFixHistory;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pools of the receivers and of the batches.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t        GnssEventId;
+static le_mem_PoolRef_t     ReceiverPool;
+static le_mem_PoolRef_t     BatchPool;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Nmea event ID used to report Nmea events to the registered event handlers.
+ * Deleted receivers, reused with their event IDs since Legato event IDs can't be deleted, and with
+ * their position event slots.
  */
 //--------------------------------------------------------------------------------------------------
-static le_event_Id_t        NmeaEventId;
+static le_dls_List_t        FreeReceiverList = LE_DLS_LIST_INIT;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The computed position data.
+ * Batches of receivers, one per acquisition rate used. Batches are kept once created, receivers
+ * only use a handful of rates.
  */
 //--------------------------------------------------------------------------------------------------
-static pa_Gnss_Position_t   GnssPositionData;
+static le_dls_List_t        BatchList = LE_DLS_LIST_INIT;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -60,17 +298,43 @@ static le_mem_PoolRef_t     NmeaEventDataPool;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The configured SUPL assisted mode.
+ * Buffer formatting the NMEA sentences of a fix, reused from fix to fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static char                 NmeaBuffer[NMEA_BUFFER_SIZE];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Names of the start types.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* StartTypeNames[PA_TTFFSIMU_START_MAX] = { "hot", "warm", "cold", "factory" };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fix stream statistics, of all the receivers.
+ */
+//--------------------------------------------------------------------------------------------------
+static pa_gnssSimu_FixStreamStats_t FixStreamStats;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extra position event slots, allocated when all the slots of a receiver are held, not released
+ * yet by all their subscribers.
  */
 //--------------------------------------------------------------------------------------------------
-static le_gnss_AssistedMode_t SuplAssistedMode = LE_GNSS_STANDALONE_MODE;
+static uint32_t ExtraSlotCount;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * The configured bit mask for NMEA.
+ * Fix stream benchmark: subscribers, route, and trajectory and rate to restore at the end.
  */
 //--------------------------------------------------------------------------------------------------
-static le_gnss_NmeaBitMask_t NmeaBitMask = LE_GNSS_NMEA_MASK_GPGGA;
+static le_event_HandlerRef_t        BenchmarkHandlerRef[BENCHMARK_MAX_SUBSCRIBERS];
+static uint32_t                     BenchmarkSubscriberCount;
+static pa_trajectorySimu_TrackRef_t BenchmarkTrackRef;
+static pa_trajectorySimu_TrackRef_t SavedTrajectoryRef;
+static uint32_t                     SavedAcquisitionRate;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -109,223 +373,1372 @@ static void InitializeDefaultGnssPositionData
     posDataPtr->gdopValid = false;
     posDataPtr->tdopValid = false;
 
-    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
-    {
-        posDataPtr->satMeas[i].satId = 0;
-        posDataPtr->satMeas[i].satLatency = 0;
-    }
+    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
+    {
+        posDataPtr->satMeas[i].satId = 0;
+        posDataPtr->satMeas[i].satLatency = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GNSS position valid pointer initialization.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitializeValidGnssPositionData
+(
+    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+)
+{
+    int i;
+    posDataPtr->fixState = LE_GNSS_STATE_FIX_NO_POS;
+    posDataPtr->altitudeValid = true;
+    posDataPtr->altitude = 10;
+    posDataPtr->altitudeOnWgs84Valid = true;
+    posDataPtr->altitudeOnWgs84 = 10378;
+    posDataPtr->dateValid = true;
+    posDataPtr->date.year = 2017;
+    posDataPtr->date.month = 10;
+    posDataPtr->date.day = 4;
+    posDataPtr->hdopValid = true;
+    posDataPtr->hdop = 5;
+    posDataPtr->hSpeedUncertaintyValid = true;
+    posDataPtr->hSpeedUncertainty = 8090;
+    posDataPtr->hSpeedValid = true;
+    posDataPtr->hSpeed = 20;
+    posDataPtr->hUncertaintyValid = true;
+    posDataPtr->hUncertainty = 100;
+    posDataPtr->latitudeValid = true;
+    posDataPtr->latitude = 37981;
+    posDataPtr->longitudeValid = true;
+    posDataPtr->longitude = 91078;
+    posDataPtr->timeValid = true;
+    posDataPtr->epochTime = 1000;
+    posDataPtr->gpsTimeValid = true;
+    posDataPtr->gpsWeek = 7;
+    posDataPtr->gpsTimeOfWeek = 5;
+    posDataPtr->time.hours = 23;
+    posDataPtr->time.minutes = 59;
+    posDataPtr->time.seconds = 50;
+    posDataPtr->time.milliseconds = 100;
+    posDataPtr->timeAccuracyValid = true;
+    posDataPtr->timeAccuracy = 100000;
+    posDataPtr->positionLatencyValid = true;
+    posDataPtr->positionLatency = 109831;
+    posDataPtr->directionUncertaintyValid = true;
+    posDataPtr->directionUncertainty = 21987;
+    posDataPtr->directionValid = true;
+    posDataPtr->direction = 11576;
+    posDataPtr->vdopValid = true;
+    posDataPtr->vdop = 6;
+    posDataPtr->vSpeedUncertaintyValid = true;
+    posDataPtr->vSpeedUncertainty = 20;
+    posDataPtr->vSpeedValid = true;
+    posDataPtr->vSpeed = 50;
+    posDataPtr->vUncertaintyValid = true;
+    posDataPtr->vUncertainty = 100;
+    posDataPtr->pdopValid = true;
+    posDataPtr->pdop = 7;
+    posDataPtr->leapSecondsValid = true;
+    posDataPtr->leapSeconds = 30;
+    posDataPtr->gdopValid = true;
+    posDataPtr->gdop = 8;
+    posDataPtr->tdopValid = true;
+    posDataPtr->tdop = 9;
+
+    posDataPtr->satMeasValid = true;
+    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
+    {
+        posDataPtr->satMeas[i].satId = 0;
+        posDataPtr->satMeas[i].satLatency = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize default satellites info that are updated in SV information report indication.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitializeDefaultSatInfo
+(
+    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+)
+{
+    int i;
+    posDataPtr->satsInViewCountValid = false;
+    posDataPtr->satsTrackingCountValid = false;
+    posDataPtr->satInfoValid = false;
+    posDataPtr->magneticDeviationValid = false;
+
+    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
+    {
+        posDataPtr->satInfo[i].satId = 0;
+        posDataPtr->satInfo[i].satConst = LE_GNSS_SV_CONSTELLATION_UNDEFINED;
+        posDataPtr->satInfo[i].satTracked = 0;
+        posDataPtr->satInfo[i].satSnr = 0;
+        posDataPtr->satInfo[i].satAzim = 0;
+        posDataPtr->satInfo[i].satElev = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize valid satellites info that are updated in SV information report indication: the
+ * satellites in view of the valid position data, used ones included.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitializeValidSatInfo
+(
+    Receiver_t* receiverPtr     // [IN/OUT] Receiver.
+)
+{
+    pa_Gnss_Position_t* posDataPtr = &receiverPtr->positionData;
+
+    posDataPtr->magneticDeviationValid = true;
+    posDataPtr->magneticDeviation = 20;
+
+    pa_constellationSimu_GetSky(&receiverPtr->constellationConfig, posDataPtr->latitude / 1e6,
+                                posDataPtr->longitude / 1e6, DEFAULT_START_TIME, posDataPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize default satellites info that are updated as "used" in SV information report
+ * indication.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitializeDefaultSatUsedInfo
+(
+    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+)
+{
+    int i;
+    // Reset the SV marked as used in position data list.
+    posDataPtr->satsUsedCountValid = false;
+    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
+    {
+        posDataPtr->satInfo[i].satUsed = false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the dilutions of precision of the satellites used in the solution, from the inverse of
+ * the normal matrix of their line of sight unit vectors (east, north, up, clock).
+ */
+//--------------------------------------------------------------------------------------------------
+static void ComputeDop
+(
+    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+)
+{
+    double normal[4][8] = {{0}};
+    int    i;
+    int    row;
+    int    col;
+
+    for (i = 0; i < LE_GNSS_SV_INFO_MAX_LEN; i++)
+    {
+        const pa_Gnss_SvInfo_t* svPtr = &posDataPtr->satInfo[i];
+        double elevation = svPtr->satElev * M_PI / 180;
+        double azimuth = svPtr->satAzim * M_PI / 180;
+        double los[4];
+
+        if (!svPtr->satUsed)
+        {
+            continue;
+        }
+        los[0] = cos(elevation) * sin(azimuth);
+        los[1] = cos(elevation) * cos(azimuth);
+        los[2] = sin(elevation);
+        los[3] = 1;
+
+        for (row = 0; row < 4; row++)
+        {
+            for (col = 0; col < 4; col++)
+            {
+                normal[row][col] += los[row] * los[col];
+            }
+        }
+    }
+
+    // Gauss-Jordan inversion, the inverse being built in the right half of the matrix.
+    for (row = 0; row < 4; row++)
+    {
+        normal[row][4 + row] = 1;
+    }
+    for (row = 0; row < 4; row++)
+    {
+        double pivot = normal[row][row];
+
+        if (fabs(pivot) < 1e-9)
+        {
+            // Less than 4 satellites or degenerated geometry.
+            posDataPtr->hdopValid = false;
+            posDataPtr->vdopValid = false;
+            posDataPtr->pdopValid = false;
+            posDataPtr->gdopValid = false;
+            posDataPtr->tdopValid = false;
+            return;
+        }
+        for (col = 0; col < 8; col++)
+        {
+            normal[row][col] /= pivot;
+        }
+        for (i = 0; i < 4; i++)
+        {
+            double factor = normal[i][row];
+
+            if (i == row)
+            {
+                continue;
+            }
+            for (col = 0; col < 8; col++)
+            {
+                normal[i][col] -= factor * normal[row][col];
+            }
+        }
+    }
+
+    posDataPtr->hdopValid = true;
+    posDataPtr->hdop = lround(sqrt(normal[0][4] + normal[1][5]) * DOP_SCALE);
+    posDataPtr->vdopValid = true;
+    posDataPtr->vdop = lround(sqrt(normal[2][6]) * DOP_SCALE);
+    posDataPtr->pdopValid = true;
+    posDataPtr->pdop = lround(sqrt(normal[0][4] + normal[1][5] + normal[2][6]) * DOP_SCALE);
+    posDataPtr->tdopValid = true;
+    posDataPtr->tdop = lround(sqrt(normal[3][7]) * DOP_SCALE);
+    posDataPtr->gdopValid = true;
+    posDataPtr->gdop = lround(sqrt(normal[0][4] + normal[1][5] + normal[2][6] + normal[3][7])
+                              * DOP_SCALE);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the satellites info and measurements of a trajectory fix, updated once per sky update
+ * period.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateSatInfo
+(
+    Receiver_t*                    receiverPtr, // [IN/OUT] Receiver.
+    const pa_trajectorySimu_Fix_t* fixPtr,      // [IN] Trajectory fix.
+    uint64_t                       utcTime      // [IN] UTC time of the fix in milliseconds.
+)
+{
+    pa_Gnss_Position_t* posDataPtr = &receiverPtr->positionData;
+    int64_t             epoch = utcTime / SKY_UPDATE_PERIOD;
+    int                 i;
+
+    if (epoch == receiverPtr->skyEpoch)
+    {
+        return;
+    }
+    receiverPtr->skyEpoch = epoch;
+    receiverPtr->satVersion++;
+
+    pa_constellationSimu_GetSky(&receiverPtr->constellationConfig, fixPtr->latitude,
+                                fixPtr->longitude, epoch * SKY_UPDATE_PERIOD, posDataPtr);
+
+    if (!receiverPtr->fixAcquired)
+    {
+        // Still acquiring: satellites are tracked, none is used yet.
+        for (i = 0; i < LE_GNSS_SV_INFO_MAX_LEN; i++)
+        {
+            posDataPtr->satInfo[i].satUsed = false;
+        }
+        posDataPtr->satsUsedCount = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill the position data with a fix sampled on the trajectory.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateGnssPositionData
+(
+    Receiver_t*                    receiverPtr, // [IN/OUT] Receiver.
+    const pa_trajectorySimu_Fix_t* fixPtr,      // [IN] Trajectory fix.
+    uint64_t                       utcTime      // [IN] UTC time of the fix in milliseconds.
+)
+{
+    pa_Gnss_Position_t* posDataPtr = &receiverPtr->positionData;
+    time_t              seconds = utcTime / 1000;
+    uint64_t            gpsTime = utcTime - GPS_EPOCH_TIME + GPS_LEAP_SECONDS * 1000;
+    struct tm           date;
+
+    gmtime_r(&seconds, &date);
+
+    UpdateSatInfo(receiverPtr, fixPtr, utcTime);
+    ComputeDop(posDataPtr);
+
+    posDataPtr->fixState = (posDataPtr->pdopValid ? LE_GNSS_STATE_FIX_3D : LE_GNSS_STATE_FIX_NO_POS);
+    posDataPtr->latitudeValid = true;
+    posDataPtr->latitude = lround(fixPtr->latitude * 1e6);
+    posDataPtr->longitudeValid = true;
+    posDataPtr->longitude = lround(fixPtr->longitude * 1e6);
+    posDataPtr->altitudeValid = true;
+    posDataPtr->altitude = lround(fixPtr->altitude * 1e3);
+    posDataPtr->altitudeOnWgs84Valid = true;
+    posDataPtr->altitudeOnWgs84 = lround((fixPtr->altitude + GEOID_SEPARATION) * 1e3);
+    posDataPtr->hUncertaintyValid = posDataPtr->hdopValid;
+    posDataPtr->hUncertainty = lround(posDataPtr->hdop * RANGE_ERROR * 100 / DOP_SCALE);
+    posDataPtr->vUncertaintyValid = posDataPtr->vdopValid;
+    posDataPtr->vUncertainty = lround(posDataPtr->vdop * RANGE_ERROR * 10 / DOP_SCALE);
+
+    posDataPtr->hSpeedValid = true;
+    posDataPtr->hSpeed = lround(fixPtr->hSpeed * 100);
+    posDataPtr->hSpeedUncertaintyValid = true;
+    posDataPtr->hSpeedUncertainty = lround(SPEED_UNCERTAINTY * 10);
+    posDataPtr->vSpeedValid = true;
+    posDataPtr->vSpeed = lround(fixPtr->vSpeed * 100);
+    posDataPtr->vSpeedUncertaintyValid = true;
+    posDataPtr->vSpeedUncertainty = lround(SPEED_UNCERTAINTY * 10);
+    posDataPtr->directionValid = true;
+    posDataPtr->direction = lround(fixPtr->direction * 10) % 3600;
+    posDataPtr->directionUncertaintyValid = true;
+    posDataPtr->directionUncertainty = lround(atan2(SPEED_UNCERTAINTY, fixPtr->hSpeed)
+                                              * 180 / M_PI * 10);
+
+    posDataPtr->dateValid = true;
+    posDataPtr->date.year = date.tm_year + 1900;
+    posDataPtr->date.month = date.tm_mon + 1;
+    posDataPtr->date.day = date.tm_mday;
+    posDataPtr->timeValid = true;
+    posDataPtr->time.hours = date.tm_hour;
+    posDataPtr->time.minutes = date.tm_min;
+    posDataPtr->time.seconds = date.tm_sec;
+    posDataPtr->time.milliseconds = utcTime % 1000;
+    posDataPtr->epochTime = utcTime;
+    posDataPtr->gpsTimeValid = true;
+    posDataPtr->gpsWeek = gpsTime / GPS_WEEK_DURATION;
+    posDataPtr->gpsTimeOfWeek = gpsTime % GPS_WEEK_DURATION;
+    posDataPtr->leapSecondsValid = true;
+    posDataPtr->leapSeconds = GPS_LEAP_SECONDS;
+    posDataPtr->timeAccuracyValid = posDataPtr->tdopValid;
+    posDataPtr->timeAccuracy = lround(posDataPtr->tdop * RANGE_ERROR / LIGHT_SPEED / DOP_SCALE);
+    posDataPtr->positionLatencyValid = true;
+    posDataPtr->positionLatency = FIX_LATENCY;
+
+    if (!receiverPtr->fixAcquired)
+    {
+        // No solution yet, only the time if the receiver knows it.
+        posDataPtr->latitudeValid = false;
+        posDataPtr->longitudeValid = false;
+        posDataPtr->altitudeValid = false;
+        posDataPtr->altitudeOnWgs84Valid = false;
+        posDataPtr->hSpeedValid = false;
+        posDataPtr->hSpeedUncertaintyValid = false;
+        posDataPtr->vSpeedValid = false;
+        posDataPtr->vSpeedUncertaintyValid = false;
+        posDataPtr->directionValid = false;
+        posDataPtr->directionUncertaintyValid = false;
+        posDataPtr->positionLatencyValid = false;
+        posDataPtr->dateValid = receiverPtr->knowledge.timeValid;
+        posDataPtr->timeValid = receiverPtr->knowledge.timeValid;
+        posDataPtr->gpsTimeValid = receiverPtr->knowledge.timeValid;
+        posDataPtr->leapSecondsValid = receiverPtr->knowledge.timeValid;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the monotonic time in nanoseconds.
+ *
+ * @return The time.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetNanoTime
+(
+    void
+)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the UTC time of a receiver: the last injected time, advanced by the monotonic clock since the
+ * injection, else the system time. The trajectory time only dates the fixes, the validity of the
+ * ephemeris is checked against this time.
+ *
+ * @return The time in milliseconds since Jan. 1, 1970.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetReceiverTime
+(
+    const Receiver_t* receiverPtr   // [IN] Receiver.
+)
+{
+    struct timespec now;
+
+    if (0 != receiverPtr->injectedTime)
+    {
+        return receiverPtr->injectedTime
+               + (GetNanoTime() - receiverPtr->injectionNanoTime) / 1000000;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start an acquisition: the TTFF is drawn from the distribution of the start type given by the
+ * receiver knowledge.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartAcquisition
+(
+    Receiver_t* receiverPtr     // [IN/OUT] Receiver.
+)
+{
+    pa_ttffSimu_Start_t startType = pa_ttffSimu_GetStartType(&receiverPtr->knowledge,
+                                                             GetReceiverTime(receiverPtr));
+
+    receiverPtr->fixAcquired = false;
+    receiverPtr->acquisitionTime = 0;
+    receiverPtr->ttff = pa_ttffSimu_DrawTtff(startType);
+    receiverPtr->skyEpoch = -1;
+    LE_DEBUG("%s start, TTFF %"PRIu32" ms", StartTypeNames[startType], receiverPtr->ttff);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Shorten the current acquisition after an assistance, if its start type gives a shorter TTFF from
+ * now on.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RefineAcquisition
+(
+    Receiver_t* receiverPtr     // [IN/OUT] Receiver.
+)
+{
+    pa_ttffSimu_Start_t startType;
+    uint32_t            ttff;
+
+    if (!receiverPtr->acquisitionStarted || receiverPtr->fixAcquired)
+    {
+        return;
+    }
+
+    startType = pa_ttffSimu_GetStartType(&receiverPtr->knowledge, GetReceiverTime(receiverPtr));
+    ttff = receiverPtr->acquisitionTime + pa_ttffSimu_DrawTtff(startType);
+    if (ttff < receiverPtr->ttff)
+    {
+        LE_DEBUG("%s start from %"PRIu32" ms, TTFF %"PRIu32" ms",
+                 StartTypeNames[startType], receiverPtr->acquisitionTime, ttff);
+        receiverPtr->ttff = ttff;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Advance the current acquisition to the next fix.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateAcquisition
+(
+    Receiver_t* receiverPtr     // [IN/OUT] Receiver.
+)
+{
+    if (receiverPtr->fixAcquired)
+    {
+        return;
+    }
+
+    receiverPtr->acquisitionTime += receiverPtr->acquisitionRate;
+    if (receiverPtr->acquisitionTime >= receiverPtr->ttff)
+    {
+        receiverPtr->fixAcquired = true;
+        receiverPtr->skyEpoch = -1;
+        pa_ttffSimu_SetFix(&receiverPtr->knowledge, GetReceiverTime(receiverPtr));
+        LE_DEBUG("First fix, TTFF %"PRIu32" ms", receiverPtr->ttff);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a fix to the fix history, delta-encoded against the previous one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordFix
+(
+    FixHistory_t*             historyPtr,   // [IN/OUT] Fix history.
+    const pa_Gnss_Position_t* posDataPtr    // [IN] Pointer to the position data.
+)
+{
+    FixRecord_t* recordPtr = &historyPtr->records[historyPtr->index];
+
+    recordPtr->timeDelta = posDataPtr->epochTime - historyPtr->epochTime;
+    recordPtr->latitudeDelta = posDataPtr->latitude - historyPtr->latitude;
+    recordPtr->longitudeDelta = posDataPtr->longitude - historyPtr->longitude;
+    recordPtr->altitudeDelta = posDataPtr->altitude - historyPtr->altitude;
+    recordPtr->hSpeed = (posDataPtr->hSpeed > UINT16_MAX ? UINT16_MAX : posDataPtr->hSpeed);
+    recordPtr->vSpeed = (posDataPtr->vSpeed > INT16_MAX ? INT16_MAX :
+                         (posDataPtr->vSpeed < INT16_MIN ? INT16_MIN : posDataPtr->vSpeed));
+    recordPtr->direction = posDataPtr->direction;
+    recordPtr->hdop = posDataPtr->hdop;
+    recordPtr->vdop = posDataPtr->vdop;
+    recordPtr->fixState = posDataPtr->fixState;
+    recordPtr->satsUsedCount = posDataPtr->satsUsedCount;
+
+    historyPtr->epochTime = posDataPtr->epochTime;
+    historyPtr->latitude = posDataPtr->latitude;
+    historyPtr->longitude = posDataPtr->longitude;
+    historyPtr->altitude = posDataPtr->altitude;
+
+    historyPtr->index = (historyPtr->index + 1) % FIX_HISTORY_SIZE;
+    if (historyPtr->count < FIX_HISTORY_SIZE)
+    {
+        historyPtr->count++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor of the position event slots, only called for the extra slots: the receivers keep a
+ * reference on their own slots.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PositionSlotDestructor
+(
+    void* objPtr    ///< [IN] Position slot
+)
+{
+    ExtraSlotCount--;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a position event slot holding no satellite info.
+ *
+ * @return The slot, with one reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static PositionSlot_t* NewPositionSlot
+(
+    void
+)
+{
+    PositionSlot_t* slotPtr = le_mem_ForceAlloc(PositionEventDataPool);
+
+    slotPtr->satVersion = 0;
+    return slotPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a position event slot to report the position data of a receiver: one of its slots that no
+ * subscriber holds, preferably holding the current satellite info, else an extra slot released by
+ * the subscribers.
+ *
+ * @return The slot, with a reference for the subscribers.
+ */
+//--------------------------------------------------------------------------------------------------
+static PositionSlot_t* GetPositionSlot
+(
+    const Receiver_t* receiverPtr   // [IN] Receiver.
+)
+{
+    PositionSlot_t* slotPtr = NULL;
+    uint32_t        heldCount = 0;
+    int             i;
+
+    for (i = 0; i < POSITION_SLOT_COUNT; i++)
+    {
+        PositionSlot_t* freeSlotPtr = receiverPtr->slotPtr[i];
+
+        // Only the receiver references a slot that no subscriber holds.
+        if (le_mem_GetRefCount(freeSlotPtr) > 1)
+        {
+            heldCount++;
+        }
+        else if ((NULL == slotPtr) || (freeSlotPtr->satVersion == receiverPtr->satVersion))
+        {
+            slotPtr = freeSlotPtr;
+        }
+    }
+
+    if (NULL != slotPtr)
+    {
+        le_mem_AddRef(slotPtr);
+        heldCount++;
+    }
+    else
+    {
+        // All the slots are held by slow subscribers.
+        slotPtr = NewPositionSlot();
+        ExtraSlotCount++;
+    }
+
+    FixStreamStats.slotsInUse = heldCount + ExtraSlotCount;
+    if (FixStreamStats.slotsInUse > FixStreamStats.maxSlotsInUse)
+    {
+        FixStreamStats.maxSlotsInUse = FixStreamStats.slotsInUse;
+    }
+    return slotPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the pool of the position event slots, with the slots of a receiver.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitPositionSlots
+(
+    void
+)
+{
+    // The satellite info is skipped by copying around it.
+    LE_ASSERT(offsetof(pa_Gnss_Position_t, satInfo) < offsetof(pa_Gnss_Position_t, satMeas));
+
+    PositionEventDataPool = le_mem_CreatePool("PositionEventDataPool", sizeof(PositionSlot_t));
+    le_mem_SetDestructor(PositionEventDataPool, PositionSlotDestructor);
+    le_mem_ExpandPool(PositionEventDataPool, POSITION_SLOT_COUNT);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy the position data of a receiver into a slot. The satellite info and measurements are only
+ * copied if the slot doesn't already hold them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FillPositionSlot
+(
+    PositionSlot_t*   slotPtr,      ///< [IN] Position slot
+    const Receiver_t* receiverPtr   ///< [IN] Receiver
+)
+{
+    const pa_Gnss_Position_t* posDataPtr = &receiverPtr->positionData;
+    const size_t satInfoStart = offsetof(pa_Gnss_Position_t, satInfo);
+    const size_t satInfoEnd = satInfoStart + sizeof(posDataPtr->satInfo);
+    const size_t satMeasStart = offsetof(pa_Gnss_Position_t, satMeas);
+    const size_t satMeasEnd = satMeasStart + sizeof(posDataPtr->satMeas);
+
+    if (slotPtr->satVersion == receiverPtr->satVersion)
+    {
+        memcpy(&slotPtr->position, posDataPtr, satInfoStart);
+        memcpy((uint8_t*)&slotPtr->position + satInfoEnd, (const uint8_t*)posDataPtr + satInfoEnd,
+               satMeasStart - satInfoEnd);
+        memcpy((uint8_t*)&slotPtr->position + satMeasEnd, (const uint8_t*)posDataPtr + satMeasEnd,
+               sizeof(*posDataPtr) - satMeasEnd);
+        FixStreamStats.bytesCopied += sizeof(*posDataPtr) - (satInfoEnd - satInfoStart)
+                                      - (satMeasEnd - satMeasStart);
+    }
+    else
+    {
+        memcpy(&slotPtr->position, posDataPtr, sizeof(*posDataPtr));
+        slotPtr->satVersion = receiverPtr->satVersion;
+        FixStreamStats.satCopyCount++;
+        FixStreamStats.bytesCopied += sizeof(*posDataPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position handler of the fix stream benchmark subscribers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BenchmarkPositionHandler
+(
+    pa_Gnss_Position_t* posDataPtr  // [IN] Pointer to the position data.
+)
+{
+    PositionSlot_t* slotPtr = CONTAINER_OF(posDataPtr, PositionSlot_t, position);
+
+    FixStreamStats.deliveryCount++;
+    FixStreamStats.deliveryLatency += GetNanoTime() - slotPtr->reportTime;
+    le_mem_Release(posDataPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the enabled NMEA sentences of the position data of a receiver, one event per sentence.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportNmeaSentences
+(
+    const Receiver_t* receiverPtr   // [IN] Receiver.
+)
+{
+    uint64_t startTime = GetNanoTime();
+    size_t len = pa_nmeaSimu_Format(&receiverPtr->positionData, receiverPtr->nmeaBitMask,
+                                    NmeaBuffer, sizeof(NmeaBuffer));
+    char* sentencePtr = NmeaBuffer;
+
+    while (sentencePtr < NmeaBuffer + len)
+    {
+        char* endPtr = strchr(sentencePtr, '\n') + 1;
+        size_t sentenceLen = endPtr - sentencePtr;
+        char* strDataPtr = le_mem_ForceAlloc(NmeaEventDataPool);
+
+        memcpy(strDataPtr, sentencePtr, sentenceLen);
+        strDataPtr[sentenceLen] = '\0';
+        sentencePtr = endPtr;
+
+        FixStreamStats.nmeaSentenceCount++;
+        FixStreamStats.nmeaByteCount += sentenceLen;
+        le_event_ReportWithRefCounting(receiverPtr->nmeaEventId, strDataPtr);
+    }
+
+    FixStreamStats.nmeaTime += GetNanoTime() - startTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the position data of a receiver to its subscribers, and its NMEA sentences.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportPosition
+(
+    const Receiver_t* receiverPtr   // [IN] Receiver.
+)
+{
+    // Build the data for the user's event handler, shared by all the subscribers.
+    PositionSlot_t* slotPtr = GetPositionSlot(receiverPtr);
+    FillPositionSlot(slotPtr, receiverPtr);
+    slotPtr->reportTime = GetNanoTime();
+    FixStreamStats.reportCount++;
+    le_event_ReportWithRefCounting(receiverPtr->positionEventId, &slotPtr->position);
+    ReportNmeaSentences(receiverPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fire a receiver: sample its trajectory at the fix time and report the position.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FireReceiver
+(
+    Receiver_t* receiverPtr     // [IN/OUT] Receiver.
+)
+{
+    pa_trajectorySimu_Fix_t fix;
+    uint64_t                utcTime = receiverPtr->trajectoryStartTime + receiverPtr->trajectoryTime;
+
+    if (LE_OK != pa_trajectorySimu_GetFix(receiverPtr->trajectoryRef, receiverPtr->trajectoryTime,
+                                          &fix))
+    {
+        return;
+    }
+
+    uint64_t startTime = GetNanoTime();
+
+    UpdateAcquisition(receiverPtr);
+    UpdateGnssPositionData(receiverPtr, &fix, utcTime);
+    receiverPtr->trajectoryTime += receiverPtr->acquisitionRate;
+    if (NULL != receiverPtr->historyPtr)
+    {
+        RecordFix(receiverPtr->historyPtr, &receiverPtr->positionData);
+    }
+
+    ReportPosition(receiverPtr);
+
+    FixStreamStats.fixCount++;
+    FixStreamStats.fixTime += GetNanoTime() - startTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Batch timer handler: fire all the receivers of the batch, due in the same tick.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BatchTimerHandler
+(
+    le_timer_Ref_t timerRef     ///< [IN] Timer
+)
+{
+    Batch_t*       batchPtr = le_timer_GetContextPtr(timerRef);
+    le_dls_Link_t* linkPtr = le_dls_Peek(&batchPtr->receiverList);
+
+    FixStreamStats.batchCount++;
+    while (NULL != linkPtr)
+    {
+        Receiver_t* receiverPtr = CONTAINER_OF(linkPtr, Receiver_t, link);
+
+        // Moved on first: a subscriber may stop the receiver.
+        linkPtr = le_dls_PeekNext(&batchPtr->receiverList, linkPtr);
+        FireReceiver(receiverPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the batch of an acquisition rate, created if none.
+ *
+ * @return The batch.
+ */
+//--------------------------------------------------------------------------------------------------
+static Batch_t* GetBatch
+(
+    uint32_t rate   // [IN] Acquisition rate in milliseconds.
+)
+{
+    le_dls_Link_t* linkPtr;
+    Batch_t*       batchPtr;
+
+    for (linkPtr = le_dls_Peek(&BatchList); NULL != linkPtr;
+         linkPtr = le_dls_PeekNext(&BatchList, linkPtr))
+    {
+        batchPtr = CONTAINER_OF(linkPtr, Batch_t, link);
+        if (batchPtr->rate == rate)
+        {
+            return batchPtr;
+        }
+    }
+
+    batchPtr = le_mem_ForceAlloc(BatchPool);
+    batchPtr->rate = rate;
+    batchPtr->receiverList = LE_DLS_LIST_INIT;
+    batchPtr->link = LE_DLS_LINK_INIT;
+    batchPtr->timerRef = le_timer_Create("GnssFixTimer");
+    le_timer_SetMsInterval(batchPtr->timerRef, rate);
+    le_timer_SetRepeat(batchPtr->timerRef, 0);
+    le_timer_SetContextPtr(batchPtr->timerRef, batchPtr);
+    le_timer_SetHandler(batchPtr->timerRef, BatchTimerHandler);
+    le_dls_Queue(&BatchList, &batchPtr->link);
+    return batchPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a receiver in the batch of its acquisition rate if it is started and follows a trajectory,
+ * remove it from its batch otherwise. Batch timers only run while their batch isn't empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateSchedule
+(
+    Receiver_t* receiverPtr     // [IN/OUT] Receiver.
+)
+{
+    bool     scheduled = receiverPtr->acquisitionStarted && (NULL != receiverPtr->trajectoryRef);
+    Batch_t* batchPtr = receiverPtr->batchPtr;
+
+    if ((NULL != batchPtr) && (!scheduled || (batchPtr->rate != receiverPtr->acquisitionRate)))
+    {
+        le_dls_Remove(&batchPtr->receiverList, &receiverPtr->link);
+        receiverPtr->batchPtr = NULL;
+        if (le_dls_IsEmpty(&batchPtr->receiverList))
+        {
+            le_timer_Stop(batchPtr->timerRef);
+        }
+    }
+
+    if (scheduled && (NULL == receiverPtr->batchPtr))
+    {
+        batchPtr = GetBatch(receiverPtr->acquisitionRate);
+        le_dls_Queue(&batchPtr->receiverList, &receiverPtr->link);
+        receiverPtr->batchPtr = batchPtr;
+        if (!le_timer_IsRunning(batchPtr->timerRef))
+        {
+            le_timer_Start(batchPtr->timerRef);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set a receiver to its default settings, stopped, with no position and no subscriber change. Its
+ * event IDs and position event slots are kept.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitReceiver
+(
+    Receiver_t* receiverPtr     // [OUT] Receiver.
+)
+{
+    le_event_Id_t   positionEventId = receiverPtr->positionEventId;
+    le_event_Id_t   nmeaEventId = receiverPtr->nmeaEventId;
+    uint32_t        satVersion = receiverPtr->satVersion;
+    PositionSlot_t* slotPtr[POSITION_SLOT_COUNT];
+
+    memcpy(slotPtr, receiverPtr->slotPtr, sizeof(slotPtr));
+    memset(receiverPtr, 0, sizeof(*receiverPtr));
+    receiverPtr->positionEventId = positionEventId;
+    receiverPtr->nmeaEventId = nmeaEventId;
+    memcpy(receiverPtr->slotPtr, slotPtr, sizeof(slotPtr));
+    receiverPtr->satVersion = satVersion + 1;
+    receiverPtr->suplAssistedMode = LE_GNSS_STANDALONE_MODE;
+    receiverPtr->nmeaBitMask = LE_GNSS_NMEA_MASK_GPGGA;
+    receiverPtr->acquisitionRate = DEFAULT_ACQUISITION_RATE;
+    receiverPtr->skyEpoch = -1;
+    receiverPtr->link = LE_DLS_LINK_INIT;
+
+    pa_constellationSimu_SetDefaultConfig(&receiverPtr->constellationConfig);
+    pa_ttffSimu_InitKnowledge(&receiverPtr->knowledge);
+
+    InitializeDefaultGnssPositionData(&receiverPtr->positionData);
+    InitializeDefaultSatInfo(&receiverPtr->positionData);
+    InitializeDefaultSatUsedInfo(&receiverPtr->positionData);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to simulate gnss init PA gnss Module.
+ *
+ * @return LE_FAULT  The function failed.
+ * @return LE_OK     The function succeed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_gnss_Init
+(
+    void
+)
+{
+    pa_constellationSimu_Init();
+
+    ReceiverPool = le_mem_CreatePool("GnssReceiverPool", sizeof(Receiver_t));
+    le_mem_ExpandPool(ReceiverPool, 1);
+    BatchPool = le_mem_CreatePool("GnssBatchPool", sizeof(Batch_t));
+    le_mem_ExpandPool(BatchPool, 1);
+
+    InitPositionSlots();
+
+    NmeaEventDataPool = le_mem_CreatePool("NmeaEventDataPool", NMEA_STR_LEN * sizeof(char));
+    le_mem_ExpandPool(NmeaEventDataPool, NMEA_POOL_SIZE);
+
+    pa_trajectorySimu_Init();
+
+    DefaultReceiverPtr = pa_gnssSimu_CreateReceiver();
+    DefaultReceiverPtr->historyPtr = &DefaultFixHistory;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize valid position data
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_SetGnssValidPositionData
+(
+    void
+)
+{
+    InitializeValidGnssPositionData(&DefaultReceiverPtr->positionData);
+    InitializeValidSatInfo(DefaultReceiverPtr);
+    DefaultReceiverPtr->skyEpoch = -1;
+    DefaultReceiverPtr->satVersion++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the trajectory followed by the receiver, or NULL to stop following it. Its playback restarts
+ * from the beginning, one fix being reported at each acquisition period while acquisition is
+ * started.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_SetTrajectory
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Trajectory
+)
+{
+    pa_gnssSimu_SetReceiverTrajectory(DefaultReceiverPtr, trackRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a receiver, with the default settings and stopped. It is fired with the other receivers
+ * of its acquisition rate, in batches.
+ *
+ * @return The receiver.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_gnssSimu_ReceiverRef_t pa_gnssSimu_CreateReceiver
+(
+    void
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Pop(&FreeReceiverList);
+    Receiver_t*    receiverPtr;
+    int            i;
+
+    if (NULL != linkPtr)
+    {
+        receiverPtr = CONTAINER_OF(linkPtr, Receiver_t, link);
+    }
+    else
+    {
+        receiverPtr = le_mem_ForceAlloc(ReceiverPool);
+        receiverPtr->positionEventId = le_event_CreateIdWithRefCounting("GnssEventId");
+        receiverPtr->nmeaEventId = le_event_CreateIdWithRefCounting("GnssNmeaEventId");
+        receiverPtr->satVersion = 0;
+        for (i = 0; i < POSITION_SLOT_COUNT; i++)
+        {
+            receiverPtr->slotPtr[i] = NewPositionSlot();
+        }
+    }
+
+    InitReceiver(receiverPtr);
+    return receiverPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a receiver. Its subscribers must have been removed. The receiver of the PA API can't be
+ * deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_DeleteReceiver
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef   ///< [IN] Receiver
+)
+{
+    if ((NULL == receiverRef) || (DefaultReceiverPtr == receiverRef))
+    {
+        LE_ERROR("Invalid receiver %p", receiverRef);
+        return;
+    }
+
+    receiverRef->acquisitionStarted = false;
+    UpdateSchedule(receiverRef);
+    le_dls_Stack(&FreeReceiverList, &receiverRef->link);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the trajectory followed by a receiver, or NULL to stop following it. Its playback restarts
+ * from the beginning, one fix being reported at each acquisition period while the receiver is
+ * started.
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_SetReceiverTrajectory
+(
+    pa_gnssSimu_ReceiverRef_t    receiverRef,   ///< [IN] Receiver
+    pa_trajectorySimu_TrackRef_t trackRef       ///< [IN] Trajectory
+)
+{
+    receiverRef->trajectoryRef = trackRef;
+    receiverRef->trajectoryTime = 0;
+    receiverRef->skyEpoch = -1;
+    if (NULL != receiverRef->historyPtr)
+    {
+        receiverRef->historyPtr->count = 0;
+    }
+
+    if (NULL != trackRef)
+    {
+        receiverRef->trajectoryStartTime = pa_trajectorySimu_GetStartTime(trackRef);
+        if (0 == receiverRef->trajectoryStartTime)
+        {
+            receiverRef->trajectoryStartTime = DEFAULT_START_TIME;
+        }
+    }
+    UpdateSchedule(receiverRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the acquisition rate of a receiver, moving it to the batch of this rate.
+ *
+ * @return LE_FAULT         Null rate.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_gnssSimu_SetReceiverAcquisitionRate
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef,  ///< [IN] Receiver
+    uint32_t                  rate          ///< [IN] Acquisition rate in milliseconds
+)
+{
+    if (0 == rate)
+    {
+        LE_ERROR("Invalid acquisition rate");
+        return LE_FAULT;
+    }
+
+    receiverRef->acquisitionRate = rate;
+    UpdateSchedule(receiverRef);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the acquisition of a receiver.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_StartReceiver
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef   ///< [IN] Receiver
+)
+{
+    if (!receiverRef->acquisitionStarted)
+    {
+        StartAcquisition(receiverRef);
+    }
+    receiverRef->acquisitionStarted = true;
+    UpdateSchedule(receiverRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the acquisition of a receiver.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_StopReceiver
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef   ///< [IN] Receiver
+)
+{
+    receiverRef->acquisitionStarted = false;
+    UpdateSchedule(receiverRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a position handler to a receiver. The handler gets the receiver with
+ * le_event_GetContextPtr(), and is removed with pa_gnss_RemovePositionDataHandler().
+ *
+ * @return A handler reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_HandlerRef_t pa_gnssSimu_AddReceiverPositionHandler
+(
+    pa_gnssSimu_ReceiverRef_t         receiverRef,  ///< [IN] Receiver
+    pa_gnss_PositionDataHandlerFunc_t handler       ///< [IN] Handler function
+)
+{
+    LE_FATAL_IF((handler==NULL),"gnss module cannot set handler");
+
+    le_event_HandlerRef_t handlerRef = le_event_AddHandler("gpsInformationHandler",
+                                                           receiverRef->positionEventId,
+                                                           (le_event_HandlerFunc_t) handler);
+    le_event_SetContextPtr(handlerRef, receiverRef);
+    return handlerRef;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * GNSS position valid pointer initialization.
+ * Add an NMEA handler to a receiver. The handler gets the receiver with le_event_GetContextPtr(),
+ * and is removed with le_event_RemoveHandler().
+ *
+ * @return A handler reference.
  */
 //--------------------------------------------------------------------------------------------------
-static void InitializeValidGnssPositionData
+le_event_HandlerRef_t pa_gnssSimu_AddReceiverNmeaHandler
 (
-    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+    pa_gnssSimu_ReceiverRef_t receiverRef,  ///< [IN] Receiver
+    pa_gnss_NmeaHandlerFunc_t handler       ///< [IN] Handler function
 )
 {
-    int i;
-    posDataPtr->fixState = LE_GNSS_STATE_FIX_NO_POS;
-    posDataPtr->altitudeValid = true;
-    posDataPtr->altitude = 10;
-    posDataPtr->altitudeOnWgs84Valid = true;
-    posDataPtr->altitudeOnWgs84 = 10378;
-    posDataPtr->dateValid = true;
-    posDataPtr->date.year = 2017;
-    posDataPtr->date.month = 10;
-    posDataPtr->date.day = 4;
-    posDataPtr->hdopValid = true;
-    posDataPtr->hdop = 5;
-    posDataPtr->hSpeedUncertaintyValid = true;
-    posDataPtr->hSpeedUncertainty = 8090;
-    posDataPtr->hSpeedValid = true;
-    posDataPtr->hSpeed = 20;
-    posDataPtr->hUncertaintyValid = true;
-    posDataPtr->hUncertainty = 100;
-    posDataPtr->latitudeValid = true;
-    posDataPtr->latitude = 37981;
-    posDataPtr->longitudeValid = true;
-    posDataPtr->longitude = 91078;
-    posDataPtr->timeValid = true;
-    posDataPtr->epochTime = 1000;
-    posDataPtr->gpsTimeValid = true;
-    posDataPtr->gpsWeek = 7;
-    posDataPtr->gpsTimeOfWeek = 5;
-    posDataPtr->time.hours = 23;
-    posDataPtr->time.minutes = 59;
-    posDataPtr->time.seconds = 50;
-    posDataPtr->time.milliseconds = 100;
-    posDataPtr->timeAccuracyValid = true;
-    posDataPtr->timeAccuracy = 100000;
-    posDataPtr->positionLatencyValid = true;
-    posDataPtr->positionLatency = 109831;
-    posDataPtr->directionUncertaintyValid = true;
-    posDataPtr->directionUncertainty = 21987;
-    posDataPtr->directionValid = true;
-    posDataPtr->direction = 11576;
-    posDataPtr->vdopValid = true;
-    posDataPtr->vdop = 6;
-    posDataPtr->vSpeedUncertaintyValid = true;
-    posDataPtr->vSpeedUncertainty = 20;
-    posDataPtr->vSpeedValid = true;
-    posDataPtr->vSpeed = 50;
-    posDataPtr->vUncertaintyValid = true;
-    posDataPtr->vUncertainty = 100;
-    posDataPtr->pdopValid = true;
-    posDataPtr->pdop = 7;
-    posDataPtr->leapSecondsValid = true;
-    posDataPtr->leapSeconds = 30;
-    posDataPtr->gdopValid = true;
-    posDataPtr->gdop = 8;
-    posDataPtr->tdopValid = true;
-    posDataPtr->tdop = 9;
+    LE_FATAL_IF((handler==NULL),"gnss module cannot set handler");
 
-    posDataPtr->satMeasValid = true;
-    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
-    {
-        posDataPtr->satMeas[i].satId = 0;
-        posDataPtr->satMeas[i].satLatency = 0;
-    }
+    le_event_HandlerRef_t handlerRef = le_event_AddHandler("gnssNmeaHandler",
+                                                           receiverRef->nmeaEventId,
+                                                           (le_event_HandlerFunc_t) handler);
+    le_event_SetContextPtr(handlerRef, receiverRef);
+    return handlerRef;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize default satellites info that are updated in SV information report indication.
+ * Set the NMEA sentences reported by a receiver.
+ *
  */
 //--------------------------------------------------------------------------------------------------
-static void InitializeDefaultSatInfo
+void pa_gnssSimu_SetReceiverNmeaSentences
 (
-    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+    pa_gnssSimu_ReceiverRef_t receiverRef,  ///< [IN] Receiver
+    le_gnss_NmeaBitMask_t     nmeaMask      ///< [IN] Enabled NMEA sentences
 )
 {
-    int i;
-    posDataPtr->satsInViewCountValid = false;
-    posDataPtr->satsTrackingCountValid = false;
-    posDataPtr->satInfoValid = false;
-    posDataPtr->magneticDeviationValid = false;
-
-    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
-    {
-        posDataPtr->satInfo[i].satId = 0;
-        posDataPtr->satInfo[i].satConst = LE_GNSS_SV_CONSTELLATION_UNDEFINED;
-        posDataPtr->satInfo[i].satTracked = 0;
-        posDataPtr->satInfo[i].satSnr = 0;
-        posDataPtr->satInfo[i].satAzim = 0;
-        posDataPtr->satInfo[i].satElev = 0;
-    }
+    receiverRef->nmeaBitMask = nmeaMask;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize valid satellites info that are updated in SV information report indication.
+ * Get a fix of the fix history, decoded from the compact fixes. Only the solution is set in the
+ * position data: fix state, position, speeds, direction, time, horizontal and vertical DOPs and
+ * number of satellites used.
+ *
+ * @return LE_OUT_OF_RANGE  The history doesn't go back that far.
+ * @return LE_BAD_PARAMETER NULL position data pointer.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-static void InitializeValidSatInfo
+le_result_t pa_gnssSimu_GetFixHistory
 (
-    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+    uint32_t            age,            ///< [IN] Age of the fix: 0 for the last one
+    pa_Gnss_Position_t* posDataPtr      ///< [OUT] Position data
 )
 {
-    int i;
-    posDataPtr->satsInViewCountValid = true;
-    posDataPtr->satsInViewCount = 10;
-    posDataPtr->satsTrackingCountValid = true;
-    posDataPtr->satsTrackingCount = 8;
-    posDataPtr->magneticDeviationValid = true;
-    posDataPtr->magneticDeviation = 20;
-    posDataPtr->satInfoValid = true;
+    const FixRecord_t* recordPtr;
+    uint32_t           index;
+    uint32_t           i;
 
-    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
+    if (NULL == posDataPtr)
     {
-        posDataPtr->satInfo[i].satId = 0;
-        posDataPtr->satInfo[i].satConst = LE_GNSS_SV_CONSTELLATION_UNDEFINED;
-        posDataPtr->satInfo[i].satTracked = 0;
-        posDataPtr->satInfo[i].satSnr = 0;
-        posDataPtr->satInfo[i].satAzim = 0;
-        posDataPtr->satInfo[i].satElev = 0;
+        return LE_BAD_PARAMETER;
     }
+    if (age >= DefaultFixHistory.count)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    InitializeDefaultGnssPositionData(posDataPtr);
+    InitializeDefaultSatInfo(posDataPtr);
+    InitializeDefaultSatUsedInfo(posDataPtr);
+    posDataPtr->epochTime = DefaultFixHistory.epochTime;
+    posDataPtr->latitude = DefaultFixHistory.latitude;
+    posDataPtr->longitude = DefaultFixHistory.longitude;
+    posDataPtr->altitude = DefaultFixHistory.altitude;
+
+    // Walk back from the last fix, undoing the deltas.
+    index = (DefaultFixHistory.index + FIX_HISTORY_SIZE - 1) % FIX_HISTORY_SIZE;
+    for (i = 0; i < age; i++)
+    {
+        recordPtr = &DefaultFixHistory.records[index];
+        posDataPtr->epochTime -= recordPtr->timeDelta;
+        posDataPtr->latitude -= recordPtr->latitudeDelta;
+        posDataPtr->longitude -= recordPtr->longitudeDelta;
+        posDataPtr->altitude -= recordPtr->altitudeDelta;
+        index = (index + FIX_HISTORY_SIZE - 1) % FIX_HISTORY_SIZE;
+    }
+    recordPtr = &DefaultFixHistory.records[index];
+
+    posDataPtr->fixState = recordPtr->fixState;
+    posDataPtr->timeValid = true;
+    posDataPtr->latitudeValid = true;
+    posDataPtr->longitudeValid = true;
+    posDataPtr->altitudeValid = true;
+    posDataPtr->hSpeedValid = true;
+    posDataPtr->hSpeed = recordPtr->hSpeed;
+    posDataPtr->vSpeedValid = true;
+    posDataPtr->vSpeed = recordPtr->vSpeed;
+    posDataPtr->directionValid = true;
+    posDataPtr->direction = recordPtr->direction;
+    posDataPtr->hdopValid = true;
+    posDataPtr->hdop = recordPtr->hdop;
+    posDataPtr->vdopValid = true;
+    posDataPtr->vdop = recordPtr->vdop;
+    posDataPtr->satsUsedCountValid = true;
+    posDataPtr->satsUsedCount = recordPtr->satsUsedCount;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize default satellites info that are updated as "used" in SV information report
- * indication.
+ * Get the fix stream statistics.
+ *
  */
 //--------------------------------------------------------------------------------------------------
-static void InitializeDefaultSatUsedInfo
+void pa_gnssSimu_GetFixStreamStats
 (
-    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+    pa_gnssSimu_FixStreamStats_t* statsPtr  ///< [OUT] Statistics
 )
 {
-    int i;
-    // Reset the SV marked as used in position data list.
-    posDataPtr->satsUsedCountValid = false;
-    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
-    {
-        posDataPtr->satInfo[i].satUsed = false;
-    }
+    LE_ASSERT(statsPtr);
+
+    *statsPtr = FixStreamStats;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize valid satellites info that are updated as "used" in SV information report
- * indication.
+ * Reset the fix stream statistics, except the slots in use.
+ *
  */
 //--------------------------------------------------------------------------------------------------
-static void InitializeValidSatUsedInfo
+void pa_gnssSimu_ResetFixStreamStats
 (
-    pa_Gnss_Position_t* posDataPtr  // [IN/OUT] Pointer to the position data.
+    void
 )
 {
-    int i;
-    // Reset the SV marked as used in position data list.
-    posDataPtr->satsUsedCountValid = true;
-    posDataPtr->satsUsedCount = 5;
-    for (i=0; i<LE_GNSS_SV_INFO_MAX_LEN; i++)
-    {
-        posDataPtr->satInfo[i].satUsed = 5;
-    }
+    uint32_t slotsInUse = FixStreamStats.slotsInUse;
+
+    memset(&FixStreamStats, 0, sizeof(FixStreamStats));
+    FixStreamStats.slotsInUse = slotsInUse;
+    FixStreamStats.maxSlotsInUse = slotsInUse;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * This function must be called to simulate gnss init PA gnss Module.
+ * Start the fix stream benchmark: the receiver drives around a square at the given rate, and the
+ * fixes are delivered to subscriberCount position handlers. The statistics are reset, and then
+ * collected until pa_gnssSimu_StopFixStreamBenchmark() is called.
  *
- * @return LE_FAULT  The function failed.
- * @return LE_OK     The function succeed.
+ * @return LE_BUSY          The benchmark is already running.
+ * @return LE_OUT_OF_RANGE  Invalid rate or number of subscribers.
+ * @return LE_OK            Function succeeded.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t pa_gnss_Init
+le_result_t pa_gnssSimu_StartFixStreamBenchmark
 (
-    void
+    uint32_t rate,              ///< [IN] Acquisition rate in milliseconds
+    uint32_t subscriberCount    ///< [IN] Number of subscribers
 )
 {
-    InitializeDefaultGnssPositionData(&GnssPositionData);
-    InitializeDefaultSatInfo(&GnssPositionData);
-    InitializeDefaultSatUsedInfo(&GnssPositionData);
+    uint32_t i;
+
+    if (NULL != BenchmarkTrackRef)
+    {
+        return LE_BUSY;
+    }
+    if ((0 == rate) || (0 == subscriberCount) || (subscriberCount > BENCHMARK_MAX_SUBSCRIBERS))
+    {
+        LE_ERROR("Invalid benchmark: %"PRIu32" ms, %"PRIu32" subscribers", rate, subscriberCount);
+        return LE_OUT_OF_RANGE;
+    }
 
-    GnssEventId = le_event_CreateIdWithRefCounting("GnssEventId");
-    NmeaEventId = le_event_CreateIdWithRefCounting("GnssNmeaEventId");
+    BenchmarkTrackRef = pa_trajectorySimu_CreateTrack();
+    LE_ASSERT_OK(pa_trajectorySimu_AddWaypoint(BenchmarkTrackRef, 0, BENCHMARK_LATITUDE,
+                                               BENCHMARK_LONGITUDE, 0));
+    for (i = 0; i < 4; i++)
+    {
+        LE_ASSERT_OK(pa_trajectorySimu_AddLeg(BenchmarkTrackRef, 90.0 * i, BENCHMARK_LEG_LENGTH,
+                                              BENCHMARK_SPEED));
+    }
+    pa_trajectorySimu_SetLoop(BenchmarkTrackRef, true);
 
-    PositionEventDataPool = le_mem_CreatePool("PositionEventDataPool", sizeof(pa_Gnss_Position_t));
-    NmeaEventDataPool = le_mem_CreatePool("NmeaEventDataPool", NMEA_STR_LEN * sizeof(char));
-    return LE_OK;
+    for (i = 0; i < subscriberCount; i++)
+    {
+        BenchmarkHandlerRef[i] = pa_gnss_AddPositionDataHandler(BenchmarkPositionHandler);
+    }
+    BenchmarkSubscriberCount = subscriberCount;
+
+    SavedTrajectoryRef = DefaultReceiverPtr->trajectoryRef;
+    SavedAcquisitionRate = DefaultReceiverPtr->acquisitionRate;
+    pa_gnss_SetAcquisitionRate(rate);
+    pa_gnssSimu_SetTrajectory(BenchmarkTrackRef);
+    pa_gnssSimu_ResetFixStreamStats();
+    return pa_gnss_Start();
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Initialize valid position data
+ * Stop the fix stream benchmark, and restore the trajectory and the rate set before it. The
+ * acquisition is stopped.
+ *
  */
 //--------------------------------------------------------------------------------------------------
-void pa_gnssSimu_SetGnssValidPositionData
+void pa_gnssSimu_StopFixStreamBenchmark
 (
     void
 )
 {
-    InitializeValidGnssPositionData(&GnssPositionData);
-    InitializeValidSatInfo(&GnssPositionData);
-    InitializeValidSatUsedInfo(&GnssPositionData);
+    uint32_t i;
+
+    if (NULL == BenchmarkTrackRef)
+    {
+        return;
+    }
+
+    pa_gnss_Stop();
+    for (i = 0; i < BenchmarkSubscriberCount; i++)
+    {
+        pa_gnss_RemovePositionDataHandler(BenchmarkHandlerRef[i]);
+    }
+    BenchmarkSubscriberCount = 0;
+
+    pa_gnssSimu_SetTrajectory(SavedTrajectoryRef);
+    pa_gnss_SetAcquisitionRate(SavedAcquisitionRate);
+    pa_trajectorySimu_DeleteTrack(BenchmarkTrackRef);
+    BenchmarkTrackRef = NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -359,6 +1772,16 @@ le_result_t pa_gnss_SetConstellation
     le_gnss_ConstellationBitMask_t constellationMask  ///< [IN] GNSS constellation used in solution.
 )
 {
+    if (constellationMask & ~(LE_GNSS_CONSTELLATION_GPS | LE_GNSS_CONSTELLATION_GLONASS |
+                              LE_GNSS_CONSTELLATION_BEIDOU | LE_GNSS_CONSTELLATION_GALILEO |
+                              LE_GNSS_CONSTELLATION_SBAS | LE_GNSS_CONSTELLATION_QZSS))
+    {
+        LE_ERROR("Unsupported constellation mask 0x%X", constellationMask);
+        return LE_UNSUPPORTED;
+    }
+
+    DefaultReceiverPtr->constellationConfig.constellationMask = constellationMask;
+    DefaultReceiverPtr->skyEpoch = -1;
     return LE_OK;
 }
 
@@ -377,6 +1800,13 @@ le_result_t pa_gnss_GetConstellation
                                                          ///< solution
 )
 {
+    if (NULL == constellationMaskPtr)
+    {
+        LE_ERROR("NULL pointer");
+        return LE_FAULT;
+    }
+
+    *constellationMaskPtr = DefaultReceiverPtr->constellationConfig.constellationMask;
     return LE_OK;
 }
 
@@ -397,6 +1827,21 @@ le_result_t pa_gnss_SetConstellationArea
     le_gnss_ConstellationArea_t constellationArea   ///< [IN] GNSS constellation area.
 )
 {
+    if ((satConstellation <= LE_GNSS_SV_CONSTELLATION_UNDEFINED) ||
+        (satConstellation >= LE_GNSS_SV_CONSTELLATION_MAX))
+    {
+        LE_ERROR("Invalid constellation %d", satConstellation);
+        return LE_FAULT;
+    }
+    if ((LE_GNSS_WORLDWIDE_AREA != constellationArea) &&
+        (LE_GNSS_OUTSIDE_US_AREA != constellationArea))
+    {
+        LE_ERROR("Invalid area %d", constellationArea);
+        return LE_BAD_PARAMETER;
+    }
+
+    DefaultReceiverPtr->constellationConfig.area[satConstellation] = constellationArea;
+    DefaultReceiverPtr->skyEpoch = -1;
     return LE_OK;
 }
 
@@ -416,7 +1861,16 @@ le_result_t pa_gnss_GetConstellationArea
     le_gnss_ConstellationArea_t* constellationAreaPtr ///< [OUT] GNSS constellation area.
 )
 {
-   return LE_FAULT;
+    if ((NULL == constellationAreaPtr) ||
+        (satConstellation <= LE_GNSS_SV_CONSTELLATION_UNDEFINED) ||
+        (satConstellation >= LE_GNSS_SV_CONSTELLATION_MAX))
+    {
+        LE_ERROR("Invalid parameter");
+        return LE_FAULT;
+    }
+
+    *constellationAreaPtr = DefaultReceiverPtr->constellationConfig.area[satConstellation];
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -432,6 +1886,7 @@ le_result_t pa_gnss_Start
     void
 )
 {
+    pa_gnssSimu_StartReceiver(DefaultReceiverPtr);
     return LE_OK;
 }
 
@@ -448,6 +1903,7 @@ le_result_t pa_gnss_Stop
     void
 )
 {
+    pa_gnssSimu_StopReceiver(DefaultReceiverPtr);
     return LE_OK;
 }
 
@@ -467,9 +1923,7 @@ le_result_t pa_gnss_SetAcquisitionRate
     uint32_t rate     ///< [IN] rate in milliseconds
 )
 {
-
-
-    return LE_OK;
+    return pa_gnssSimu_SetReceiverAcquisitionRate(DefaultReceiverPtr, rate);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -486,8 +1940,14 @@ le_result_t pa_gnss_GetAcquisitionRate
     uint32_t* ratePtr     ///< [IN] rate in milliseconds
 )
 {
+    if (NULL == ratePtr)
+    {
+        LE_ERROR("NULL pointer");
+        return LE_FAULT;
+    }
 
-    return LE_FAULT;
+    *ratePtr = DefaultReceiverPtr->acquisitionRate;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -501,13 +1961,7 @@ void pa_gnssSimu_ReportEvent
     void
 )
 {
-    // Build the data for the user's event handler.
-    pa_Gnss_Position_t* posDataPtr = le_mem_ForceAlloc(PositionEventDataPool);
-    memcpy(posDataPtr, &GnssPositionData, sizeof(pa_Gnss_Position_t));
-    le_event_ReportWithRefCounting(GnssEventId, posDataPtr);
-    char* strDataPtr = le_mem_ForceAlloc(NmeaEventDataPool);
-    strncpy(strDataPtr, "nmea", NMEA_STR_LEN);
-    le_event_ReportWithRefCounting(NmeaEventId, strDataPtr);
+    ReportPosition(DefaultReceiverPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -528,7 +1982,7 @@ le_event_HandlerRef_t pa_gnss_AddPositionDataHandler
 
     le_event_HandlerRef_t newHandlerPtr = le_event_AddHandler(
                                                             "gpsInformationHandler",
-                                                            GnssEventId,
+                                                            DefaultReceiverPtr->positionEventId,
                                                             (le_event_HandlerFunc_t) handler);
 
     return newHandlerPtr;
@@ -558,7 +2012,6 @@ void pa_gnss_RemovePositionDataHandler
  * @return LE_FORMAT_ERROR  'Extended Ephemeris' file format error.
  * @return LE_OK            The function succeeded.
  *
- * @TODO    implementation
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_gnss_LoadExtendedEphemerisFile
@@ -566,7 +2019,24 @@ le_result_t pa_gnss_LoadExtendedEphemerisFile
     int32_t       fd      ///< [IN] extended ephemeris file descriptor
 )
 {
-    return LE_FAULT;
+    uint64_t    startTime;
+    uint64_t    stopTime;
+    uint32_t    recordCount;
+    le_result_t result = pa_xtraSimu_Parse(fd, &startTime, &stopTime, &recordCount);
+
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    LE_INFO("Extended ephemeris of %"PRIu32" satellites valid from %"PRIu64" to %"PRIu64" s",
+            recordCount, startTime, stopTime);
+
+    // Only the validity is kept: the simulated orbits don't depend on the ephemeris.
+    DefaultReceiverPtr->knowledge.xtraStartTime = startTime;
+    DefaultReceiverPtr->knowledge.xtraStopTime = stopTime;
+    RefineAcquisition(DefaultReceiverPtr);
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -576,7 +2046,6 @@ le_result_t pa_gnss_LoadExtendedEphemerisFile
  * @return LE_FAULT         The function failed to get the validity
  * @return LE_OK            The function succeeded.
  *
- * @TODO    implementation
  */
 //--------------------------------------------------------------------------------------------------
 le_result_t pa_gnss_GetExtendedEphemerisValidity
@@ -585,7 +2054,20 @@ le_result_t pa_gnss_GetExtendedEphemerisValidity
     uint64_t *stopTimePtr      ///< [OUT] Stop time in seconds (since Jan. 1, 1970)
 )
 {
-    return LE_FAULT;
+    if ((NULL == startTimePtr) || (NULL == stopTimePtr))
+    {
+        LE_ERROR("Invalid pointer");
+        return LE_FAULT;
+    }
+    if (0 == DefaultReceiverPtr->knowledge.xtraStartTime)
+    {
+        LE_ERROR("No extended ephemeris loaded");
+        return LE_FAULT;
+    }
+
+    *startTimePtr = DefaultReceiverPtr->knowledge.xtraStartTime;
+    *stopTimePtr = DefaultReceiverPtr->knowledge.xtraStopTime;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -602,7 +2084,9 @@ le_result_t pa_gnss_EnableExtendedEphemerisFile
     void
 )
 {
-    return LE_FAULT;
+    DefaultReceiverPtr->knowledge.xtraEnabled = true;
+    RefineAcquisition(DefaultReceiverPtr);
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -619,7 +2103,8 @@ le_result_t pa_gnss_DisableExtendedEphemerisFile
     void
 )
 {
-    return LE_FAULT;
+    DefaultReceiverPtr->knowledge.xtraEnabled = false;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -639,7 +2124,21 @@ le_result_t pa_gnss_InjectUtcTime
     uint32_t timeUnc       ///< [IN] Time uncertainty in milliseconds
 )
 {
-    return LE_FAULT;
+    if (0 == timeUtc)
+    {
+        LE_ERROR("Invalid UTC time");
+        return LE_FAULT;
+    }
+
+    // A time too uncertain doesn't help the acquisition.
+    if (timeUnc <= TIME_INJECTION_MAX_UNCERTAINTY)
+    {
+        DefaultReceiverPtr->injectedTime = timeUtc;
+        DefaultReceiverPtr->injectionNanoTime = GetNanoTime();
+        DefaultReceiverPtr->knowledge.timeValid = true;
+        RefineAcquisition(DefaultReceiverPtr);
+    }
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -655,7 +2154,20 @@ le_result_t pa_gnss_ForceRestart
     pa_gnss_Restart_t  restartType ///< [IN] type of restart
 )
 {
-    return LE_FAULT;
+    if (LE_OK != pa_ttffSimu_Restart(&DefaultReceiverPtr->knowledge, restartType))
+    {
+        return LE_FAULT;
+    }
+    if (!DefaultReceiverPtr->knowledge.timeValid)
+    {
+        DefaultReceiverPtr->injectedTime = 0;
+    }
+
+    if (DefaultReceiverPtr->acquisitionStarted)
+    {
+        StartAcquisition(DefaultReceiverPtr);
+    }
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -671,7 +2183,18 @@ le_result_t pa_gnss_GetTtff
     uint32_t* ttffPtr     ///< [OUT] TTFF in milliseconds
 )
 {
-    return LE_FAULT;
+    if (NULL == ttffPtr)
+    {
+        LE_ERROR("NULL pointer");
+        return LE_FAULT;
+    }
+    if (!DefaultReceiverPtr->fixAcquired)
+    {
+        return LE_BUSY;
+    }
+
+    *ttffPtr = DefaultReceiverPtr->ttff;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -748,7 +2271,7 @@ le_result_t pa_gnss_GetSuplAssistedMode
     }
 
     // Get the SUPL assisted mode
-    *assistedModePtr = SuplAssistedMode;
+    *assistedModePtr = DefaultReceiverPtr->suplAssistedMode;
     return LE_OK;
 }
 
@@ -852,6 +2375,7 @@ le_result_t pa_gnss_SetNmeaSentences
     le_gnss_NmeaBitMask_t nmeaMask ///< [IN] Bit mask for enabled NMEA sentences.
 )
 {
+    pa_gnssSimu_SetReceiverNmeaSentences(DefaultReceiverPtr, nmeaMask);
     return LE_OK;
 }
 
@@ -877,7 +2401,7 @@ le_result_t pa_gnss_GetNmeaSentences
         return LE_FAULT;
     }
 
-    *nmeaMaskPtr = NmeaBitMask;
+    *nmeaMaskPtr = DefaultReceiverPtr->nmeaBitMask;
     return LE_OK;
 }
 
@@ -899,7 +2423,7 @@ le_event_HandlerRef_t pa_gnss_AddNmeaHandler
 
     le_event_HandlerRef_t newHandlerPtr = le_event_AddHandler(
                                                             "gnssNmeaHandler",
-                                                            NmeaEventId,
+                                                            DefaultReceiverPtr->nmeaEventId,
                                                             (le_event_HandlerFunc_t) handler);
     return newHandlerPtr;
 }
@@ -919,6 +2443,14 @@ le_result_t pa_gnss_SetMinElevation
     uint8_t  minElevation      ///< [IN] Minimum elevation in degrees [range 0..90].
 )
 {
+    if (minElevation > 90)
+    {
+        LE_ERROR("Invalid minimum elevation %u", minElevation);
+        return LE_FAULT;
+    }
+
+    DefaultReceiverPtr->constellationConfig.minElevation = minElevation;
+    DefaultReceiverPtr->skyEpoch = -1;
     return LE_OK;
 }
 
@@ -938,6 +2470,13 @@ le_result_t pa_gnss_GetMinElevation
    uint8_t*  minElevationPtr     ///< [OUT] Minimum elevation in degrees [range 0..90].
 )
 {
+    if (NULL == minElevationPtr)
+    {
+        LE_ERROR("NULL pointer");
+        return LE_BAD_PARAMETER;
+    }
+
+    *minElevationPtr = DefaultReceiverPtr->constellationConfig.minElevation;
     return LE_OK;
 }
 
@@ -8,6 +8,39 @@
 #ifndef LEGATO_PA_GNSS_SIMU_INCLUDE_GUARD
 #define LEGATO_PA_GNSS_SIMU_INCLUDE_GUARD
 
+#include "pa_trajectory_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a simulated receiver.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_gnssSimu_Receiver* pa_gnssSimu_ReceiverRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fix stream statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint64_t fixCount;          ///< Trajectory fixes computed and reported
+    uint64_t batchCount;        ///< Batches of receivers fired
+    uint64_t fixTime;           ///< Time spent computing and reporting them, in nanoseconds
+    uint64_t reportCount;       ///< Position events reported
+    uint64_t satCopyCount;      ///< Reports that copied the satellite info
+    uint64_t bytesCopied;       ///< Bytes copied into the position events
+    uint64_t deliveryCount;     ///< Position events delivered to the benchmark subscribers
+    uint64_t deliveryLatency;   ///< Total time between reports and deliveries, in nanoseconds
+    uint64_t nmeaSentenceCount; ///< NMEA sentences reported
+    uint64_t nmeaByteCount;     ///< Bytes of the NMEA sentences reported
+    uint64_t nmeaTime;          ///< Time spent formatting and reporting them, in nanoseconds
+    uint32_t slotsInUse;        ///< Position events not released yet by all their subscribers,
+                                ///< counted at the last report
+    uint32_t maxSlotsInUse;     ///< Maximum of slotsInUse
+}
+pa_gnssSimu_FixStreamStats_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position event report.
@@ -30,4 +63,196 @@ void pa_gnssSimu_SetGnssValidPositionData
     void
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the trajectory followed by the receiver, or NULL to stop following it. While acquisition is
+ * started, the trajectory is sampled and the position reported at the acquisition rate.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_SetTrajectory
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Trajectory
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a receiver, with the default settings and stopped. The receivers started at the same
+ * acquisition rate are fired together, by one timer.
+ *
+ * @return The receiver.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_gnssSimu_ReceiverRef_t pa_gnssSimu_CreateReceiver
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a receiver. Its subscribers must have been removed. The receiver of the PA API can't be
+ * deleted.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_DeleteReceiver
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef   ///< [IN] Receiver
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the trajectory followed by a receiver, or NULL to stop following it.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_SetReceiverTrajectory
+(
+    pa_gnssSimu_ReceiverRef_t    receiverRef,   ///< [IN] Receiver
+    pa_trajectorySimu_TrackRef_t trackRef       ///< [IN] Trajectory
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the acquisition rate of a receiver.
+ *
+ * @return LE_FAULT         Null rate.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_gnssSimu_SetReceiverAcquisitionRate
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef,  ///< [IN] Receiver
+    uint32_t                  rate          ///< [IN] Acquisition rate in milliseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the acquisition of a receiver.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_StartReceiver
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef   ///< [IN] Receiver
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the acquisition of a receiver.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_StopReceiver
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef   ///< [IN] Receiver
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a position handler to a receiver. The handler gets the receiver with
+ * le_event_GetContextPtr(), and is removed with pa_gnss_RemovePositionDataHandler().
+ *
+ * @return A handler reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_HandlerRef_t pa_gnssSimu_AddReceiverPositionHandler
+(
+    pa_gnssSimu_ReceiverRef_t         receiverRef,  ///< [IN] Receiver
+    pa_gnss_PositionDataHandlerFunc_t handler       ///< [IN] Handler function
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an NMEA handler to a receiver. The handler gets the receiver with le_event_GetContextPtr(),
+ * and is removed with le_event_RemoveHandler().
+ *
+ * @return A handler reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_event_HandlerRef_t pa_gnssSimu_AddReceiverNmeaHandler
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef,  ///< [IN] Receiver
+    pa_gnss_NmeaHandlerFunc_t handler       ///< [IN] Handler function
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the NMEA sentences reported by a receiver.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_SetReceiverNmeaSentences
+(
+    pa_gnssSimu_ReceiverRef_t receiverRef,  ///< [IN] Receiver
+    le_gnss_NmeaBitMask_t     nmeaMask      ///< [IN] Enabled NMEA sentences
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a fix of the fix history: fix state, position, speeds, direction, time, horizontal and
+ * vertical DOPs and number of satellites used.
+ *
+ * @return LE_OUT_OF_RANGE  The history doesn't go back that far.
+ * @return LE_BAD_PARAMETER NULL position data pointer.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_gnssSimu_GetFixHistory
+(
+    uint32_t            age,            ///< [IN] Age of the fix: 0 for the last one
+    pa_Gnss_Position_t* posDataPtr      ///< [OUT] Position data
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the fix stream statistics.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_GetFixStreamStats
+(
+    pa_gnssSimu_FixStreamStats_t* statsPtr  ///< [OUT] Statistics
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the fix stream statistics.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_ResetFixStreamStats
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the fix stream benchmark: the receiver drives around a square at the given rate, the fixes
+ * being delivered to subscriberCount position handlers. The statistics are reset, and then
+ * collected until pa_gnssSimu_StopFixStreamBenchmark() is called.
+ *
+ * @return LE_BUSY          The benchmark is already running.
+ * @return LE_OUT_OF_RANGE  Invalid rate or number of subscribers.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_gnssSimu_StartFixStreamBenchmark
+(
+    uint32_t rate,              ///< [IN] Acquisition rate in milliseconds
+    uint32_t subscriberCount    ///< [IN] Number of subscribers (up to 64)
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop the fix stream benchmark, restoring the trajectory and the rate set before it. The
+ * acquisition is stopped.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_gnssSimu_StopFixStreamBenchmark
+(
+    void
+);
+
 #endif
@@ -0,0 +1,1040 @@
+/**
+ * @file pa_nmea_simu.c
+ *
+ * NMEA 0183 sentences synthesized from the position data of the simulated GNSS receiver.
+ *
+ * Sentences are written straight into the caller's buffer with table driven integer to ASCII
+ * conversions: no printf, no floating point and no intermediate copy.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include <pa_gnss.h>
+#include "pa_nmea_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of satellites listed in a GSA sentence.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GSA_SAT_COUNT               12
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of satellites listed in a GSV sentence.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GSV_SAT_COUNT               4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scale of the DOPs in the position data.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DOP_SCALE                   1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest DOP written, keeping the sentences within their maximum length.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DOP_MAX                     (99 * DOP_SCALE)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest speed written in 1/10 of knot or km/h.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SPEED_MAX                   99999
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest altitude written in meters with 1 decimal.
+ */
+//--------------------------------------------------------------------------------------------------
+#define ALTITUDE_MAX                999999
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Conversion from centimeters/second to 1/10 of knot, scaled by 1e6.
+ */
+//--------------------------------------------------------------------------------------------------
+#define KNOT_FACTOR                 194384
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Satellites of a talker.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GP_CONSTELLATIONS   ((1 << LE_GNSS_SV_CONSTELLATION_GPS) |  \
+                             (1 << LE_GNSS_SV_CONSTELLATION_SBAS) | \
+                             (1 << LE_GNSS_SV_CONSTELLATION_QZSS))
+#define GL_CONSTELLATIONS   (1 << LE_GNSS_SV_CONSTELLATION_GLONASS)
+#define GA_CONSTELLATIONS   (1 << LE_GNSS_SV_CONSTELLATION_GALILEO)
+#define GN_CONSTELLATIONS   ((1 << LE_GNSS_SV_CONSTELLATION_MAX) - 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sentence writer: the output buffer and the start of the sentence being written.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char*   ptr;            ///< Next character
+    char*   endPtr;         ///< End of the buffer, keeping room for the null terminator
+    char*   sentencePtr;    ///< Start of the current sentence
+    uint32_t sentenceCount; ///< Number of sentences written
+}
+Writer_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sentence formatter.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*FormatFunc_t)
+(
+    Writer_t*                 writerPtr,
+    const pa_Gnss_Position_t* posDataPtr,
+    const char*               talkerPtr,
+    uint32_t                  constellations
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generated sentence, in the order of the output.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gnss_NmeaBitMask_t mask;         ///< Bit enabling the sentence
+    const char*           talkerPtr;    ///< Talker identifier
+    uint32_t              constellations; ///< Bit mask of the satellite constellations listed
+    FormatFunc_t          format;       ///< Formatter
+}
+Sentence_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Two digits of all the numbers from 0 to 99.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char DigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hexadecimal digits of the checksum.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char HexDigits[] = "0123456789ABCDEF";
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Powers of ten of the decimals.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t Powers10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * NMEA 4.10 system identifiers, indexed by constellation.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint8_t SystemIds[LE_GNSS_SV_CONSTELLATION_MAX] =
+{
+    [LE_GNSS_SV_CONSTELLATION_GPS]     = 1,
+    [LE_GNSS_SV_CONSTELLATION_SBAS]    = 1,
+    [LE_GNSS_SV_CONSTELLATION_GLONASS] = 2,
+    [LE_GNSS_SV_CONSTELLATION_GALILEO] = 3,
+    [LE_GNSS_SV_CONSTELLATION_BEIDOU]  = 4,
+    [LE_GNSS_SV_CONSTELLATION_QZSS]    = 5,
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a character.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void AppendChar
+(
+    Writer_t* writerPtr,    ///< [IN/OUT] Writer
+    char      c             ///< [IN] Character
+)
+{
+    *writerPtr->ptr++ = c;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a string.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void AppendString
+(
+    Writer_t*   writerPtr,  ///< [IN/OUT] Writer
+    const char* strPtr      ///< [IN] String
+)
+{
+    while (*strPtr)
+    {
+        *writerPtr->ptr++ = *strPtr++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append an unsigned integer, two digits at a time, left padded with zeros to a minimum number of
+ * digits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendUint
+(
+    Writer_t* writerPtr,    ///< [IN/OUT] Writer
+    uint32_t  value,        ///< [IN] Value
+    uint32_t  minDigits     ///< [IN] Minimum number of digits
+)
+{
+    char digits[10];
+    char* digitPtr = digits + sizeof(digits);
+
+    while (value >= 100)
+    {
+        uint32_t pair = value % 100;
+        value /= 100;
+        digitPtr -= 2;
+        digitPtr[0] = DigitPairs[2 * pair];
+        digitPtr[1] = DigitPairs[2 * pair + 1];
+    }
+    if (value >= 10)
+    {
+        digitPtr -= 2;
+        digitPtr[0] = DigitPairs[2 * value];
+        digitPtr[1] = DigitPairs[2 * value + 1];
+    }
+    else
+    {
+        *--digitPtr = (char)('0' + value);
+    }
+
+    while ((uint32_t)(digits + sizeof(digits) - digitPtr) < minDigits)
+    {
+        *--digitPtr = '0';
+    }
+
+    size_t len = digits + sizeof(digits) - digitPtr;
+    memcpy(writerPtr->ptr, digitPtr, len);
+    writerPtr->ptr += len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a scaled value as a decimal number, rounded to the given number of decimals and clamped
+ * to a maximum magnitude.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendDecimal
+(
+    Writer_t* writerPtr,    ///< [IN/OUT] Writer
+    int64_t   value,        ///< [IN] Scaled value
+    uint32_t  scale,        ///< [IN] Scale of the value
+    uint32_t  decimals,     ///< [IN] Number of decimals written
+    uint32_t  max           ///< [IN] Maximum magnitude, in units of the last decimal
+)
+{
+    uint64_t magnitude = (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+    uint64_t rounded = (magnitude * Powers10[decimals] + scale / 2) / scale;
+
+    if (rounded > max)
+    {
+        rounded = max;
+    }
+    if ((value < 0) && (rounded != 0))
+    {
+        AppendChar(writerPtr, '-');
+    }
+
+    AppendUint(writerPtr, (uint32_t)(rounded / Powers10[decimals]), 1);
+    if (decimals)
+    {
+        AppendChar(writerPtr, '.');
+        AppendUint(writerPtr, (uint32_t)(rounded % Powers10[decimals]), decimals);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a sentence, if the buffer has room for the longest one.
+ *
+ * @return false if the buffer is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool BeginSentence
+(
+    Writer_t*   writerPtr,  ///< [IN/OUT] Writer
+    const char* talkerPtr,  ///< [IN] Talker identifier
+    const char* typePtr     ///< [IN] Sentence type
+)
+{
+    if ((writerPtr->endPtr - writerPtr->ptr) < PA_NMEASIMU_SENTENCE_MAX_LEN)
+    {
+        return false;
+    }
+
+    writerPtr->sentencePtr = writerPtr->ptr;
+    AppendChar(writerPtr, '$');
+    AppendString(writerPtr, talkerPtr);
+    AppendString(writerPtr, typePtr);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * End a sentence with its checksum, the XOR of all the characters between '$' and '*'.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndSentence
+(
+    Writer_t* writerPtr     ///< [IN/OUT] Writer
+)
+{
+    uint8_t checksum = 0;
+    const char* charPtr;
+
+    for (charPtr = writerPtr->sentencePtr + 1; charPtr < writerPtr->ptr; charPtr++)
+    {
+        checksum ^= (uint8_t)*charPtr;
+    }
+
+    AppendChar(writerPtr, '*');
+    AppendChar(writerPtr, HexDigits[checksum >> 4]);
+    AppendChar(writerPtr, HexDigits[checksum & 0x0F]);
+    AppendChar(writerPtr, '\r');
+    AppendChar(writerPtr, '\n');
+
+    LE_ASSERT((writerPtr->ptr - writerPtr->sentencePtr) <= PA_NMEASIMU_SENTENCE_MAX_LEN);
+    writerPtr->sentenceCount++;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the UTC time field: hhmmss.ss
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendTime
+(
+    Writer_t*                 writerPtr,    ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr    ///< [IN] Position data
+)
+{
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->timeValid)
+    {
+        AppendUint(writerPtr, posDataPtr->time.hours, 2);
+        AppendUint(writerPtr, posDataPtr->time.minutes, 2);
+        AppendUint(writerPtr, posDataPtr->time.seconds, 2);
+        AppendChar(writerPtr, '.');
+        AppendUint(writerPtr, posDataPtr->time.milliseconds / 10, 2);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a coordinate field and its hemisphere field: (d)ddmm.mmmm,H
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendCoordinate
+(
+    Writer_t* writerPtr,    ///< [IN/OUT] Writer
+    bool      valid,        ///< [IN] Coordinate validity
+    int32_t   value,        ///< [IN] Coordinate in degrees, 6 decimal places
+    uint32_t  degreeDigits, ///< [IN] Number of digits of the degrees
+    char      positive,     ///< [IN] Hemisphere of the positive coordinates
+    char      negative      ///< [IN] Hemisphere of the negative coordinates
+)
+{
+    AppendChar(writerPtr, ',');
+    if (!valid)
+    {
+        AppendChar(writerPtr, ',');
+        return;
+    }
+
+    uint32_t magnitude = (value < 0) ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+    uint32_t degrees = magnitude / 1000000;
+    // Minutes with 4 decimals.
+    uint32_t minutes = ((magnitude % 1000000) * 60 + 50) / 100;
+    if (minutes >= 600000)
+    {
+        degrees++;
+        minutes -= 600000;
+    }
+
+    AppendUint(writerPtr, degrees, degreeDigits);
+    AppendUint(writerPtr, minutes / 10000, 2);
+    AppendChar(writerPtr, '.');
+    AppendUint(writerPtr, minutes % 10000, 4);
+    AppendChar(writerPtr, ',');
+    AppendChar(writerPtr, (value < 0) ? negative : positive);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a DOP field.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendDop
+(
+    Writer_t* writerPtr,    ///< [IN/OUT] Writer
+    bool      valid,        ///< [IN] DOP validity
+    uint16_t  dop           ///< [IN] DOP, 3 decimal places
+)
+{
+    AppendChar(writerPtr, ',');
+    if (valid)
+    {
+        AppendDecimal(writerPtr, dop, DOP_SCALE, 1, DOP_MAX / (DOP_SCALE / 10));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the position fields shared by GGA and GNS: time, latitude and longitude.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendPosition
+(
+    Writer_t*                 writerPtr,    ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr    ///< [IN] Position data
+)
+{
+    AppendTime(writerPtr, posDataPtr);
+    AppendCoordinate(writerPtr, posDataPtr->latitudeValid, posDataPtr->latitude, 2, 'N', 'S');
+    AppendCoordinate(writerPtr, posDataPtr->longitudeValid, posDataPtr->longitude, 3, 'E', 'W');
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the fields shared by GGA and GNS after the mode: satellites used, HDOP, altitude and
+ * geoid separation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendSolution
+(
+    Writer_t*                 writerPtr,    ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,   ///< [IN] Position data
+    bool                      withUnits     ///< [IN] Write the 'M' unit fields (GGA)
+)
+{
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->satsUsedCountValid)
+    {
+        AppendUint(writerPtr, posDataPtr->satsUsedCount, 2);
+    }
+    AppendDop(writerPtr, posDataPtr->hdopValid, posDataPtr->hdop);
+
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->altitudeValid)
+    {
+        AppendDecimal(writerPtr, posDataPtr->altitude, 1000, 1, ALTITUDE_MAX);
+    }
+    if (withUnits)
+    {
+        AppendString(writerPtr, ",M");
+    }
+
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->altitudeValid && posDataPtr->altitudeOnWgs84Valid)
+    {
+        AppendDecimal(writerPtr, (int64_t)posDataPtr->altitudeOnWgs84 - posDataPtr->altitude,
+                      1000, 1, ALTITUDE_MAX);
+    }
+    if (withUnits)
+    {
+        AppendString(writerPtr, ",M");
+    }
+
+    // No differential data.
+    AppendString(writerPtr, ",,");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a fix has a position.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool HasFix
+(
+    const pa_Gnss_Position_t* posDataPtr    ///< [IN] Position data
+)
+{
+    return (LE_GNSS_STATE_FIX_2D == posDataPtr->fixState) ||
+           (LE_GNSS_STATE_FIX_3D == posDataPtr->fixState) ||
+           (LE_GNSS_STATE_FIX_ESTIMATED == posDataPtr->fixState);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the mode indicator of the RMC, VTG and GNS sentences.
+ */
+//--------------------------------------------------------------------------------------------------
+static char GetModeIndicator
+(
+    const pa_Gnss_Position_t* posDataPtr    ///< [IN] Position data
+)
+{
+    switch (posDataPtr->fixState)
+    {
+        case LE_GNSS_STATE_FIX_2D:
+        case LE_GNSS_STATE_FIX_3D:
+            return 'A';
+        case LE_GNSS_STATE_FIX_ESTIMATED:
+            return 'E';
+        default:
+            return 'N';
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the NMEA identifier of a satellite, within the range of its talker.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t GetNmeaSatId
+(
+    const pa_Gnss_SvInfo_t* satPtr  ///< [IN] Satellite
+)
+{
+    switch (satPtr->satConst)
+    {
+        case LE_GNSS_SV_CONSTELLATION_SBAS:
+            // PRN 120..158 reported as 33..71
+            return (satPtr->satId >= 120) ? satPtr->satId - 87 : satPtr->satId;
+        case LE_GNSS_SV_CONSTELLATION_BEIDOU:
+            return (satPtr->satId > 200) ? satPtr->satId - 200 : satPtr->satId;
+        case LE_GNSS_SV_CONSTELLATION_GALILEO:
+            return (satPtr->satId > 300) ? satPtr->satId - 300 : satPtr->satId;
+        default:
+            return satPtr->satId;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a satellite belongs to a set of constellations.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsSatSelected
+(
+    const pa_Gnss_SvInfo_t* satPtr,         ///< [IN] Satellite
+    uint32_t                constellations  ///< [IN] Bit mask of the constellations
+)
+{
+    return (0 != satPtr->satId) &&
+           (satPtr->satConst < LE_GNSS_SV_CONSTELLATION_MAX) &&
+           (constellations & (1 << satPtr->satConst));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a GGA sentence: fix data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatGga
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations    ///< [IN] Bit mask of the constellations
+)
+{
+    if (!BeginSentence(writerPtr, talkerPtr, "GGA"))
+    {
+        return;
+    }
+
+    AppendPosition(writerPtr, posDataPtr);
+    AppendChar(writerPtr, ',');
+    AppendChar(writerPtr, (LE_GNSS_STATE_FIX_ESTIMATED == posDataPtr->fixState) ? '6' :
+                          (HasFix(posDataPtr) ? '1' : '0'));
+    AppendSolution(writerPtr, posDataPtr, true);
+    EndSentence(writerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a GNS sentence: fix data with a mode indicator per constellation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatGns
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations    ///< [IN] Bit mask of the constellations
+)
+{
+    // Mode indicators order: GPS, GLONASS, Galileo, BeiDou, QZSS.
+    static const uint32_t modeConstellations[] =
+    {
+        (1 << LE_GNSS_SV_CONSTELLATION_GPS) | (1 << LE_GNSS_SV_CONSTELLATION_SBAS),
+        GL_CONSTELLATIONS,
+        GA_CONSTELLATIONS,
+        (1 << LE_GNSS_SV_CONSTELLATION_BEIDOU),
+        (1 << LE_GNSS_SV_CONSTELLATION_QZSS),
+    };
+    uint32_t usedConstellations = 0;
+    size_t i;
+
+    if (!BeginSentence(writerPtr, talkerPtr, "GNS"))
+    {
+        return;
+    }
+
+    if (posDataPtr->satInfoValid && HasFix(posDataPtr))
+    {
+        for (i = 0; i < LE_GNSS_SV_INFO_MAX_LEN; i++)
+        {
+            const pa_Gnss_SvInfo_t* satPtr = &posDataPtr->satInfo[i];
+            if (satPtr->satUsed && IsSatSelected(satPtr, constellations))
+            {
+                usedConstellations |= 1 << satPtr->satConst;
+            }
+        }
+    }
+
+    AppendPosition(writerPtr, posDataPtr);
+    AppendChar(writerPtr, ',');
+    for (i = 0; i < NUM_ARRAY_MEMBERS(modeConstellations); i++)
+    {
+        if (modeConstellations[i] & constellations)
+        {
+            AppendChar(writerPtr, (usedConstellations & modeConstellations[i]) ?
+                                  GetModeIndicator(posDataPtr) : 'N');
+        }
+    }
+    AppendSolution(writerPtr, posDataPtr, false);
+    EndSentence(writerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a GSA sentence listing the used satellites of some constellations.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatGsaSystem
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations,   ///< [IN] Bit mask of the constellations
+    uint8_t                   systemId          ///< [IN] NMEA 4.10 system identifier, 0 if none
+)
+{
+    int satCount = 0;
+    int i;
+
+    if (!BeginSentence(writerPtr, talkerPtr, "GSA"))
+    {
+        return;
+    }
+
+    AppendString(writerPtr, ",A,");
+    AppendChar(writerPtr, (LE_GNSS_STATE_FIX_3D == posDataPtr->fixState) ? '3' :
+                          (HasFix(posDataPtr) ? '2' : '1'));
+
+    for (i = 0; (i < LE_GNSS_SV_INFO_MAX_LEN) && posDataPtr->satInfoValid; i++)
+    {
+        const pa_Gnss_SvInfo_t* satPtr = &posDataPtr->satInfo[i];
+        if (satPtr->satUsed && IsSatSelected(satPtr, constellations) && (satCount < GSA_SAT_COUNT))
+        {
+            AppendChar(writerPtr, ',');
+            AppendUint(writerPtr, GetNmeaSatId(satPtr), 2);
+            satCount++;
+        }
+    }
+    for (; satCount < GSA_SAT_COUNT; satCount++)
+    {
+        AppendChar(writerPtr, ',');
+    }
+
+    AppendDop(writerPtr, posDataPtr->pdopValid, posDataPtr->pdop);
+    AppendDop(writerPtr, posDataPtr->hdopValid, posDataPtr->hdop);
+    AppendDop(writerPtr, posDataPtr->vdopValid, posDataPtr->vdop);
+    if (systemId)
+    {
+        AppendChar(writerPtr, ',');
+        AppendUint(writerPtr, systemId, 1);
+    }
+    EndSentence(writerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format the GSA sentences: DOPs and used satellites. The multi constellation talker writes a
+ * sentence per constellation in use, tagged with its system identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatGsa
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations    ///< [IN] Bit mask of the constellations
+)
+{
+    uint32_t systems = 0;
+    uint8_t systemId;
+    int i;
+
+    if (GN_CONSTELLATIONS != constellations)
+    {
+        FormatGsaSystem(writerPtr, posDataPtr, talkerPtr, constellations, 0);
+        return;
+    }
+
+    for (i = 0; (i < LE_GNSS_SV_INFO_MAX_LEN) && posDataPtr->satInfoValid; i++)
+    {
+        const pa_Gnss_SvInfo_t* satPtr = &posDataPtr->satInfo[i];
+        if (satPtr->satUsed && IsSatSelected(satPtr, constellations))
+        {
+            systems |= 1 << SystemIds[satPtr->satConst];
+        }
+    }
+    if (0 == systems)
+    {
+        systems = 1 << SystemIds[LE_GNSS_SV_CONSTELLATION_GPS];
+    }
+
+    for (systemId = 1; systemId < 8; systemId++)
+    {
+        if (systems & (1 << systemId))
+        {
+            uint32_t systemConstellations = 0;
+            int c;
+            for (c = 0; c < LE_GNSS_SV_CONSTELLATION_MAX; c++)
+            {
+                if (SystemIds[c] == systemId)
+                {
+                    systemConstellations |= 1 << c;
+                }
+            }
+            FormatGsaSystem(writerPtr, posDataPtr, talkerPtr, systemConstellations, systemId);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format the GSV sentences: satellites in view, four per sentence.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatGsv
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations    ///< [IN] Bit mask of the constellations
+)
+{
+    const pa_Gnss_SvInfo_t* satPtrs[LE_GNSS_SV_INFO_MAX_LEN];
+    int satCount = 0;
+    int sentenceCount;
+    int sentence;
+    int i;
+
+    for (i = 0; (i < LE_GNSS_SV_INFO_MAX_LEN) && posDataPtr->satInfoValid; i++)
+    {
+        if (IsSatSelected(&posDataPtr->satInfo[i], constellations))
+        {
+            satPtrs[satCount++] = &posDataPtr->satInfo[i];
+        }
+    }
+
+    // An empty sky still has its sentence.
+    sentenceCount = (satCount + GSV_SAT_COUNT - 1) / GSV_SAT_COUNT;
+    if (0 == sentenceCount)
+    {
+        sentenceCount = 1;
+    }
+    if (sentenceCount > 9)
+    {
+        sentenceCount = 9;
+        satCount = 9 * GSV_SAT_COUNT;
+    }
+
+    for (sentence = 0; sentence < sentenceCount; sentence++)
+    {
+        if (!BeginSentence(writerPtr, talkerPtr, "GSV"))
+        {
+            return;
+        }
+
+        AppendChar(writerPtr, ',');
+        AppendUint(writerPtr, sentenceCount, 1);
+        AppendChar(writerPtr, ',');
+        AppendUint(writerPtr, sentence + 1, 1);
+        AppendChar(writerPtr, ',');
+        AppendUint(writerPtr, satCount, 2);
+
+        for (i = sentence * GSV_SAT_COUNT;
+             (i < satCount) && (i < (sentence + 1) * GSV_SAT_COUNT);
+             i++)
+        {
+            const pa_Gnss_SvInfo_t* satPtr = satPtrs[i];
+            AppendChar(writerPtr, ',');
+            AppendUint(writerPtr, GetNmeaSatId(satPtr), 2);
+            AppendChar(writerPtr, ',');
+            AppendUint(writerPtr, (satPtr->satElev > 90) ? 90 : satPtr->satElev, 2);
+            AppendChar(writerPtr, ',');
+            AppendUint(writerPtr, satPtr->satAzim % 360, 3);
+            AppendChar(writerPtr, ',');
+            if (satPtr->satTracked)
+            {
+                AppendUint(writerPtr, (satPtr->satSnr > 99) ? 99 : satPtr->satSnr, 2);
+            }
+        }
+        EndSentence(writerPtr);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the course over ground field, in degrees with 1 decimal.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendCourse
+(
+    Writer_t*                 writerPtr,    ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr    ///< [IN] Position data
+)
+{
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->directionValid)
+    {
+        AppendDecimal(writerPtr, posDataPtr->direction % 3600, 10, 1, 3599);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the speed over ground in knots with 1 decimal.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AppendKnots
+(
+    Writer_t*                 writerPtr,    ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr    ///< [IN] Position data
+)
+{
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->hSpeedValid)
+    {
+        AppendDecimal(writerPtr, (int64_t)posDataPtr->hSpeed * KNOT_FACTOR, 10000000, 1,
+                      SPEED_MAX);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a RMC sentence: recommended minimum data.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatRmc
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations    ///< [IN] Bit mask of the constellations
+)
+{
+    if (!BeginSentence(writerPtr, talkerPtr, "RMC"))
+    {
+        return;
+    }
+
+    AppendTime(writerPtr, posDataPtr);
+    AppendChar(writerPtr, ',');
+    AppendChar(writerPtr, HasFix(posDataPtr) ? 'A' : 'V');
+    AppendCoordinate(writerPtr, posDataPtr->latitudeValid, posDataPtr->latitude, 2, 'N', 'S');
+    AppendCoordinate(writerPtr, posDataPtr->longitudeValid, posDataPtr->longitude, 3, 'E', 'W');
+    AppendKnots(writerPtr, posDataPtr);
+    AppendCourse(writerPtr, posDataPtr);
+
+    AppendChar(writerPtr, ',');
+    if (posDataPtr->dateValid)
+    {
+        AppendUint(writerPtr, posDataPtr->date.day, 2);
+        AppendUint(writerPtr, posDataPtr->date.month, 2);
+        AppendUint(writerPtr, posDataPtr->date.year % 100, 2);
+    }
+
+    // No magnetic variation.
+    AppendString(writerPtr, ",,,");
+    AppendChar(writerPtr, GetModeIndicator(posDataPtr));
+    EndSentence(writerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format a VTG sentence: course and speed over ground.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatVtg
+(
+    Writer_t*                 writerPtr,        ///< [IN/OUT] Writer
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data
+    const char*               talkerPtr,        ///< [IN] Talker identifier
+    uint32_t                  constellations    ///< [IN] Bit mask of the constellations
+)
+{
+    if (!BeginSentence(writerPtr, talkerPtr, "VTG"))
+    {
+        return;
+    }
+
+    AppendCourse(writerPtr, posDataPtr);
+    AppendString(writerPtr, ",T,,M");
+    AppendKnots(writerPtr, posDataPtr);
+    AppendString(writerPtr, ",N,");
+    if (posDataPtr->hSpeedValid)
+    {
+        // cm/s to km/h: x 0.036
+        AppendDecimal(writerPtr, (int64_t)posDataPtr->hSpeed * 36, 1000, 1, SPEED_MAX);
+    }
+    AppendString(writerPtr, ",K,");
+    AppendChar(writerPtr, GetModeIndicator(posDataPtr));
+    EndSentence(writerPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sentences generated, in the order of an epoch of a receiver.
+ */
+//--------------------------------------------------------------------------------------------------
+static const Sentence_t Sentences[] =
+{
+    { LE_GNSS_NMEA_MASK_GPGGA, "GP", GP_CONSTELLATIONS, FormatGga },
+    { LE_GNSS_NMEA_MASK_GAGGA, "GA", GA_CONSTELLATIONS, FormatGga },
+    { LE_GNSS_NMEA_MASK_GNGNS, "GN", GN_CONSTELLATIONS, FormatGns },
+    { LE_GNSS_NMEA_MASK_GAGNS, "GA", GA_CONSTELLATIONS, FormatGns },
+    { LE_GNSS_NMEA_MASK_GPGSA, "GP", GP_CONSTELLATIONS, FormatGsa },
+    { LE_GNSS_NMEA_MASK_GAGSA, "GA", GA_CONSTELLATIONS, FormatGsa },
+    { LE_GNSS_NMEA_MASK_GNGSA, "GN", GN_CONSTELLATIONS, FormatGsa },
+    { LE_GNSS_NMEA_MASK_GPGSV, "GP", GP_CONSTELLATIONS, FormatGsv },
+    { LE_GNSS_NMEA_MASK_GLGSV, "GL", GL_CONSTELLATIONS, FormatGsv },
+    { LE_GNSS_NMEA_MASK_GAGSV, "GA", GA_CONSTELLATIONS, FormatGsv },
+    { LE_GNSS_NMEA_MASK_GPRMC, "GP", GP_CONSTELLATIONS, FormatRmc },
+    { LE_GNSS_NMEA_MASK_GARMC, "GA", GA_CONSTELLATIONS, FormatRmc },
+    { LE_GNSS_NMEA_MASK_GPVTG, "GP", GP_CONSTELLATIONS, FormatVtg },
+    { LE_GNSS_NMEA_MASK_GAVTG, "GA", GA_CONSTELLATIONS, FormatVtg },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format the enabled sentences of a fix.
+ *
+ * @return The number of sentences written.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FormatSentences
+(
+    const pa_Gnss_Position_t* posDataPtr,   ///< [IN] Position data of the fix
+    le_gnss_NmeaBitMask_t     nmeaMask,     ///< [IN] Enabled NMEA sentences
+    char*                     bufferPtr,    ///< [OUT] Sentences buffer
+    size_t                    bufferSize,   ///< [IN] Buffer size
+    size_t*                   lenPtr        ///< [OUT] Length of the sentences
+)
+{
+    Writer_t writer;
+    size_t i;
+
+    writer.ptr = bufferPtr;
+    writer.endPtr = bufferPtr + bufferSize - 1;
+    writer.sentencePtr = bufferPtr;
+    writer.sentenceCount = 0;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Sentences); i++)
+    {
+        if (nmeaMask & Sentences[i].mask)
+        {
+            Sentences[i].format(&writer, posDataPtr, Sentences[i].talkerPtr,
+                                Sentences[i].constellations);
+        }
+    }
+
+    *writer.ptr = '\0';
+    *lenPtr = writer.ptr - bufferPtr;
+    return writer.sentenceCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format the enabled NMEA sentences of a fix, back to back, each one ending with "\r\n".
+ *
+ * @return The length of the sentences, without the null terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t pa_nmeaSimu_Format
+(
+    const pa_Gnss_Position_t* posDataPtr,   ///< [IN] Position data of the fix
+    le_gnss_NmeaBitMask_t     nmeaMask,     ///< [IN] Enabled NMEA sentences
+    char*                     bufferPtr,    ///< [OUT] Sentences buffer
+    size_t                    bufferSize    ///< [IN] Buffer size
+)
+{
+    size_t len = 0;
+
+    LE_ASSERT(posDataPtr && bufferPtr && bufferSize);
+    FormatSentences(posDataPtr, nmeaMask, bufferPtr, bufferSize, &len);
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of the sentence synthesizer, for a fix with all its satellites.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_nmeaSimu_RunBenchmark
+(
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data of the fix
+    le_gnss_NmeaBitMask_t     nmeaMask,         ///< [IN] Enabled NMEA sentences
+    uint32_t                  fixCount,         ///< [IN] Number of fixes to format
+    uint32_t*                 sentencesPerSecPtr, ///< [OUT] Sentences formatted per second
+    uint32_t*                 bytesPerSecPtr      ///< [OUT] Bytes formatted per second
+)
+{
+    // Room for all the sentences of a fix: 9 GSV sentences per talker at most.
+    static char buffer[(NUM_ARRAY_MEMBERS(Sentences) + 3 * 8 + 8) * PA_NMEASIMU_SENTENCE_MAX_LEN];
+    uint64_t sentenceCount = 0;
+    uint64_t byteCount = 0;
+    struct timespec start, end;
+    uint32_t i;
+
+    LE_ASSERT(posDataPtr && sentencesPerSecPtr && bytesPerSecPtr);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < fixCount; i++)
+    {
+        size_t len;
+        sentenceCount += FormatSentences(posDataPtr, nmeaMask, buffer, sizeof(buffer), &len);
+        byteCount += len;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t elapsed = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL
+                       + end.tv_nsec - start.tv_nsec;
+    if (0 == elapsed)
+    {
+        elapsed = 1;
+    }
+
+    *sentencesPerSecPtr = (uint32_t)(sentenceCount * 1000000000ULL / elapsed);
+    *bytesPerSecPtr = (uint32_t)(byteCount * 1000000000ULL / elapsed);
+
+    LE_INFO("%"PRIu32" fixes: %"PRIu64" sentences, %"PRIu64" bytes in %"PRIu64" ns",
+            fixCount, sentenceCount, byteCount, elapsed);
+}
@@ -0,0 +1,54 @@
+/** @file pa_nmea_simu.h
+ *
+ * Legato @ref pa_nmea_simu include file.
+ *
+ * NMEA 0183 sentences of the simulated GNSS receiver, synthesized from its position data.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_NMEA_SIMU_H_INCLUDE_GUARD
+#define PA_NMEA_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a sentence, from the '$' to the "\r\n" included.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_NMEASIMU_SENTENCE_MAX_LEN    82
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format the enabled NMEA sentences of a fix, back to back, each one ending with "\r\n". The
+ * sentences not generated by the simulation (proprietary, GRS, GLL, DTM, debug) are ignored.
+ *
+ * The buffer is null terminated, and only holds complete sentences: the sentences not fitting in
+ * it are dropped.
+ *
+ * @return The length of the sentences, without the null terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t pa_nmeaSimu_Format
+(
+    const pa_Gnss_Position_t* posDataPtr,   ///< [IN] Position data of the fix
+    le_gnss_NmeaBitMask_t     nmeaMask,     ///< [IN] Enabled NMEA sentences
+    char*                     bufferPtr,    ///< [OUT] Sentences buffer
+    size_t                    bufferSize    ///< [IN] Buffer size
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the throughput of the sentence synthesizer, for a fix with all its satellites.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_nmeaSimu_RunBenchmark
+(
+    const pa_Gnss_Position_t* posDataPtr,       ///< [IN] Position data of the fix
+    le_gnss_NmeaBitMask_t     nmeaMask,         ///< [IN] Enabled NMEA sentences
+    uint32_t                  fixCount,         ///< [IN] Number of fixes to format
+    uint32_t*                 sentencesPerSecPtr, ///< [OUT] Sentences formatted per second
+    uint32_t*                 bytesPerSecPtr      ///< [OUT] Bytes formatted per second
+);
+
+#endif
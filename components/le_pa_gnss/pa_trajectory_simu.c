@@ -0,0 +1,878 @@
+/**
+ * @file pa_trajectory_simu.c
+ *
+ * Trajectories followed by the simulated GNSS receiver.
+ *
+ * A track is a list of timed waypoints. It is sampled by interpolating the position between the
+ * two waypoints around the requested time, on a local flat earth: the legs of the tracks are short
+ * compared to the earth radius. A cursor keeps the current leg, so that sampling a track at
+ * increasing times (the fixes of a receiver) doesn't walk the list from its head.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "pa_trajectory_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mean earth radius in meters.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EARTH_RADIUS            6371000.0
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Degrees to radians conversion factor.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEG_TO_RAD              (M_PI / 180.0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of tracks and waypoints preallocated in the pools.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TRACK_POOL_SIZE         1
+#define WAYPOINT_POOL_SIZE      256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Waypoint of a track.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;         ///< Link in the waypoint list of the track
+    uint64_t      time;         ///< Time from the track start in milliseconds
+    double        latitude;     ///< Latitude in degrees
+    double        longitude;    ///< Longitude in degrees
+    double        altitude;     ///< Altitude in meters
+}
+Waypoint_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Track.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_trajectorySimu_Track
+{
+    le_dls_List_t waypointList; ///< Waypoints, by increasing time
+    Waypoint_t*   cursorPtr;    ///< Waypoint starting the last sampled leg
+    uint64_t      startTime;    ///< UTC time of the track start in milliseconds, 0 if not dated
+    bool          loop;         ///< Loop the playback
+}
+Track_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Point read from a file.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    double   latitude;          ///< Latitude in degrees
+    double   longitude;         ///< Longitude in degrees
+    double   altitude;          ///< Altitude in meters
+    bool     timeValid;         ///< The point has a time
+    bool     isDate;            ///< The time is a UTC date, not a time from the track start
+    uint64_t time;              ///< Time in milliseconds
+}
+Point_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the tracks.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TrackPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the waypoints.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t WaypointPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the waypoint following another one on its track.
+ *
+ * @return The next waypoint, NULL if the waypoint is the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+static Waypoint_t* GetNextWaypoint
+(
+    Track_t*    trackPtr,       ///< [IN] Track
+    Waypoint_t* waypointPtr     ///< [IN] Waypoint
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_PeekNext(&trackPtr->waypointList, &waypointPtr->link);
+
+    return (linkPtr ? CONTAINER_OF(linkPtr, Waypoint_t, link) : NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the longitude difference between two points, through the antimeridian if shorter.
+ *
+ * @return The difference in degrees, in [-180..180].
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetLongitudeDelta
+(
+    double fromLongitude,       ///< [IN] Longitude of the start point
+    double toLongitude          ///< [IN] Longitude of the end point
+)
+{
+    double delta = toLongitude - fromLongitude;
+
+    if (delta > 180.0)
+    {
+        delta -= 360.0;
+    }
+    else if (delta < -180.0)
+    {
+        delta += 360.0;
+    }
+    return delta;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bring a longitude back to [-180..180].
+ *
+ * @return The longitude in degrees.
+ */
+//--------------------------------------------------------------------------------------------------
+static double NormalizeLongitude
+(
+    double longitude            ///< [IN] Longitude in degrees
+)
+{
+    return GetLongitudeDelta(0.0, longitude);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the north and east components of a leg, in meters.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetLegVector
+(
+    const Waypoint_t* fromPtr,  ///< [IN] Leg start
+    const Waypoint_t* toPtr,    ///< [IN] Leg end
+    double*           northPtr, ///< [OUT] North component
+    double*           eastPtr   ///< [OUT] East component
+)
+{
+    double meanLatitude = (fromPtr->latitude + toPtr->latitude) / 2;
+
+    *northPtr = (toPtr->latitude - fromPtr->latitude) * DEG_TO_RAD * EARTH_RADIUS;
+    *eastPtr = GetLongitudeDelta(fromPtr->longitude, toPtr->longitude) * DEG_TO_RAD
+               * EARTH_RADIUS * cos(meanLatitude * DEG_TO_RAD);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the direction of a vector.
+ *
+ * @return The direction in degrees from the North, in [0..360[.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetDirection
+(
+    double north,               ///< [IN] North component
+    double east                 ///< [IN] East component
+)
+{
+    double direction = atan2(east, north) / DEG_TO_RAD;
+
+    return (direction < 0 ? direction + 360.0 : direction);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse an ISO 8601 UTC date, like 2017-10-04T23:59:50.100Z.
+ *
+ * @return true if the date is valid.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ParseDate
+(
+    const char* textPtr,        ///< [IN] Date
+    uint64_t*   timePtr         ///< [OUT] UTC time in milliseconds since Jan. 1, 1970
+)
+{
+    struct tm date = {0};
+    double    seconds;
+    time_t    utcTime;
+
+    if (6 != sscanf(textPtr, " %d-%d-%dT%d:%d:%lf", &date.tm_year, &date.tm_mon, &date.tm_mday,
+                    &date.tm_hour, &date.tm_min, &seconds))
+    {
+        return false;
+    }
+    if ((date.tm_year < 1970) || (seconds < 0) || (seconds >= 61))
+    {
+        return false;
+    }
+
+    date.tm_year -= 1900;
+    date.tm_mon -= 1;
+    date.tm_sec = (int)seconds;
+    utcTime = timegm(&date);
+    if (-1 == utcTime)
+    {
+        return false;
+    }
+
+    *timePtr = (uint64_t)utcTime * 1000 + (uint64_t)llround((seconds - date.tm_sec) * 1000);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a point read from a file to a track, timing it if needed.
+ *
+ * @return LE_OK if the point was appended.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddPoint
+(
+    Track_t*       trackPtr,    ///< [IN] Track
+    const Point_t* pointPtr     ///< [IN] Point
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_PeekTail(&trackPtr->waypointList);
+    Waypoint_t*    lastPtr = (linkPtr ? CONTAINER_OF(linkPtr, Waypoint_t, link) : NULL);
+    bool           timed = pointPtr->timeValid;
+    uint64_t       time = pointPtr->time;
+
+    if (timed && pointPtr->isDate)
+    {
+        if ((NULL == lastPtr) && (0 == trackPtr->startTime))
+        {
+            trackPtr->startTime = time;
+        }
+
+        // Dates of an undated track can't be placed on its time line.
+        if ((0 == trackPtr->startTime) || (time < trackPtr->startTime))
+        {
+            timed = false;
+        }
+        else
+        {
+            time -= trackPtr->startTime;
+        }
+    }
+
+    if (!timed)
+    {
+        if (NULL == lastPtr)
+        {
+            time = 0;
+        }
+        else
+        {
+            Waypoint_t point = { .latitude = pointPtr->latitude, .longitude = pointPtr->longitude };
+            double     north;
+            double     east;
+
+            GetLegVector(lastPtr, &point, &north, &east);
+            time = lastPtr->time + 1
+                   + (uint64_t)(hypot(north, east) * 1000 / PA_TRAJECTORYSIMU_DEFAULT_SPEED);
+        }
+    }
+
+    return pa_trajectorySimu_AddWaypoint(trackPtr, time, pointPtr->latitude, pointPtr->longitude,
+                                         pointPtr->altitude);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the value of an attribute of a XML tag.
+ *
+ * @return true if the attribute was found.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetAttribute
+(
+    const char* tagPtr,         ///< [IN] Tag, without the leading '<'
+    const char* namePtr,        ///< [IN] Attribute name
+    double*     valuePtr        ///< [OUT] Attribute value
+)
+{
+    size_t      nameLen = strlen(namePtr);
+    const char* attrPtr = tagPtr;
+
+    while (NULL != (attrPtr = strstr(attrPtr, namePtr)))
+    {
+        const char* valueTextPtr = attrPtr + nameLen;
+        char*       endPtr;
+
+        if (isspace((unsigned char)attrPtr[-1]) && ('=' == valueTextPtr[0])
+            && (('"' == valueTextPtr[1]) || ('\'' == valueTextPtr[1])))
+        {
+            *valuePtr = strtod(valueTextPtr + 2, &endPtr);
+            return (endPtr != valueTextPtr + 2);
+        }
+        attrPtr = valueTextPtr;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a XML tag has a given name.
+ *
+ * @return true if the tag has the name.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsTag
+(
+    const char* tagPtr,         ///< [IN] Tag, without the leading '<'
+    const char* namePtr         ///< [IN] Tag name, with the '/' of a closing tag
+)
+{
+    size_t nameLen = strlen(namePtr);
+
+    return ((0 == strncmp(tagPtr, namePtr, nameLen))
+            && (isspace((unsigned char)tagPtr[nameLen]) || ('/' == tagPtr[nameLen])
+                || ('>' == tagPtr[nameLen])));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the track and route points of a GPX file. The file is read tag by tag.
+ *
+ * @return The number of points appended to the track.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t LoadGpx
+(
+    Track_t* trackPtr,          ///< [IN] Track
+    FILE*    filePtr            ///< [IN] GPX file
+)
+{
+    enum { FIELD_NONE, FIELD_ELEVATION, FIELD_TIME } field = FIELD_NONE;
+    Point_t  point;
+    bool     inPoint = false;
+    uint32_t pointCount = 0;
+    char*    tokenPtr = NULL;
+    size_t   tokenSize = 0;
+
+    // Each token is the text before a tag followed by the tag itself.
+    while (getdelim(&tokenPtr, &tokenSize, '>', filePtr) > 0)
+    {
+        char* tagPtr = strchr(tokenPtr, '<');
+        bool  pointEnd = false;
+
+        if (NULL == tagPtr)
+        {
+            continue;
+        }
+        *tagPtr++ = '\0';
+
+        if (inPoint && (FIELD_ELEVATION == field))
+        {
+            point.altitude = strtod(tokenPtr, NULL);
+        }
+        else if (inPoint && (FIELD_TIME == field))
+        {
+            point.timeValid = ParseDate(tokenPtr, &point.time);
+            point.isDate = true;
+        }
+        field = FIELD_NONE;
+
+        if (IsTag(tagPtr, "trkpt") || IsTag(tagPtr, "rtept"))
+        {
+            memset(&point, 0, sizeof(point));
+            inPoint = GetAttribute(tagPtr, "lat", &point.latitude)
+                      && GetAttribute(tagPtr, "lon", &point.longitude);
+            LE_WARN_IF(!inPoint, "Point without position");
+            pointEnd = ('/' == tagPtr[strlen(tagPtr) - 2]);
+        }
+        else if (IsTag(tagPtr, "/trkpt") || IsTag(tagPtr, "/rtept"))
+        {
+            pointEnd = true;
+        }
+        else if (IsTag(tagPtr, "ele"))
+        {
+            field = FIELD_ELEVATION;
+        }
+        else if (IsTag(tagPtr, "time"))
+        {
+            field = FIELD_TIME;
+        }
+
+        if (pointEnd && inPoint)
+        {
+            if (LE_OK == AddPoint(trackPtr, &point))
+            {
+                pointCount++;
+            }
+            inPoint = false;
+        }
+    }
+
+    free(tokenPtr);
+    return pointCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the points of a CSV file.
+ *
+ * @return The number of points appended to the track.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t LoadCsv
+(
+    Track_t* trackPtr,          ///< [IN] Track
+    FILE*    filePtr            ///< [IN] CSV file
+)
+{
+    uint32_t pointCount = 0;
+    uint32_t lineNumber = 0;
+    char*    linePtr = NULL;
+    size_t   lineSize = 0;
+
+    while (getline(&linePtr, &lineSize, filePtr) > 0)
+    {
+        Point_t point = { .timeValid = true };
+        char*   savePtr;
+        char*   fieldPtr[4] = { NULL };
+        char*   endPtr;
+        size_t  fieldCount = 0;
+        double  seconds;
+
+        lineNumber++;
+        if (('#' == linePtr[strspn(linePtr, " \t")]) || ('\0' == linePtr[strspn(linePtr, " \t\r\n")]))
+        {
+            continue;
+        }
+
+        for (fieldPtr[0] = strtok_r(linePtr, ",;\r\n", &savePtr);
+             NULL != fieldPtr[fieldCount];
+             fieldPtr[fieldCount] = strtok_r(NULL, ",;\r\n", &savePtr))
+        {
+            if (++fieldCount == NUM_ARRAY_MEMBERS(fieldPtr))
+            {
+                break;
+            }
+        }
+        if (fieldCount < 3)
+        {
+            LE_WARN("Line %"PRIu32": missing fields", lineNumber);
+            continue;
+        }
+
+        if (NULL != strchr(fieldPtr[0], 'T'))
+        {
+            point.isDate = true;
+            point.timeValid = ParseDate(fieldPtr[0], &point.time);
+        }
+        else
+        {
+            seconds = strtod(fieldPtr[0], &endPtr);
+            if ((endPtr == fieldPtr[0]) || (seconds < 0))
+            {
+                // Header line
+                continue;
+            }
+            point.time = (uint64_t)llround(seconds * 1000);
+        }
+
+        point.latitude = strtod(fieldPtr[1], &endPtr);
+        if (endPtr == fieldPtr[1])
+        {
+            continue;
+        }
+        point.longitude = strtod(fieldPtr[2], &endPtr);
+        if (endPtr == fieldPtr[2])
+        {
+            continue;
+        }
+        if (NULL != fieldPtr[3])
+        {
+            point.altitude = strtod(fieldPtr[3], NULL);
+        }
+
+        if (LE_OK == AddPoint(trackPtr, &point))
+        {
+            pointCount++;
+        }
+        else
+        {
+            LE_WARN("Line %"PRIu32": invalid point", lineNumber);
+        }
+    }
+
+    free(linePtr);
+    return pointCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty track.
+ *
+ * @return The track reference.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_trajectorySimu_TrackRef_t pa_trajectorySimu_CreateTrack
+(
+    void
+)
+{
+    Track_t* trackPtr = le_mem_ForceAlloc(TrackPool);
+
+    trackPtr->waypointList = LE_DLS_LIST_INIT;
+    trackPtr->cursorPtr = NULL;
+    trackPtr->startTime = 0;
+    trackPtr->loop = false;
+
+    return trackPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a track and its waypoints.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_trajectorySimu_DeleteTrack
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Track
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    LE_ASSERT(trackRef);
+
+    while (NULL != (linkPtr = le_dls_Pop(&trackRef->waypointList)))
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, Waypoint_t, link));
+    }
+    le_mem_Release(trackRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a waypoint to a track.
+ *
+ * @return LE_BAD_PARAMETER The position is invalid or the time is not after the last waypoint.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_AddWaypoint
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    uint64_t                     time,      ///< [IN] Time from the track start in milliseconds
+    double                       latitude,  ///< [IN] Latitude in degrees
+    double                       longitude, ///< [IN] Longitude in degrees
+    double                       altitude   ///< [IN] Altitude in meters
+)
+{
+    le_dls_Link_t* linkPtr;
+    Waypoint_t*    waypointPtr;
+
+    LE_ASSERT(trackRef);
+
+    if ((fabs(latitude) > 90.0) || (fabs(longitude) > 180.0) || !isfinite(altitude))
+    {
+        LE_ERROR("Invalid position %f, %f, %f", latitude, longitude, altitude);
+        return LE_BAD_PARAMETER;
+    }
+
+    linkPtr = le_dls_PeekTail(&trackRef->waypointList);
+    if ((NULL != linkPtr) && (time <= CONTAINER_OF(linkPtr, Waypoint_t, link)->time))
+    {
+        LE_ERROR("Waypoint time %"PRIu64" ms is not after the last waypoint", time);
+        return LE_BAD_PARAMETER;
+    }
+
+    waypointPtr = le_mem_ForceAlloc(WaypointPool);
+    waypointPtr->link = LE_DLS_LINK_INIT;
+    waypointPtr->time = time;
+    waypointPtr->latitude = latitude;
+    waypointPtr->longitude = longitude;
+    waypointPtr->altitude = altitude;
+    le_dls_Queue(&trackRef->waypointList, &waypointPtr->link);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a straight leg to a track, starting from its last waypoint.
+ *
+ * @return LE_NOT_FOUND     The track has no waypoint to start from.
+ * @return LE_BAD_PARAMETER The distance or the speed is not positive.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_AddLeg
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    double                       direction, ///< [IN] Direction in degrees from the North
+    double                       distance,  ///< [IN] Length in meters
+    double                       speed      ///< [IN] Speed in meters/second
+)
+{
+    le_dls_Link_t* linkPtr;
+    Waypoint_t*    lastPtr;
+    double         latitude;
+    double         longitude;
+    uint64_t       duration;
+
+    LE_ASSERT(trackRef);
+
+    linkPtr = le_dls_PeekTail(&trackRef->waypointList);
+    if (NULL == linkPtr)
+    {
+        LE_ERROR("No waypoint to start the leg from");
+        return LE_NOT_FOUND;
+    }
+    if (!(distance > 0) || !(speed > 0))
+    {
+        LE_ERROR("Invalid leg: %f m at %f m/s", distance, speed);
+        return LE_BAD_PARAMETER;
+    }
+    lastPtr = CONTAINER_OF(linkPtr, Waypoint_t, link);
+
+    latitude = lastPtr->latitude
+               + distance * cos(direction * DEG_TO_RAD) / EARTH_RADIUS / DEG_TO_RAD;
+    longitude = lastPtr->longitude
+                + distance * sin(direction * DEG_TO_RAD)
+                  / (EARTH_RADIUS * cos((lastPtr->latitude + latitude) / 2 * DEG_TO_RAD))
+                  / DEG_TO_RAD;
+    duration = (uint64_t)llround(distance * 1000 / speed);
+
+    return pa_trajectorySimu_AddWaypoint(trackRef, lastPtr->time + (duration ? duration : 1),
+                                         latitude, NormalizeLongitude(longitude),
+                                         lastPtr->altitude);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the points of a GPX (track or route points) or CSV file to a track.
+ *
+ * @return LE_NOT_FOUND     The file can't be opened.
+ * @return LE_FORMAT_ERROR  The file holds no valid point.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_LoadFile
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    const char*                  pathPtr    ///< [IN] GPX or CSV file path
+)
+{
+    FILE*    filePtr;
+    int      c;
+    uint32_t pointCount;
+
+    LE_ASSERT(trackRef);
+    LE_ASSERT(pathPtr);
+
+    filePtr = fopen(pathPtr, "r");
+    if (NULL == filePtr)
+    {
+        LE_ERROR("Cannot open %s: %m", pathPtr);
+        return LE_NOT_FOUND;
+    }
+
+    // XML files start with a tag, after an optional byte order mark.
+    do
+    {
+        c = fgetc(filePtr);
+    }
+    while (isspace(c) || (c > 0x7F));
+    ungetc(c, filePtr);
+
+    pointCount = ('<' == c) ? LoadGpx(trackRef, filePtr) : LoadCsv(trackRef, filePtr);
+    fclose(filePtr);
+
+    if (0 == pointCount)
+    {
+        LE_ERROR("No valid point in %s", pathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    LE_INFO("%"PRIu32" points loaded from %s", pointCount, pathPtr);
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loop the playback of a track.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_trajectorySimu_SetLoop
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    bool                         loop       ///< [IN] Loop the playback
+)
+{
+    LE_ASSERT(trackRef);
+
+    trackRef->loop = loop;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the duration of a track.
+ *
+ * @return The time of the last waypoint in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t pa_trajectorySimu_GetDuration
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Track
+)
+{
+    le_dls_Link_t* linkPtr;
+
+    LE_ASSERT(trackRef);
+
+    linkPtr = le_dls_PeekTail(&trackRef->waypointList);
+    return (linkPtr ? CONTAINER_OF(linkPtr, Waypoint_t, link)->time : 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the UTC time of the track start.
+ *
+ * @return The UTC time in milliseconds since Jan. 1, 1970, or 0 if the track is not dated.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t pa_trajectorySimu_GetStartTime
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Track
+)
+{
+    LE_ASSERT(trackRef);
+
+    return trackRef->startTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample the fix of a track at a time of its playback.
+ *
+ * @return LE_NOT_FOUND     The track has no waypoint.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_GetFix
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    uint64_t                     time,      ///< [IN] Time from the track start in milliseconds
+    pa_trajectorySimu_Fix_t*     fixPtr     ///< [OUT] Fix
+)
+{
+    le_dls_Link_t* linkPtr;
+    Waypoint_t*    firstPtr;
+    Waypoint_t*    fromPtr;
+    Waypoint_t*    toPtr;
+    uint64_t       duration;
+    double         north;
+    double         east;
+
+    LE_ASSERT(trackRef);
+    LE_ASSERT(fixPtr);
+
+    linkPtr = le_dls_Peek(&trackRef->waypointList);
+    if (NULL == linkPtr)
+    {
+        return LE_NOT_FOUND;
+    }
+    firstPtr = CONTAINER_OF(linkPtr, Waypoint_t, link);
+
+    duration = pa_trajectorySimu_GetDuration(trackRef);
+    if (time > duration)
+    {
+        time = ((trackRef->loop && duration) ? time % duration : duration);
+    }
+
+    // Move the cursor to the leg holding the time, restarting from the head when going back.
+    fromPtr = trackRef->cursorPtr;
+    if ((NULL == fromPtr) || (fromPtr->time > time))
+    {
+        fromPtr = firstPtr;
+    }
+    while ((NULL != (toPtr = GetNextWaypoint(trackRef, fromPtr))) && (toPtr->time <= time))
+    {
+        fromPtr = toPtr;
+    }
+    trackRef->cursorPtr = fromPtr;
+
+    if (NULL == toPtr)
+    {
+        // Stopped on the last waypoint, heading as on the last leg.
+        fixPtr->latitude = fromPtr->latitude;
+        fixPtr->longitude = fromPtr->longitude;
+        fixPtr->altitude = fromPtr->altitude;
+        fixPtr->hSpeed = 0;
+        fixPtr->vSpeed = 0;
+        fixPtr->direction = 0;
+
+        linkPtr = le_dls_PeekPrev(&trackRef->waypointList, &fromPtr->link);
+        if (NULL != linkPtr)
+        {
+            GetLegVector(CONTAINER_OF(linkPtr, Waypoint_t, link), fromPtr, &north, &east);
+            fixPtr->direction = GetDirection(north, east);
+        }
+    }
+    else
+    {
+        double legDuration = (toPtr->time - fromPtr->time) / 1000.0;
+        double ratio = (time - fromPtr->time) / 1000.0 / legDuration;
+
+        GetLegVector(fromPtr, toPtr, &north, &east);
+
+        fixPtr->latitude = fromPtr->latitude + ratio * (toPtr->latitude - fromPtr->latitude);
+        fixPtr->longitude = NormalizeLongitude(fromPtr->longitude
+                            + ratio * GetLongitudeDelta(fromPtr->longitude, toPtr->longitude));
+        fixPtr->altitude = fromPtr->altitude + ratio * (toPtr->altitude - fromPtr->altitude);
+        fixPtr->hSpeed = hypot(north, east) / legDuration;
+        fixPtr->vSpeed = (toPtr->altitude - fromPtr->altitude) / legDuration;
+        fixPtr->direction = GetDirection(north, east);
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_trajectory simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_trajectorySimu_Init
+(
+    void
+)
+{
+    TrackPool = le_mem_CreatePool("TrajectoryTrackPool", sizeof(Track_t));
+    le_mem_ExpandPool(TrackPool, TRACK_POOL_SIZE);
+
+    WaypointPool = le_mem_CreatePool("TrajectoryWaypointPool", sizeof(Waypoint_t));
+    le_mem_ExpandPool(WaypointPool, WAYPOINT_POOL_SIZE);
+}
@@ -0,0 +1,185 @@
+/** @file pa_trajectory_simu.h
+ *
+ * Legato @ref pa_trajectory_simu include file.
+ *
+ * Trajectories followed by the simulated GNSS receiver: GPX or CSV tracks played back, or routes
+ * synthesized waypoint by waypoint or leg by leg. A track is sampled at any time of its playback
+ * and always gives the same fix for the same time.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_TRAJECTORY_SIMU_H_INCLUDE_GUARD
+#define PA_TRAJECTORY_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Speed used to time the points loaded without time, in meters/second.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PA_TRAJECTORYSIMU_DEFAULT_SPEED     13.9
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fix sampled on a track.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    double latitude;        ///< Latitude in degrees, positive North
+    double longitude;       ///< Longitude in degrees, positive East
+    double altitude;        ///< Altitude in meters above the mean sea level
+    double hSpeed;          ///< Horizontal speed in meters/second
+    double vSpeed;          ///< Vertical speed in meters/second, positive up
+    double direction;       ///< Direction of the movement in degrees from the North [0..360[
+}
+pa_trajectorySimu_Fix_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference type for a track.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pa_trajectorySimu_Track* pa_trajectorySimu_TrackRef_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the pa_trajectory simu.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_trajectorySimu_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an empty track.
+ *
+ * @return The track reference.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_trajectorySimu_TrackRef_t pa_trajectorySimu_CreateTrack
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a track and its waypoints.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_trajectorySimu_DeleteTrack
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Track
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a waypoint to a track.
+ *
+ * @return LE_BAD_PARAMETER The position is invalid or the time is not after the last waypoint.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_AddWaypoint
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    uint64_t                     time,      ///< [IN] Time from the track start in milliseconds
+    double                       latitude,  ///< [IN] Latitude in degrees
+    double                       longitude, ///< [IN] Longitude in degrees
+    double                       altitude   ///< [IN] Altitude in meters
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a straight leg to a track, starting from its last waypoint.
+ *
+ * @return LE_NOT_FOUND     The track has no waypoint to start from.
+ * @return LE_BAD_PARAMETER The distance or the speed is not positive.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_AddLeg
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    double                       direction, ///< [IN] Direction in degrees from the North
+    double                       distance,  ///< [IN] Length in meters
+    double                       speed      ///< [IN] Speed in meters/second
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append the points of a GPX (track or route points) or CSV file to a track.
+ *
+ * CSV lines are "time,latitude,longitude[,altitude]", the time being either seconds from the track
+ * start or an ISO 8601 UTC date. Empty lines, comments (#) and a header line are skipped. Points
+ * without time are timed at PA_TRAJECTORYSIMU_DEFAULT_SPEED from the previous one.
+ *
+ * @return LE_NOT_FOUND     The file can't be opened.
+ * @return LE_FORMAT_ERROR  The file holds no valid point.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_LoadFile
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    const char*                  pathPtr    ///< [IN] GPX or CSV file path
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loop the playback of a track: once its last waypoint is reached, the track restarts from its
+ * first one. Otherwise the fixes stay on the last waypoint.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_trajectorySimu_SetLoop
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    bool                         loop       ///< [IN] Loop the playback
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the duration of a track.
+ *
+ * @return The time of the last waypoint in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t pa_trajectorySimu_GetDuration
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Track
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the UTC time of the track start, given by the dates of the loaded points.
+ *
+ * @return The UTC time in milliseconds since Jan. 1, 1970, or 0 if the track is not dated.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t pa_trajectorySimu_GetStartTime
+(
+    pa_trajectorySimu_TrackRef_t trackRef   ///< [IN] Track
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample the fix of a track at a time of its playback. Positions are interpolated between the
+ * waypoints, speeds and direction are the ones of the current leg.
+ *
+ * @return LE_NOT_FOUND     The track has no waypoint.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_trajectorySimu_GetFix
+(
+    pa_trajectorySimu_TrackRef_t trackRef,  ///< [IN] Track
+    uint64_t                     time,      ///< [IN] Time from the track start in milliseconds
+    pa_trajectorySimu_Fix_t*     fixPtr     ///< [OUT] Fix
+);
+
+#endif
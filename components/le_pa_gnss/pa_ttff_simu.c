@@ -0,0 +1,255 @@
+/**
+ * @file pa_ttff_simu.c
+ *
+ * Time to first fix of the simulated GNSS receiver.
+ *
+ * TTFFs are drawn from log-normal distributions, positive and right-skewed like the TTFFs
+ * measured on real receivers, with a seeded generator so that a sequence of starts can be
+ * replayed.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include <pa_gnss.h>
+#include "pa_ttff_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Validity of the decoded ephemeris in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define EPHEMERIS_VALIDITY          (4 * 3600 * 1000ULL)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default seed of the TTFF draws.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_SEED                0x2545F491
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * TTFF distribution: mean and standard deviation in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t mean;
+    uint32_t deviation;
+}
+Distribution_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * TTFF distributions of the start types.
+ */
+//--------------------------------------------------------------------------------------------------
+static Distribution_t Distributions[PA_TTFFSIMU_START_MAX] =
+{
+    [PA_TTFFSIMU_HOT_START]     = {  2000,   500 },
+    [PA_TTFFSIMU_WARM_START]    = { 30000,  5000 },
+    [PA_TTFFSIMU_COLD_START]    = { 35000,  6000 },
+    [PA_TTFFSIMU_FACTORY_START] = { 60000, 15000 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the random generator.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t RandomState = DEFAULT_SEED;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Draw a uniform number in ]0, 1[.
+ *
+ * @return The number.
+ */
+//--------------------------------------------------------------------------------------------------
+static double DrawUniform
+(
+    void
+)
+{
+    // xorshift32
+    RandomState ^= RandomState << 13;
+    RandomState ^= RandomState >> 17;
+    RandomState ^= RandomState << 5;
+    return (RandomState + 0.5) / 4294967296.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the knowledge of a receiver out of the factory, with an almanac.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_ttffSimu_InitKnowledge
+(
+    pa_ttffSimu_Knowledge_t* knowledgePtr   ///< [OUT] Receiver knowledge
+)
+{
+    memset(knowledgePtr, 0, sizeof(*knowledgePtr));
+    knowledgePtr->almanacValid = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a restart to the knowledge of a receiver.
+ *
+ * @return LE_BAD_PARAMETER Unknown restart type.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_ttffSimu_Restart
+(
+    pa_ttffSimu_Knowledge_t* knowledgePtr,  ///< [IN/OUT] Receiver knowledge
+    pa_gnss_Restart_t        restartType    ///< [IN] Restart type
+)
+{
+    switch (restartType)
+    {
+        case PA_GNSS_FACTORY_RESTART:
+            knowledgePtr->almanacValid = false;
+            knowledgePtr->xtraStartTime = 0;
+            knowledgePtr->xtraStopTime = 0;
+            // fall through
+        case PA_GNSS_COLD_RESTART:
+            knowledgePtr->timeValid = false;
+            // fall through
+        case PA_GNSS_WARM_RESTART:
+            knowledgePtr->ephemerisTime = 0;
+            // fall through
+        case PA_GNSS_HOT_RESTART:
+            return LE_OK;
+
+        default:
+            LE_ERROR("Unknown restart type %d", restartType);
+            return LE_BAD_PARAMETER;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the knowledge of a receiver with a fix: ephemeris and time are known.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_ttffSimu_SetFix
+(
+    pa_ttffSimu_Knowledge_t* knowledgePtr,  ///< [IN/OUT] Receiver knowledge
+    uint64_t                 utcTime        ///< [IN] Receiver UTC time of the fix in ms
+)
+{
+    knowledgePtr->almanacValid = true;
+    knowledgePtr->timeValid = true;
+    knowledgePtr->ephemerisTime = utcTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the start type of a receiver.
+ *
+ * @return The start type.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_ttffSimu_Start_t pa_ttffSimu_GetStartType
+(
+    const pa_ttffSimu_Knowledge_t* knowledgePtr,    ///< [IN] Receiver knowledge
+    uint64_t                       utcTime          ///< [IN] Receiver UTC time of the start in ms
+)
+{
+    bool xtraValid = knowledgePtr->xtraEnabled && (0 != knowledgePtr->xtraStartTime)
+                     && (utcTime / 1000 >= knowledgePtr->xtraStartTime)
+                     && (utcTime / 1000 < knowledgePtr->xtraStopTime);
+    bool ephemerisValid = xtraValid
+                          || ((0 != knowledgePtr->ephemerisTime)
+                              && (utcTime >= knowledgePtr->ephemerisTime)
+                              && (utcTime - knowledgePtr->ephemerisTime < EPHEMERIS_VALIDITY));
+    bool almanacValid = knowledgePtr->almanacValid || xtraValid;
+
+    if (ephemerisValid && knowledgePtr->timeValid)
+    {
+        return PA_TTFFSIMU_HOT_START;
+    }
+    if (almanacValid && knowledgePtr->timeValid)
+    {
+        return PA_TTFFSIMU_WARM_START;
+    }
+    if (almanacValid)
+    {
+        return PA_TTFFSIMU_COLD_START;
+    }
+    return PA_TTFFSIMU_FACTORY_START;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Draw a TTFF from the distribution of a start type.
+ *
+ * @return The TTFF in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_ttffSimu_DrawTtff
+(
+    pa_ttffSimu_Start_t startType   ///< [IN] Start type
+)
+{
+    LE_ASSERT(startType < PA_TTFFSIMU_START_MAX);
+
+    double mean = Distributions[startType].mean;
+    double deviation = Distributions[startType].deviation;
+
+    if (0 == Distributions[startType].deviation)
+    {
+        return Distributions[startType].mean;
+    }
+
+    // Log-normal parameters giving the mean and deviation, and Box-Muller normal draw.
+    double sigma2 = log(1 + (deviation * deviation) / (mean * mean));
+    double mu = log(mean) - sigma2 / 2;
+    double normal = sqrt(-2 * log(DrawUniform())) * cos(2 * M_PI * DrawUniform());
+    double ttff = exp(mu + sqrt(sigma2) * normal);
+
+    return (ttff < 1) ? 1 : ((ttff > UINT32_MAX) ? UINT32_MAX : (uint32_t)lround(ttff));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the TTFF distribution of a start type.
+ *
+ * @return LE_BAD_PARAMETER Unknown start type or null mean.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_ttffSimu_SetDistribution
+(
+    pa_ttffSimu_Start_t startType,  ///< [IN] Start type
+    uint32_t            mean,       ///< [IN] Mean TTFF in milliseconds
+    uint32_t            deviation   ///< [IN] Standard deviation in milliseconds
+)
+{
+    if ((startType >= PA_TTFFSIMU_START_MAX) || (0 == mean))
+    {
+        LE_ERROR("Invalid TTFF distribution %d: %"PRIu32" ms", startType, mean);
+        return LE_BAD_PARAMETER;
+    }
+
+    Distributions[startType].mean = mean;
+    Distributions[startType].deviation = deviation;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Seed the TTFF draws, to replay the same sequence of TTFFs.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_ttffSimu_SetSeed
+(
+    uint32_t seed   ///< [IN] Seed, not null
+)
+{
+    RandomState = (0 == seed) ? DEFAULT_SEED : seed;
+}
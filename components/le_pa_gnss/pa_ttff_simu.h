@@ -0,0 +1,141 @@
+/** @file pa_ttff_simu.h
+ *
+ * Legato @ref pa_ttff_simu include file.
+ *
+ * Time to first fix of the simulated GNSS receiver: the start type is given by what the receiver
+ * knows when it starts (almanac, ephemeris and time), and the TTFF is drawn from the
+ * distribution of the start type.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_TTFF_SIMU_H_INCLUDE_GUARD
+#define PA_TTFF_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start types.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PA_TTFFSIMU_HOT_START = 0,  ///< Ephemeris and time known
+    PA_TTFFSIMU_WARM_START,     ///< Almanac and time known
+    PA_TTFFSIMU_COLD_START,     ///< Almanac known
+    PA_TTFFSIMU_FACTORY_START,  ///< Nothing known
+    PA_TTFFSIMU_START_MAX
+}
+pa_ttffSimu_Start_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * What the receiver knows.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    bool     almanacValid;      ///< Almanac known
+    bool     timeValid;         ///< Time known, from a fix or injected
+    uint64_t ephemerisTime;     ///< UTC time of the ephemeris decoding in milliseconds, 0 if none
+    bool     xtraEnabled;       ///< Extended ephemeris enabled
+    uint64_t xtraStartTime;     ///< Start of the extended ephemeris validity in seconds since
+                                ///< Jan. 1, 1970, 0 if none loaded
+    uint64_t xtraStopTime;      ///< End of the extended ephemeris validity in seconds since
+                                ///< Jan. 1, 1970
+}
+pa_ttffSimu_Knowledge_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the knowledge of a receiver out of the factory, with an almanac.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_ttffSimu_InitKnowledge
+(
+    pa_ttffSimu_Knowledge_t* knowledgePtr   ///< [OUT] Receiver knowledge
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a restart to the knowledge of a receiver: a warm restart clears the ephemeris, a cold one
+ * also clears the time, a factory one also clears the almanac and the extended
+ * ephemeris.
+ *
+ * @return LE_BAD_PARAMETER Unknown restart type.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_ttffSimu_Restart
+(
+    pa_ttffSimu_Knowledge_t* knowledgePtr,  ///< [IN/OUT] Receiver knowledge
+    pa_gnss_Restart_t        restartType    ///< [IN] Restart type
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the knowledge of a receiver with a fix: ephemeris and time are known.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_ttffSimu_SetFix
+(
+    pa_ttffSimu_Knowledge_t* knowledgePtr,  ///< [IN/OUT] Receiver knowledge
+    uint64_t                 utcTime        ///< [IN] Receiver UTC time of the fix in ms
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the start type of a receiver. Enabled extended ephemeris valid at the start time count as
+ * ephemeris and almanac, decoded ephemeris expire after 4 hours. The times are given by the
+ * receiver clock, the injected UTC time or the system time.
+ *
+ * @return The start type.
+ */
+//--------------------------------------------------------------------------------------------------
+pa_ttffSimu_Start_t pa_ttffSimu_GetStartType
+(
+    const pa_ttffSimu_Knowledge_t* knowledgePtr,    ///< [IN] Receiver knowledge
+    uint64_t                       utcTime          ///< [IN] Receiver UTC time of the start in ms
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Draw a TTFF from the distribution of a start type.
+ *
+ * @return The TTFF in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_ttffSimu_DrawTtff
+(
+    pa_ttffSimu_Start_t startType   ///< [IN] Start type
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the TTFF distribution of a start type: log-normal, with the given mean and standard
+ * deviation. A null deviation gives a constant TTFF.
+ *
+ * @return LE_BAD_PARAMETER Unknown start type or null mean.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_ttffSimu_SetDistribution
+(
+    pa_ttffSimu_Start_t startType,  ///< [IN] Start type
+    uint32_t            mean,       ///< [IN] Mean TTFF in milliseconds
+    uint32_t            deviation   ///< [IN] Standard deviation in milliseconds
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Seed the TTFF draws, to replay the same sequence of TTFFs.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void pa_ttffSimu_SetSeed
+(
+    uint32_t seed   ///< [IN] Seed, not null
+);
+
+#endif
@@ -0,0 +1,430 @@
+/**
+ * @file pa_xtra_simu.c
+ *
+ * Extended ephemeris files of the simulated GNSS receiver.
+ *
+ * Files are mapped in memory rather than read into a buffer, so that loading a large file doesn't
+ * allocate or copy it. The header, the records and the CRC are checked in a single sequential pass
+ * over the mapping.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include <pa_gnss.h>
+#include <sys/mman.h>
+#include "pa_xtra_simu.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * File magic and version.
+ */
+//--------------------------------------------------------------------------------------------------
+#define XTRA_MAGIC                  "XTRA"
+#define XTRA_VERSION                1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sizes of the header, of a satellite record, of its orbit data and of the CRC, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_SIZE                 16
+#define RECORD_SIZE                 72
+#define ORBIT_DATA_SIZE             (RECORD_SIZE - 4)
+#define CRC_SIZE                    4
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records written at once.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WRITE_RECORD_COUNT          64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GPS epoch (Jan. 6, 1980) in seconds since Jan. 1, 1970, seconds of a GPS week, and GPS-UTC
+ * leap seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GPS_EPOCH_TIME              315964800ULL
+#define GPS_WEEK_SECONDS            604800
+#define GPS_LEAP_SECONDS            18
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CRC-32 (IEEE 802.3) reflected polynomial.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CRC32_POLYNOMIAL            0xEDB88320
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CRC-32 of every byte value, built on first use.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t CrcTable[256];
+static bool     CrcTableReady = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the CRC-32 table.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitCrcTable
+(
+    void
+)
+{
+    uint32_t i;
+    int      bit;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(CrcTable); i++)
+    {
+        uint32_t crc = i;
+
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? ((crc >> 1) ^ CRC32_POLYNOMIAL) : (crc >> 1);
+        }
+        CrcTable[i] = crc;
+    }
+    CrcTableReady = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update a CRC-32 with a block of data. The CRC starts and ends inverted: start with 0xFFFFFFFF,
+ * invert the result.
+ *
+ * @return The updated CRC.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t UpdateCrc
+(
+    uint32_t       crc,     ///< [IN] CRC of the previous blocks
+    const uint8_t* dataPtr, ///< [IN] Block
+    size_t         size     ///< [IN] Block size
+)
+{
+    while (size--)
+    {
+        crc = CrcTable[(crc ^ *dataPtr++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read big endian fields.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint16_t GetUint16
+(
+    const uint8_t* dataPtr  ///< [IN] Field
+)
+{
+    return (uint16_t)((dataPtr[0] << 8) | dataPtr[1]);
+}
+
+static uint32_t GetUint32
+(
+    const uint8_t* dataPtr  ///< [IN] Field
+)
+{
+    return ((uint32_t)dataPtr[0] << 24) | ((uint32_t)dataPtr[1] << 16)
+           | ((uint32_t)dataPtr[2] << 8) | dataPtr[3];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write big endian fields.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PutUint16
+(
+    uint8_t* dataPtr,   ///< [OUT] Field
+    uint16_t value      ///< [IN] Value
+)
+{
+    dataPtr[0] = (uint8_t)(value >> 8);
+    dataPtr[1] = (uint8_t)value;
+}
+
+static void PutUint32
+(
+    uint8_t* dataPtr,   ///< [OUT] Field
+    uint32_t value      ///< [IN] Value
+)
+{
+    dataPtr[0] = (uint8_t)(value >> 24);
+    dataPtr[1] = (uint8_t)(value >> 16);
+    dataPtr[2] = (uint8_t)(value >> 8);
+    dataPtr[3] = (uint8_t)value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer to a file.
+ *
+ * @return LE_FAULT         The file can't be written.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAll
+(
+    int            fd,      ///< [IN] File descriptor
+    const uint8_t* dataPtr, ///< [IN] Buffer
+    size_t         size     ///< [IN] Buffer size
+)
+{
+    while (size > 0)
+    {
+        ssize_t count = write(fd, dataPtr, size);
+
+        if (count < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            LE_ERROR("Failed to write the extended ephemeris file: %m");
+            return LE_FAULT;
+        }
+        dataPtr += count;
+        size -= (size_t)count;
+    }
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the mapped file and get its validity.
+ *
+ * @return LE_FORMAT_ERROR  The file is truncated, has an invalid header or record, or a wrong CRC.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseMapping
+(
+    const uint8_t* dataPtr,         ///< [IN] Mapped file
+    size_t         size,            ///< [IN] File size
+    uint64_t*      startTimePtr,    ///< [OUT] Start of the validity in seconds since Jan. 1, 1970
+    uint64_t*      stopTimePtr,     ///< [OUT] End of the validity in seconds since Jan. 1, 1970
+    uint32_t*      recordCountPtr   ///< [OUT] Number of satellite records
+)
+{
+    const uint8_t* recordPtr;
+    uint32_t       recordCount;
+    uint32_t       timeOfWeek;
+    uint16_t       validity;
+    uint32_t       crc;
+    uint32_t       i;
+
+    // Check the header, and the file size against the record count before touching the records.
+    if ((size < HEADER_SIZE + CRC_SIZE) || (0 != memcmp(dataPtr, XTRA_MAGIC, 4)))
+    {
+        LE_ERROR("Not an extended ephemeris file");
+        return LE_FORMAT_ERROR;
+    }
+    if (XTRA_VERSION != dataPtr[4])
+    {
+        LE_ERROR("Unsupported extended ephemeris file version %d", dataPtr[4]);
+        return LE_FORMAT_ERROR;
+    }
+
+    recordCount = GetUint16(&dataPtr[6]);
+    timeOfWeek = GetUint32(&dataPtr[10]);
+    validity = GetUint16(&dataPtr[14]);
+
+    if (size != HEADER_SIZE + (size_t)recordCount * RECORD_SIZE + CRC_SIZE)
+    {
+        LE_ERROR("Extended ephemeris file of %zu bytes for %"PRIu32" records", size, recordCount);
+        return LE_FORMAT_ERROR;
+    }
+    if ((0 == recordCount) || (timeOfWeek >= GPS_WEEK_SECONDS) || (0 == validity))
+    {
+        LE_ERROR("Invalid extended ephemeris file: %"PRIu32" records, time of week %"PRIu32
+                 ", validity %d h", recordCount, timeOfWeek, validity);
+        return LE_FORMAT_ERROR;
+    }
+
+    // Single pass over the records, checking them while updating the CRC.
+    crc = UpdateCrc(0xFFFFFFFF, dataPtr, HEADER_SIZE);
+    recordPtr = dataPtr + HEADER_SIZE;
+    for (i = 0; i < recordCount; i++, recordPtr += RECORD_SIZE)
+    {
+        uint8_t constellation = recordPtr[2];
+
+        if ((0 == GetUint16(recordPtr))
+            || (LE_GNSS_SV_CONSTELLATION_UNDEFINED == constellation)
+            || (constellation >= LE_GNSS_SV_CONSTELLATION_MAX))
+        {
+            LE_ERROR("Invalid extended ephemeris record %"PRIu32": satellite %d, constellation %d",
+                     i, GetUint16(recordPtr), constellation);
+            return LE_FORMAT_ERROR;
+        }
+        crc = UpdateCrc(crc, recordPtr, RECORD_SIZE);
+    }
+
+    crc = ~crc;
+    if (crc != GetUint32(recordPtr))
+    {
+        LE_ERROR("Extended ephemeris file CRC %08"PRIX32" instead of %08"PRIX32,
+                 crc, GetUint32(recordPtr));
+        return LE_FORMAT_ERROR;
+    }
+
+    *startTimePtr = GPS_EPOCH_TIME + (uint64_t)GetUint16(&dataPtr[8]) * GPS_WEEK_SECONDS
+                    + timeOfWeek - GPS_LEAP_SECONDS;
+    *stopTimePtr = *startTimePtr + (uint64_t)validity * 3600;
+    *recordCountPtr = recordCount;
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse an extended ephemeris file, mapped in memory, and check its integrity in a single pass.
+ *
+ * @return LE_FAULT         The file can't be mapped.
+ * @return LE_FORMAT_ERROR  The file is truncated, has an invalid header or record, or a wrong CRC.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_xtraSimu_Parse
+(
+    int       fd,               ///< [IN] File descriptor
+    uint64_t* startTimePtr,     ///< [OUT] Start of the validity in seconds since Jan. 1, 1970
+    uint64_t* stopTimePtr,      ///< [OUT] End of the validity in seconds since Jan. 1, 1970
+    uint32_t* recordCountPtr    ///< [OUT] Number of satellite records
+)
+{
+    struct stat fileStat;
+    void*       mappingPtr;
+    le_result_t result;
+
+    if (!CrcTableReady)
+    {
+        InitCrcTable();
+    }
+
+    if (0 != fstat(fd, &fileStat))
+    {
+        LE_ERROR("Failed to get the extended ephemeris file size: %m");
+        return LE_FAULT;
+    }
+    if (!S_ISREG(fileStat.st_mode))
+    {
+        LE_ERROR("The extended ephemeris file is not a regular file");
+        return LE_FAULT;
+    }
+    if ((size_t)fileStat.st_size < HEADER_SIZE + CRC_SIZE)
+    {
+        LE_ERROR("Extended ephemeris file of %lld bytes", (long long)fileStat.st_size);
+        return LE_FORMAT_ERROR;
+    }
+
+    mappingPtr = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == mappingPtr)
+    {
+        LE_ERROR("Failed to map the extended ephemeris file: %m");
+        return LE_FAULT;
+    }
+    // The pass is sequential: read ahead aggressively.
+    posix_madvise(mappingPtr, (size_t)fileStat.st_size, POSIX_MADV_SEQUENTIAL);
+
+    result = ParseMapping(mappingPtr, (size_t)fileStat.st_size,
+                          startTimePtr, stopTimePtr, recordCountPtr);
+
+    munmap(mappingPtr, (size_t)fileStat.st_size);
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write an extended ephemeris file with GPS and GLONASS satellite records, to load test the
+ * ephemeris injection.
+ *
+ * @return LE_BAD_PARAMETER The validity doesn't start after the GPS epoch, or is null.
+ * @return LE_FAULT         The file can't be written.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_xtraSimu_WriteFile
+(
+    int      fd,            ///< [IN] File descriptor
+    uint64_t startTime,     ///< [IN] Start of the validity in seconds since Jan. 1, 1970
+    uint16_t validity,      ///< [IN] Validity duration in hours
+    uint16_t recordCount    ///< [IN] Number of satellite records
+)
+{
+    uint8_t  buffer[WRITE_RECORD_COUNT * RECORD_SIZE];
+    uint64_t gpsTime;
+    uint32_t crc;
+    uint32_t i;
+
+    if ((startTime + GPS_LEAP_SECONDS < GPS_EPOCH_TIME) || (0 == validity) || (0 == recordCount))
+    {
+        LE_ERROR("Invalid extended ephemeris file: start %"PRIu64" s, validity %d h, %d records",
+                 startTime, validity, recordCount);
+        return LE_BAD_PARAMETER;
+    }
+    if (!CrcTableReady)
+    {
+        InitCrcTable();
+    }
+
+    gpsTime = startTime + GPS_LEAP_SECONDS - GPS_EPOCH_TIME;
+    if (gpsTime / GPS_WEEK_SECONDS > UINT16_MAX)
+    {
+        LE_ERROR("Extended ephemeris validity start %"PRIu64" s out of range", startTime);
+        return LE_BAD_PARAMETER;
+    }
+
+    memset(buffer, 0, HEADER_SIZE);
+    memcpy(buffer, XTRA_MAGIC, 4);
+    buffer[4] = XTRA_VERSION;
+    PutUint16(&buffer[6], recordCount);
+    PutUint16(&buffer[8], (uint16_t)(gpsTime / GPS_WEEK_SECONDS));
+    PutUint32(&buffer[10], (uint32_t)(gpsTime % GPS_WEEK_SECONDS));
+    PutUint16(&buffer[14], validity);
+    crc = UpdateCrc(0xFFFFFFFF, buffer, HEADER_SIZE);
+    if (LE_OK != WriteAll(fd, buffer, HEADER_SIZE))
+    {
+        return LE_FAULT;
+    }
+
+    // Records of the GPS satellites 1 to 32, then of the GLONASS ones 65 to 88, repeated, with
+    // orbit data derived from the record index.
+    for (i = 0; i < recordCount; )
+    {
+        uint8_t* recordPtr = buffer;
+        size_t   size = 0;
+
+        for (; (i < recordCount) && (size < sizeof(buffer)); i++, recordPtr += RECORD_SIZE)
+        {
+            uint32_t slot = i % 56;
+            uint32_t data = i * 2654435761U;
+            int      j;
+
+            PutUint16(recordPtr, (uint16_t)((slot < 32) ? (slot + 1) : (slot - 32 + 65)));
+            recordPtr[2] = (slot < 32) ? LE_GNSS_SV_CONSTELLATION_GPS
+                                       : LE_GNSS_SV_CONSTELLATION_GLONASS;
+            recordPtr[3] = 0;
+            for (j = 0; j < ORBIT_DATA_SIZE; j++)
+            {
+                data = data * 1664525 + 1013904223;
+                recordPtr[4 + j] = (uint8_t)(data >> 24);
+            }
+            size += RECORD_SIZE;
+        }
+
+        crc = UpdateCrc(crc, buffer, size);
+        if (LE_OK != WriteAll(fd, buffer, size))
+        {
+            return LE_FAULT;
+        }
+    }
+
+    PutUint32(buffer, ~crc);
+    return WriteAll(fd, buffer, CRC_SIZE);
+}
@@ -0,0 +1,61 @@
+/** @file pa_xtra_simu.h
+ *
+ * Legato @ref pa_xtra_simu include file.
+ *
+ * Extended ephemeris files of the simulated GNSS receiver. All fields are big endian:
+ *
+ * | Offset | Size | Field                                               |
+ * |--------|------|-----------------------------------------------------|
+ * | 0      | 4    | Magic "XTRA"                                        |
+ * | 4      | 1    | Version: 1                                          |
+ * | 5      | 1    | Reserved                                            |
+ * | 6      | 2    | Number of satellite records                         |
+ * | 8      | 2    | GPS week of the validity start                      |
+ * | 10     | 4    | GPS time of week of the validity start, in seconds  |
+ * | 14     | 2    | Validity duration, in hours                         |
+ * | 16     | 72   | Satellite records: identifier (2), constellation    |
+ * |        |      | (1), reserved (1) and orbit data (68)               |
+ * | ...    | 4    | CRC-32 of the header and the records                |
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef PA_XTRA_SIMU_H_INCLUDE_GUARD
+#define PA_XTRA_SIMU_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse an extended ephemeris file, mapped in memory, and check its integrity in a single pass.
+ *
+ * @return LE_FAULT         The file can't be mapped.
+ * @return LE_FORMAT_ERROR  The file is truncated, has an invalid header or record, or a wrong CRC.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_xtraSimu_Parse
+(
+    int       fd,               ///< [IN] File descriptor
+    uint64_t* startTimePtr,     ///< [OUT] Start of the validity in seconds since Jan. 1, 1970
+    uint64_t* stopTimePtr,      ///< [OUT] End of the validity in seconds since Jan. 1, 1970
+    uint32_t* recordCountPtr    ///< [OUT] Number of satellite records
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write an extended ephemeris file with GPS and GLONASS satellite records, to load test the
+ * ephemeris injection.
+ *
+ * @return LE_BAD_PARAMETER The validity doesn't start after the GPS epoch, or is null.
+ * @return LE_FAULT         The file can't be written.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_xtraSimu_WriteFile
+(
+    int      fd,            ///< [IN] File descriptor
+    uint64_t startTime,     ///< [IN] Start of the validity in seconds since Jan. 1, 1970
+    uint16_t validity,      ///< [IN] Validity duration in hours
+    uint16_t recordCount    ///< [IN] Number of satellite records
+);
+
+#endif